@@ -1,6 +1,13 @@
 #include "File.h"
+#include "CpuProfiler.h"
 #include "Material.h"
+#include "TextureCooker.h"
+#include "TextureCache.h"
+#include "StreamedTexture.h"
+#include "MeshOptimizer.h"
+#include "VertexQuantizer.h"
 #include <functional>
+#include <algorithm>
 #include <assimp/postprocess.h>
 #include <assimp/Importer.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
@@ -11,30 +18,44 @@
 
 // public:
 
-AssimpModel::AssimpModel(Device *device, const std::string &path, uint32_t count) :
-	Model(device, count)
+AssimpModel::Source::~Source()
 {
-	directory = File::getDirectory(path);
+	delete cache;
 
-	Assimp::Importer importer;
-	const aiScene *aiScene = importer.ReadFile(
-		File::getAbsolute(path),
-		aiProcess_Triangulate | 
-		aiProcess_GenNormals |
-		aiProcess_FlipUVs);
+	for (const auto &[path, pixels] : textures)
+	{
+		TextureImage::freePixels(pixels);
+	}
 
-	importer.ApplyPostProcessing(aiProcess_CalcTangentSpace);
+	for (const auto &[path, file] : cookedTextures)
+	{
+		delete file;
+	}
+}
 
-	assert(aiScene);
+AssimpModel::AssimpModel(Device *device, const std::string &path, uint32_t count) :
+	Model(device, count)
+{
+	const Source *source = loadSource(
+		path,
+		device->isTextureCompressionBcSupported(),
+		device->getTextureCache(),
+		nullptr);
+	loadMeshes(source);
+	delete source;
+}
 
-	processNode(aiScene->mRootNode, aiScene);
+AssimpModel::AssimpModel(Device *device, const Source *source, uint32_t count) :
+	Model(device, count)
+{
+	loadMeshes(source);
 }
 
 AssimpModel::~AssimpModel()
 {
 	for (const auto &[name, texture] : textures)
 	{
-		delete texture;
+		device->getTextureCache()->release(texture);
 	}
 }
 
@@ -43,52 +64,137 @@ glm::vec3 AssimpModel::getBaseSize() const
 	return maxPos - minPos;
 }
 
+AssimpModel::Source* AssimpModel::loadSource(
+	const std::string &path,
+	bool compressedTextures,
+	const TextureCache *textureCache,
+	JobPool *jobPool)
+{
+	const CpuProfiler::Scope profilerScope("AssimpModel::loadSource");
+
+	auto source = new Source();
+	source->directory = File::getDirectory(path);
+
+	const bool optimizeMeshes = MeshOptimizer::isEnabled();
+
+	auto cache = new MeshCache(path, optimizeMeshes);
+	if (cache->isValid())
+	{
+		source->cache = cache;
+		source->materials = cache->getMaterials();
+		source->meshes = cache->getMeshes();
+	}
+	else
+	{
+		delete cache;
+		cook(path, optimizeMeshes, source);
+	}
+
+	loadTextures(source, compressedTextures, textureCache, jobPool);
+
+	return source;
+}
+
 // protected:
 
-VkVertexInputBindingDescription AssimpModel::getVertexBindingDescription(uint32_t binding)
+std::vector<VkVertexInputBindingDescription> AssimpModel::getVertexBindingDescriptions(uint32_t attributeCount)
 {
-	return Vertex::getBindingDescription(binding);
+	return PackedVertex::getBindingDescriptions(attributeCount);
 }
 
-std::vector<VkVertexInputAttributeDescription> AssimpModel::getVertexAttributeDescriptions(
-    uint32_t binding,
-    uint32_t locationOffset)
+std::vector<VkVertexInputAttributeDescription> AssimpModel::getVertexAttributeDescriptions(uint32_t attributeCount)
 {
-	return Vertex::getAttributeDescriptions(binding, locationOffset);
+	return PackedVertex::getAttributeDescriptions(attributeCount);
 }
 
 // private:
 
-void AssimpModel::processNode(aiNode *aiNode, const aiScene *aiScene)
+void AssimpModel::cook(const std::string &path, bool optimizeMeshes, Source *source)
+{
+	Assimp::Importer importer;
+	const aiScene *aiScene = importer.ReadFile(
+		File::getAbsolute(path),
+		aiProcess_Triangulate | 
+		aiProcess_GenNormals |
+		aiProcess_FlipUVs);
+
+	importer.ApplyPostProcessing(aiProcess_CalcTangentSpace);
+
+	assert(aiScene);
+
+	std::map<uint32_t, MeshCache::MaterialData> materialsData;
+	processNode(aiScene->mRootNode, aiScene, source->cookedMeshes, materialsData);
+
+	for (const auto &[index, materialData] : materialsData)
+	{
+		source->materials.push_back(materialData);
+	}
+
+	for (auto &mesh : source->cookedMeshes)
+	{
+		if (optimizeMeshes)
+		{
+			MeshOptimizer::optimize(mesh.vertices, mesh.indices);
+		}
+
+		mesh.packedStreams = PackedVertex::split(VertexQuantizer::quantize(mesh.vertices, mesh.bounds));
+		mesh.vertices.clear();
+	}
+
+	for (const auto &mesh : source->cookedMeshes)
+	{
+		source->meshes.push_back({
+			mesh.materialIndex,
+			mesh.packedStreams.positions.data(),
+			mesh.packedStreams.attributes.data(),
+			uint32_t(mesh.packedStreams.positions.size()),
+			mesh.indices.data(),
+			uint32_t(mesh.indices.size()),
+			mesh.bounds
+		});
+	}
+
+	// model is loaded even if cache can't be written (it will be cooked again next time)
+	MeshCache::save(path, optimizeMeshes, source->materials, source->meshes);
+}
+
+void AssimpModel::processNode(
+	aiNode *aiNode,
+	const aiScene *aiScene,
+	std::vector<CookedMesh> &meshes,
+	std::map<uint32_t, MeshCache::MaterialData> &materialsData)
 {
+	const CpuProfiler::Scope profilerScope("AssimpModel::processNode");
+
 	for (unsigned int i = 0; i < aiNode->mNumMeshes; i++)
 	{
 		aiMesh *aiMesh = aiScene->mMeshes[aiNode->mMeshes[i]];
 
-		MeshBase *mesh = processMesh(aiMesh, aiScene);
+		meshes.push_back(processMesh(aiMesh));
 
-		if (mesh->getMaterial()->solid())
+		const uint32_t materialIndex = aiMesh->mMaterialIndex;
+		if (materialsData.find(materialIndex) == materialsData.end())
 		{
-			solidMeshes.push_back(mesh);
-		}
-		else
-		{
-			transparentMeshes.push_back(mesh);
+			materialsData.insert({ materialIndex, getMaterialData(materialIndex, aiScene->mMaterials[materialIndex]) });
 		}
 	}
 
 	for (unsigned int i = 0; i < aiNode->mNumChildren; i++)
 	{
-		processNode(aiNode->mChildren[i], aiScene);
+		processNode(aiNode->mChildren[i], aiScene, meshes, materialsData);
 	}
 }
 
-Mesh<Vertex>* AssimpModel::processMesh(aiMesh *aiMesh, const aiScene *aiScene)
+AssimpModel::CookedMesh AssimpModel::processMesh(aiMesh *aiMesh)
 {
 	std::vector<Vertex> vertices;
 	std::vector<uint32_t> indices;
 
+	glm::vec3 meshMinPos(std::numeric_limits<float>::max());
+	glm::vec3 meshMaxPos(-std::numeric_limits<float>::max());
+
 	bool needInitTangents = false;
+	uint32_t mirroredCount = 0;
 
 	for (unsigned int i = 0; i < aiMesh->mNumVertices; i++)
 	{
@@ -99,7 +205,8 @@ Mesh<Vertex>* AssimpModel::processMesh(aiMesh *aiMesh, const aiScene *aiScene)
 			aiMesh->mVertices[i].y,
 			aiMesh->mVertices[i].z);
 
-		initPosLimits(vertex.pos);
+		meshMinPos = glm::min(meshMinPos, vertex.pos);
+		meshMaxPos = glm::max(meshMaxPos, vertex.pos);
 
 		vertex.normal = glm::vec3(
 			aiMesh->mNormals[i].x,
@@ -112,6 +219,20 @@ Mesh<Vertex>* AssimpModel::processMesh(aiMesh *aiMesh, const aiScene *aiScene)
 				aiMesh->mTangents[i].x,
 				aiMesh->mTangents[i].y,
 				aiMesh->mTangents[i].z);
+
+			if (aiMesh->mBitangents)
+			{
+				const glm::vec3 bitangent(
+					aiMesh->mBitangents[i].x,
+					aiMesh->mBitangents[i].y,
+					aiMesh->mBitangents[i].z);
+
+				if (glm::dot(glm::cross(vertex.tangent, vertex.normal), bitangent) < 0.0f)
+				{
+					vertex.bitangentSign = -1.0f;
+					mirroredCount++;
+				}
+			}
 		}
 		else
 		{
@@ -146,41 +267,20 @@ Mesh<Vertex>* AssimpModel::processMesh(aiMesh *aiMesh, const aiScene *aiScene)
 		initTangents(vertices, indices);
 	}
 
-	Material *material = getMeshMaterial(aiMesh->mMaterialIndex, aiScene->mMaterials);
-
-	return new Mesh<Vertex>(device, vertices, indices, material);
-}
-
-void AssimpModel::initPosLimits(glm::vec3 pos)
-{
-	if (pos.x > maxPos.x)
+	// shaders take cross(tangent, normal) as bitangent, so sign of most vertices is kept positive
+	// (it depends on handedness of normal maps) and only mirrored parts of mesh are negative
+	if (mirroredCount > aiMesh->mNumVertices / 2)
 	{
-		maxPos.x = pos.x;
-	}
-	if (pos.y > maxPos.y)
-	{
-		maxPos.y = pos.y;
-	}
-	if (pos.z > maxPos.z)
-	{
-		maxPos.z = pos.z;
+		for (auto &vertex : vertices)
+		{
+			vertex.bitangentSign = -vertex.bitangentSign;
+		}
 	}
 
-	if (pos.x < minPos.x)
-	{
-		minPos.x = pos.x;
-	}
-	if (pos.y < minPos.y)
-	{
-		minPos.y = pos.y;
-	}
-	if (pos.z < minPos.z)
-	{
-		minPos.z = pos.z;
-	}
+	return { aiMesh->mMaterialIndex, vertices, indices, BoundingVolume(meshMinPos, meshMaxPos) };
 }
 
-void AssimpModel::initTangents(std::vector<Vertex> &vertices, std::vector<uint32_t> indices) const
+void AssimpModel::initTangents(std::vector<Vertex> &vertices, std::vector<uint32_t> indices)
 {
 	for (unsigned int i = 0; i < indices.size(); i = i + 3) 
 	{
@@ -218,46 +318,33 @@ void AssimpModel::initTangents(std::vector<Vertex> &vertices, std::vector<uint32
     }
 }
 
-Material* AssimpModel::getMeshMaterial(uint32_t index, aiMaterial *aiMaterials[])
+MeshCache::MaterialData AssimpModel::getMaterialData(uint32_t index, aiMaterial *aiMaterial)
 {
-    auto material = new Material(device);
-
-	if (materials.find(index) == materials.end())
-	{
-        const auto aiMaterial = aiMaterials[index];
+	MeshCache::MaterialData materialData{};
+	materialData.index = index;
 
-        // load material colors
-		Material::Colors materialColors{};
-		materialColors.diffuseColor = getMaterialColor(aiMaterial, "$clr.diffuse");
-		materialColors.specularColor = getMaterialColor(aiMaterial, "$clr.specular");
-		aiGetMaterialFloat(aiMaterial, AI_MATKEY_OPACITY, &materialColors.opacity);
-		material->setColors(materialColors);
-
-		for (auto type : Material::TEXTURES_ORDER)
-		{
-            if (type == aiTextureType_NORMALS)
-            {
-				if (aiMaterial->GetTextureCount(aiTextureType_HEIGHT))
-				{
-					material->addTexture(aiTextureType_NORMALS, loadMaterialTexture(aiMaterial, aiTextureType_HEIGHT));
-				}
-            }
+	// load material colors
+	materialData.colors.diffuseColor = getMaterialColor(aiMaterial, "$clr.diffuse");
+	materialData.colors.specularColor = getMaterialColor(aiMaterial, "$clr.specular");
+	aiGetMaterialFloat(aiMaterial, AI_MATKEY_OPACITY, &materialData.colors.opacity);
 
-			if (aiMaterial->GetTextureCount(type))
+	for (auto type : Material::TEXTURES_ORDER)
+	{
+        if (type == aiTextureType_NORMALS)
+        {
+			if (aiMaterial->GetTextureCount(aiTextureType_HEIGHT))
 			{
-				material->addTexture(type, loadMaterialTexture(aiMaterial, type));
+				materialData.textures.emplace_back(aiTextureType_NORMALS, getTexturePath(aiMaterial, aiTextureType_HEIGHT));
 			}
-		}
+        }
 
-		materials.insert({ index, material });
-	}
-	else
-	{
-		delete material;
-		material = materials[index];
+		if (aiMaterial->GetTextureCount(type))
+		{
+			materialData.textures.emplace_back(type, getTexturePath(aiMaterial, type));
+		}
 	}
 
-	return material;
+	return materialData;
 }
 
 glm::vec4 AssimpModel::getMaterialColor(aiMaterial *aiMaterial, const char *key)
@@ -270,31 +357,194 @@ glm::vec4 AssimpModel::getMaterialColor(aiMaterial *aiMaterial, const char *key)
 	return glm::vec4(color.r, color.g, color.b, color.a);
 }
 
-TextureImage* AssimpModel::loadMaterialTexture(aiMaterial *aiMaterial, aiTextureType type)
+std::string AssimpModel::getTexturePath(aiMaterial *aiMaterial, aiTextureType type)
 {
 	aiString aiPath;
-	assert(aiMaterial->GetTexture(type, 0, &aiPath) == aiReturn_SUCCESS);
-	std::string path(aiPath.C_Str());
+	const aiReturn result = aiMaterial->GetTexture(type, 0, &aiPath);
+	assert(result == aiReturn_SUCCESS);
+
+	return std::string(aiPath.C_Str());
+}
 
-	TextureImage *texture;
-	if (textures.find(path) == textures.end())
+void AssimpModel::loadTextures(
+	Source *source,
+	bool compressedTextures,
+	const TextureCache *textureCache,
+	JobPool *jobPool)
+{
+	// texture is created with sampler of its first usage
+	std::vector<std::pair<std::string, aiTextureType>> paths;
+	for (const auto &materialData : source->materials)
 	{
-        const VkFilter filter = type != aiTextureType_OPACITY ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+		for (const auto &[type, path] : materialData.textures)
+		{
+			if (source->textures.find(path) == source->textures.end())
+			{
+				source->textures.insert({ path, {} });
+				source->cookedTextures.insert({ path, nullptr });
+				paths.emplace_back(path, type);
+			}
+		}
+	}
 
-		texture = new TextureImage(
-			device, 
-			{ File::getPath(directory, path) }, 
-			1, 
-			false, 
-			filter,
-			VK_SAMPLER_ADDRESS_MODE_REPEAT);
+	// each job writes its own texture (maps aren't changed while jobs are running)
+	const auto loadTexture = [source, compressedTextures, textureCache, &paths](uint32_t index)
+	{
+		const auto &[relativePath, type] = paths[index];
+
+		// cached texture is taken from cache when model is created
+		if (textureCache && textureCache->contains(getTextureKey(source->directory, relativePath, type)))
+		{
+			return;
+		}
+
+		const std::string path = File::getPath(source->directory, relativePath);
+
+		if (compressedTextures && TextureCooker::isCooked(path))
+		{
+			auto file = new KtxFile(TextureCooker::getCookedPath(path));
+			if (file->isValid())
+			{
+				source->cookedTextures.at(relativePath) = file;
+				return;
+			}
+			delete file;
+		}
 
-		textures.insert({ path, texture });
+		source->textures.at(relativePath) = TextureImage::loadPixels(path);
+	};
+
+	if (jobPool)
+	{
+		jobPool->parallelFor(uint32_t(paths.size()), loadTexture);
 	}
 	else
 	{
-		texture = textures[path];
+		for (uint32_t i = 0; i < paths.size(); i++)
+		{
+			loadTexture(i);
+		}
 	}
+}
+
+void AssimpModel::loadMeshes(const Source *source)
+{
+	for (const auto &[path, pixels] : source->textures)
+	{
+		textures.insert({ path, nullptr });
+	}
+
+	for (const auto &materialData : source->materials)
+	{
+		auto material = new Material(device);
+		material->setColors(materialData.colors);
 
-	return texture;
+		for (const auto &[type, path] : materialData.textures)
+		{
+			TextureImage *&texture = textures.at(path);
+			if (!texture)
+			{
+				// structured bindings can't be captured
+				const std::string &texturePath = path;
+				const aiTextureType textureType = type;
+
+				texture = device->getTextureCache()->acquire(
+					getTextureKey(source->directory, texturePath, textureType),
+					[this, source, &texturePath, textureType]()
+					{
+						return createTexture(source, texturePath, textureType);
+					});
+			}
+
+			material->addTexture(type, texture);
+		}
+
+		materials.insert({ materialData.index, material });
+	}
+
+	uint32_t vertexCount = 0;
+	uint32_t indexCount = 0;
+	uint32_t maxMeshVertexCount = 0;
+	for (const auto &meshData : source->meshes)
+	{
+		vertexCount += meshData.vertexCount;
+		indexCount += meshData.indexCount;
+		maxMeshVertexCount = std::max(maxMeshVertexCount, meshData.vertexCount);
+	}
+
+	geometryArena = new GeometryArena(device, PackedVertex::getStreamStrides(), vertexCount, indexCount, maxMeshVertexCount);
+
+	for (const auto &meshData : source->meshes)
+	{
+		MeshBase *mesh = new PackedMesh(
+			geometryArena,
+			meshData.positions,
+			meshData.attributes,
+			meshData.vertexCount,
+			meshData.indices,
+			meshData.indexCount,
+			materials.at(meshData.materialIndex),
+			meshData.bounds);
+
+		if (mesh->getMaterial()->solid())
+		{
+			solidMeshes.push_back(mesh);
+		}
+		else
+		{
+			transparentMeshes.push_back(mesh);
+		}
+
+		minPos = glm::min(minPos, meshData.bounds.getMin());
+		maxPos = glm::max(maxPos, meshData.bounds.getMax());
+	}
+}
+
+TextureImage* AssimpModel::createTexture(const Source *source, const std::string &path, aiTextureType type) const
+{
+	const VkFilter filter = getTextureFilter(type);
+
+	const KtxFile *cookedTexture = source->cookedTextures.at(path);
+	if (cookedTexture && device->getTextureStreamer())
+	{
+		// streamed texture maps its own file, because it exists longer than source
+		return new StreamedTexture(
+			device,
+			TextureCooker::getCookedPath(File::getPath(source->directory, path)),
+			filter,
+			VK_SAMPLER_ADDRESS_MODE_REPEAT);
+	}
+	if (cookedTexture)
+	{
+		return new TextureImage(device, *cookedTexture, filter, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+	}
+
+	const TextureImage::Pixels &pixels = source->textures.at(path);
+	if (pixels.data)
+	{
+		return new TextureImage(device, { pixels }, false, filter, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+	}
+
+	// texture was cached while source was loaded, but it has been released since then
+	return new TextureImage(
+		device,
+		{ File::getPath(source->directory, path) },
+		1,
+		false,
+		filter,
+		VK_SAMPLER_ADDRESS_MODE_REPEAT);
+}
+
+VkFilter AssimpModel::getTextureFilter(aiTextureType type)
+{
+	return type != aiTextureType_OPACITY ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+}
+
+TextureCache::Key AssimpModel::getTextureKey(const std::string &directory, const std::string &path, aiTextureType type)
+{
+	return TextureCache::getKey(
+		{ File::getPath(directory, path) },
+		false,
+		getTextureFilter(type),
+		VK_SAMPLER_ADDRESS_MODE_REPEAT);
 }
@@ -1,48 +1,121 @@
 #pragma once
 
 #include <assimp/scene.h>
-#include "Mesh.h"
+#include "PackedMesh.h"
 #include <vector>
 #include <map>
 #include "Model.h"
+#include "MeshCache.h"
+#include "JobPool.h"
+#include "TextureCache.h"
 
 class AssimpModel : public Model
 {
 public:
+	// mesh imported by assimp which is written to mesh cache
+	struct CookedMesh
+	{
+		uint32_t materialIndex;
+
+		std::vector<Vertex> vertices;
+
+		std::vector<uint32_t> indices;
+
+		BoundingVolume bounds;
+
+		// vertices quantized in mesh bounds
+		PackedVertex::Streams packedStreams;
+	};
+
+	// data of model loaded from source file (or its mesh cache) and decoded textures,
+	// it is loaded without device, so sources of several models can be loaded by jobs in parallel
+	struct Source
+	{
+		std::string directory;
+
+		// mapped cache which contains meshes data (null if source was imported by assimp)
+		MeshCache *cache = nullptr;
+
+		// meshes imported by assimp which contain meshes data
+		std::vector<CookedMesh> cookedMeshes;
+
+		std::vector<MeshCache::MaterialData> materials;
+
+		std::vector<MeshCache::MeshData> meshes;
+
+		// pixels of textures of all materials by path relative to model directory
+		// (pixels are null if texture is loaded from cooked file)
+		std::map<std::string, TextureImage::Pixels> textures;
+
+		// mapped KTX2 files of cooked textures (null if texture isn't cooked)
+		std::map<std::string, KtxFile*> cookedTextures;
+
+		~Source();
+	};
+
 	AssimpModel(Device *device, const std::string &path, uint32_t count);
 
+	// creates model from loaded source (all uploads are done here)
+	AssimpModel(Device *device, const Source *source, uint32_t count);
+
 	~AssimpModel();
 
 	glm::vec3 getBaseSize() const;
 
+	// if job pool isn't null textures are decoded by its jobs,
+	// cooked textures are used if compressed textures are allowed,
+	// textures which are already in texture cache (if it isn't null) aren't loaded
+	static Source* loadSource(
+		const std::string &path,
+		bool compressedTextures,
+		const TextureCache *textureCache,
+		JobPool *jobPool);
+
 protected:
-	VkVertexInputBindingDescription  getVertexBindingDescription(uint32_t binding) override;
+	std::vector<VkVertexInputBindingDescription> getVertexBindingDescriptions(uint32_t attributeCount) override;
 
-	std::vector<VkVertexInputAttributeDescription> getVertexAttributeDescriptions(
-        uint32_t binding,
-        uint32_t locationOffset) override;
+	std::vector<VkVertexInputAttributeDescription> getVertexAttributeDescriptions(uint32_t attributeCount) override;
 
 private:
-	std::string directory;
-
 	std::map<std::string, TextureImage*> textures;
 
 	glm::vec3 minPos = glm::vec3(std::numeric_limits<float>::infinity());
 
 	glm::vec3 maxPos = glm::vec3(-std::numeric_limits<float>::infinity());
 
-	void processNode(aiNode *aiNode, const aiScene *aiScene);
+	// imports source file by assimp, optimizes its meshes if it's required and writes its mesh cache
+	static void cook(const std::string &path, bool optimizeMeshes, Source *source);
 
-	Mesh<Vertex>* processMesh(aiMesh *aiMesh, const aiScene *aiScene);
+	static void processNode(
+		aiNode *aiNode,
+		const aiScene *aiScene,
+		std::vector<CookedMesh> &meshes,
+		std::map<uint32_t, MeshCache::MaterialData> &materialsData);
 
-	void initPosLimits(glm::vec3 pos);
+	static CookedMesh processMesh(aiMesh *aiMesh);
 
-	void initTangents(std::vector<Vertex> &vertices, std::vector<uint32_t> indices) const;
+	static void initTangents(std::vector<Vertex> &vertices, std::vector<uint32_t> indices);
 
-	Material* getMeshMaterial(uint32_t index, aiMaterial *aiMaterials[]);
+	static MeshCache::MaterialData getMaterialData(uint32_t index, aiMaterial *aiMaterial);
 
     static glm::vec4 getMaterialColor(aiMaterial *aiMaterial, const char *key);
 
-	TextureImage* loadMaterialTexture(aiMaterial *aiMaterial, aiTextureType type);
+	static std::string getTexturePath(aiMaterial *aiMaterial, aiTextureType type);
+
+	static void loadTextures(
+		Source *source,
+		bool compressedTextures,
+		const TextureCache *textureCache,
+		JobPool *jobPool);
+
+	// creates materials, textures and meshes, vertices and indices are uploaded directly from source
+	void loadMeshes(const Source *source);
+
+	// texture is created from cooked file or pixels of source or loaded from file if source doesn't contain it
+	TextureImage* createTexture(const Source *source, const std::string &path, aiTextureType type) const;
+
+	static VkFilter getTextureFilter(aiTextureType type);
+
+	static TextureCache::Key getTextureKey(const std::string &directory, const std::string &path, aiTextureType type);
 };
 
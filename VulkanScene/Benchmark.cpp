@@ -0,0 +1,278 @@
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include "File.h"
+
+#include "Benchmark.h"
+
+// public:
+
+Benchmark::Benchmark(Settings settings, VkExtent2D extent, const std::string &cameraPathFile)
+	: settings(settings), extent(extent), cameraPath(cameraPathFile)
+{
+}
+
+void Benchmark::setResizeStorm(bool resizeStorm)
+{
+	this->resizeStorm = resizeStorm;
+}
+
+void Benchmark::run(const std::string &reportPath)
+{
+	Engine engine(extent, TARGET_IMAGE_COUNT, settings);
+	startupStatistics = engine.getStartupStatistics();
+	startupWaitIdleCount = engine.getWaitIdleCount();
+	engine.enableGpuProfiler(false, "");
+
+	for (uint32_t i = 0; i < WARM_UP_FRAME_COUNT; i++)
+	{
+		renderFrame(engine, i, 0.0f);
+	}
+
+	records.clear();
+
+	const auto frameCount = uint32_t(cameraPath.getDuration() / cameraPath.getTimeStep()) + 1;
+	for (uint32_t i = 0; i < frameCount; i++)
+	{
+		records.push_back(renderFrame(engine, i, i * cameraPath.getTimeStep()));
+		saveGpuTimes(engine.getGpuProfiler());
+	}
+
+	engine.waitIdle();
+	saveGpuTimes(engine.getGpuProfiler());
+
+	if (std::filesystem::path(reportPath).extension() == ".json")
+	{
+		saveJson(reportPath);
+	}
+	else
+	{
+		saveCsv(reportPath);
+	}
+
+	std::cout << "Benchmark summary: " << getSummary().dump(4) << std::endl;
+}
+
+nlohmann::json Benchmark::getSummary() const
+{
+	std::vector<double> cpuTimes;
+	std::vector<double> frameTimes;
+	std::vector<double> resizeTimes;
+	std::map<RenderPassType, std::vector<double>> gpuTimes;
+	uint64_t waitIdleCount = 0;
+	for (const auto &record : records)
+	{
+		waitIdleCount += record.waitIdleCount;
+		cpuTimes.push_back(record.cpuTime);
+		frameTimes.push_back(record.frameTime);
+		resizeTimes.push_back(record.resizeTime);
+		for (const auto &[type, gpuTime] : record.gpuTimes)
+		{
+			gpuTimes[type].push_back(gpuTime);
+		}
+	}
+
+	nlohmann::json summary;
+	summary["startup"] = {
+		{ "startupTime", startupStatistics.startupTime },
+		{ "modelsLoadingTime", startupStatistics.modelsLoadingTime },
+		{ "preparingTime", startupStatistics.preparingTime },
+		{ "pipelineCache", startupStatistics.pipelineCacheLoaded ? "warm" : "cold" },
+		{ "textureMemory", startupStatistics.textureMemory },
+		{ "textureCacheHits", startupStatistics.textureCacheHits },
+		{ "textureCacheMisses", startupStatistics.textureCacheMisses },
+		{ "textureCacheSavedBytes", startupStatistics.textureCacheSavedBytes },
+		{ "streamedTextureCount", startupStatistics.streamedTextureCount },
+		{ "memoryBlockCount", startupStatistics.memory.blockCount },
+		{ "reservedMemory", startupStatistics.memory.blockBytes },
+		{ "usedMemory", startupStatistics.memory.usedBytes },
+		{ "staticBufferSize", startupStatistics.staticBufferSize }
+	};
+	summary["frameCount"] = records.size();
+
+	// count of measured frames shouldn't change count of wait idles (without resize storm)
+	summary["waitIdles"] = {
+		{ "startup", startupWaitIdleCount },
+		{ "frames", waitIdleCount },
+		{ "perFrame", records.empty() ? 0.0 : double(waitIdleCount) / double(records.size()) }
+	};
+
+	std::vector<std::pair<std::string, std::vector<double>>> columns{
+		{ "cpuTime", cpuTimes },
+		{ "frameTime", frameTimes },
+		{ "resizeTime", resizeTimes }
+	};
+	for (const auto &[type, values] : gpuTimes)
+	{
+		columns.emplace_back("gpu" + GpuProfiler::getPassName(type), values);
+	}
+
+	for (const auto &[name, values] : columns)
+	{
+		summary[name] = {
+			{ "p50", getPercentile(values, 0.5) },
+			{ "p95", getPercentile(values, 0.95) },
+			{ "p99", getPercentile(values, 0.99) }
+		};
+	}
+
+	return summary;
+}
+
+// private:
+
+Benchmark::FrameRecord Benchmark::renderFrame(Engine &engine, uint32_t index, float time) const
+{
+	using milliseconds = std::chrono::duration<double, std::milli>;
+
+	const uint64_t startWaitIdleCount = engine.getWaitIdleCount();
+
+	double resizeTime = 0;
+	if (resizeStorm)
+	{
+		// full and half extent take turns
+		const uint32_t divisor = index % 2 + 1;
+
+		const auto resizeStartTime = std::chrono::steady_clock::now();
+		engine.resize({ extent.width / divisor, extent.height / divisor });
+		resizeTime = milliseconds(std::chrono::steady_clock::now() - resizeStartTime).count();
+	}
+
+	cameraPath.apply(engine.getCamera(), time);
+
+	const uint64_t frameNumber = engine.getFrameNumber();
+
+	const auto frameStartTime = std::chrono::steady_clock::now();
+	engine.drawFrame();
+	const double frameTime = milliseconds(std::chrono::steady_clock::now() - frameStartTime).count();
+
+	const double waitTime = engine.getLastWaitTime();
+	const uint64_t waitIdleCount = engine.getWaitIdleCount() - startWaitIdleCount;
+
+	return {
+		index,
+		time,
+		frameTime - waitTime,
+		waitTime,
+		frameTime,
+		resizeTime,
+		frameNumber,
+		waitIdleCount,
+		engine.getSavedCascadeDraws(),
+		engine.getDrawStatistics()
+	};
+}
+
+void Benchmark::saveGpuTimes(GpuProfiler *gpuProfiler)
+{
+	for (const auto &frameResults : gpuProfiler->takeResults())
+	{
+		const auto record = std::find_if(
+			records.begin(),
+			records.end(),
+			[&](const FrameRecord &r) { return r.frameNumber == frameResults.frameNumber; });
+
+		// results of warm up frames are skipped
+		if (record != records.end())
+		{
+			record->gpuTimes = frameResults.passTimes;
+		}
+	}
+}
+
+void Benchmark::saveCsv(const std::string &path) const
+{
+	std::ofstream stream(File::getAbsolute(path));
+
+	stream << "frame,time,cpuTime,waitTime,frameTime,resizeTime,waitIdles"
+		<< ",draws,pipelineBinds,descriptorSetBinds,geometryBinds";
+	for (uint32_t i = 0; i < PssmKernel::CASCADE_COUNT; i++)
+	{
+		stream << ",savedCascade" << i;
+	}
+	for (auto type : { DEPTH, GEOMETRY, SSAO, SSAO_BLUR, LIGHTING, FINAL })
+	{
+		stream << ",gpu" << GpuProfiler::getPassName(type);
+	}
+	stream << std::endl;
+
+	for (const auto &record : records)
+	{
+		stream << record.index << ","
+			<< record.time << ","
+			<< record.cpuTime << ","
+			<< record.waitTime << ","
+			<< record.frameTime << ","
+			<< record.resizeTime << ","
+			<< record.waitIdleCount << ","
+			<< record.drawStatistics.drawCount << ","
+			<< record.drawStatistics.pipelineBindCount << ","
+			<< record.drawStatistics.descriptorSetBindCount << ","
+			<< record.drawStatistics.geometryBindCount;
+		for (uint32_t i = 0; i < PssmKernel::CASCADE_COUNT; i++)
+		{
+			// values are left empty if culled instances aren't counted on CPU
+			stream << ",";
+			if (i < record.savedCascadeDraws.size())
+			{
+				stream << record.savedCascadeDraws[i];
+			}
+		}
+		for (auto type : { DEPTH, GEOMETRY, SSAO, SSAO_BLUR, LIGHTING, FINAL })
+		{
+			const auto gpuTime = record.gpuTimes.find(type);
+			stream << "," << (gpuTime != record.gpuTimes.end() ? gpuTime->second : 0.0);
+		}
+		stream << std::endl;
+	}
+}
+
+void Benchmark::saveJson(const std::string &path) const
+{
+	nlohmann::json report;
+	report["summary"] = getSummary();
+	report["frames"] = nlohmann::json::array();
+
+	for (const auto &record : records)
+	{
+		nlohmann::json frame{
+			{ "frame", record.index },
+			{ "time", record.time },
+			{ "cpuTime", record.cpuTime },
+			{ "waitTime", record.waitTime },
+			{ "frameTime", record.frameTime },
+			{ "resizeTime", record.resizeTime },
+			{ "waitIdles", record.waitIdleCount },
+			{ "savedCascadeDraws", record.savedCascadeDraws },
+			{ "draws", record.drawStatistics.drawCount },
+			{ "pipelineBinds", record.drawStatistics.pipelineBindCount },
+			{ "descriptorSetBinds", record.drawStatistics.descriptorSetBindCount },
+			{ "geometryBinds", record.drawStatistics.geometryBindCount }
+		};
+		for (const auto &[type, gpuTime] : record.gpuTimes)
+		{
+			frame["gpu" + GpuProfiler::getPassName(type)] = gpuTime;
+		}
+
+		report["frames"].push_back(frame);
+	}
+
+	std::ofstream stream(File::getAbsolute(path));
+	stream << report.dump(4);
+}
+
+double Benchmark::getPercentile(std::vector<double> values, double percentile)
+{
+	if (values.empty())
+	{
+		return 0;
+	}
+
+	// nearest rank
+	const auto index = size_t(percentile * (values.size() - 1) + 0.5);
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+
+	return values[index];
+}
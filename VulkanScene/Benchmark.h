@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <nlohmann/json.hpp>
+#include "Engine.h"
+#include "CameraPath.h"
+#include "Settings.h"
+
+// renders scene offscreen along camera path with fixed time step and reports frame times,
+// frames don't depend on real time, so results of runs can be compared
+class Benchmark
+{
+public:
+	Benchmark(Settings settings, VkExtent2D extent, const std::string &cameraPathFile);
+
+	// frame extent is changed before each frame (to measure resize latency)
+	void setResizeStorm(bool resizeStorm);
+
+	// writes report into .json or .csv file (depends on extension)
+	void run(const std::string &reportPath);
+
+	// startup statistics and percentiles of frame times of last run
+	nlohmann::json getSummary() const;
+
+private:
+	// frames rendered before measurement (pipelines, caches and driver are warmed up)
+	const uint32_t WARM_UP_FRAME_COUNT = 16;
+
+	const uint32_t TARGET_IMAGE_COUNT = 3;
+
+	// milliseconds
+	struct FrameRecord
+	{
+		uint32_t index;
+		float time;
+		double cpuTime;
+		double waitTime;
+		double frameTime;
+		double resizeTime;
+		uint64_t frameNumber;
+
+		// includes wait idles of resize
+		uint64_t waitIdleCount;
+
+		// empty with GPU culling
+		std::vector<uint32_t> savedCascadeDraws;
+
+		DrawList::Statistics drawStatistics;
+
+		// filled when GPU profiler results of this frame are collected
+		std::map<RenderPassType, double> gpuTimes;
+	};
+
+	Settings settings;
+
+	VkExtent2D extent;
+
+	CameraPath cameraPath;
+
+	bool resizeStorm = false;
+
+	std::vector<FrameRecord> records;
+
+	Engine::StartupStatistics startupStatistics{};
+
+	uint64_t startupWaitIdleCount = 0;
+
+	FrameRecord renderFrame(Engine &engine, uint32_t index, float time) const;
+
+	// GPU profiler results are ready several frames later
+	void saveGpuTimes(GpuProfiler *gpuProfiler);
+
+	void saveCsv(const std::string &path) const;
+
+	void saveJson(const std::string &path) const;
+
+	static double getPercentile(std::vector<double> values, double percentile);
+};
+
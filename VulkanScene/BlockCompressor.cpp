@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstdlib>
+
+#include "BlockCompressor.h"
+
+// public:
+
+bool BlockCompressor::supports(VkFormat format)
+{
+	return format == VK_FORMAT_BC1_RGB_UNORM_BLOCK
+		|| format == VK_FORMAT_BC4_UNORM_BLOCK
+		|| format == VK_FORMAT_BC5_UNORM_BLOCK;
+}
+
+std::vector<uint8_t> BlockCompressor::encode(VkFormat format, const uint8_t *pixels, VkExtent2D extent)
+{
+	assert(supports(format));
+
+	const uint32_t blockSize = format == VK_FORMAT_BC5_UNORM_BLOCK ? 16 : 8;
+	const uint32_t blocksX = (extent.width + BLOCK_DIM - 1) / BLOCK_DIM;
+	const uint32_t blocksY = (extent.height + BLOCK_DIM - 1) / BLOCK_DIM;
+
+	std::vector<uint8_t> output(blocksX * blocksY * blockSize);
+
+	Block block;
+	for (uint32_t by = 0; by < blocksY; by++)
+	{
+		for (uint32_t bx = 0; bx < blocksX; bx++)
+		{
+			for (uint32_t i = 0; i < BLOCK_PIXEL_COUNT; i++)
+			{
+				const uint32_t x = std::min(bx * BLOCK_DIM + i % BLOCK_DIM, extent.width - 1);
+				const uint32_t y = std::min(by * BLOCK_DIM + i / BLOCK_DIM, extent.height - 1);
+				std::copy_n(pixels + (y * extent.width + x) * 4, 4, block + i * 4);
+			}
+
+			uint8_t *blockOutput = output.data() + (by * blocksX + bx) * blockSize;
+
+			switch (format)
+			{
+			case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+				encodeBc1(block, blockOutput);
+				break;
+			case VK_FORMAT_BC4_UNORM_BLOCK:
+				encodeBc4(block, 0, blockOutput);
+				break;
+			default:
+				encodeBc4(block, 0, blockOutput);
+				encodeBc4(block, 1, blockOutput + 8);
+				break;
+			}
+		}
+	}
+
+	return output;
+}
+
+// private:
+
+void BlockCompressor::encodeBc1(const Block &block, uint8_t *output)
+{
+	uint8_t minColor[3] = { 255, 255, 255 };
+	uint8_t maxColor[3] = { 0, 0, 0 };
+	for (uint32_t i = 0; i < BLOCK_PIXEL_COUNT; i++)
+	{
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			minColor[c] = std::min(minColor[c], block[i * 4 + c]);
+			maxColor[c] = std::max(maxColor[c], block[i * 4 + c]);
+		}
+	}
+
+	// bounds are inset a little, so endpoints are less affected by outliers
+	for (uint32_t c = 0; c < 3; c++)
+	{
+		const uint8_t inset = (maxColor[c] - minColor[c]) / 16;
+		minColor[c] += inset;
+		maxColor[c] -= inset;
+	}
+
+	uint16_t color0 = toRgb565(maxColor);
+	uint16_t color1 = toRgb565(minColor);
+
+	// first endpoint must be greater for 4 color mode
+	if (color0 < color1)
+	{
+		std::swap(color0, color1);
+	}
+
+	uint8_t palette[4][3];
+	fromRgb565(color0, palette[0]);
+	fromRgb565(color1, palette[1]);
+	for (uint32_t c = 0; c < 3; c++)
+	{
+		palette[2][c] = uint8_t((2 * palette[0][c] + palette[1][c]) / 3);
+		palette[3][c] = uint8_t((palette[0][c] + 2 * palette[1][c]) / 3);
+	}
+
+	uint32_t indices = 0;
+	if (color0 != color1)
+	{
+		for (uint32_t i = 0; i < BLOCK_PIXEL_COUNT; i++)
+		{
+			uint32_t bestIndex = 0;
+			int bestDistance = INT_MAX;
+			for (uint32_t p = 0; p < 4; p++)
+			{
+				int distance = 0;
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					const int difference = int(block[i * 4 + c]) - int(palette[p][c]);
+					distance += difference * difference;
+				}
+
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = p;
+				}
+			}
+
+			indices |= bestIndex << (2 * i);
+		}
+	}
+
+	output[0] = uint8_t(color0 & 0xFF);
+	output[1] = uint8_t(color0 >> 8);
+	output[2] = uint8_t(color1 & 0xFF);
+	output[3] = uint8_t(color1 >> 8);
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		output[4 + i] = uint8_t(indices >> (8 * i));
+	}
+}
+
+void BlockCompressor::encodeBc4(const Block &block, uint32_t channel, uint8_t *output)
+{
+	uint8_t minValue = 255;
+	uint8_t maxValue = 0;
+	for (uint32_t i = 0; i < BLOCK_PIXEL_COUNT; i++)
+	{
+		minValue = std::min(minValue, block[i * 4 + channel]);
+		maxValue = std::max(maxValue, block[i * 4 + channel]);
+	}
+
+	// with greater first endpoint palette contains endpoints and 6 interpolated values
+	uint8_t palette[8];
+	palette[0] = maxValue;
+	palette[1] = minValue;
+	for (uint32_t i = 1; i < 7; i++)
+	{
+		palette[i + 1] = uint8_t(((7 - i) * maxValue + i * minValue) / 7);
+	}
+
+	uint64_t indices = 0;
+	if (maxValue != minValue)
+	{
+		for (uint32_t i = 0; i < BLOCK_PIXEL_COUNT; i++)
+		{
+			uint64_t bestIndex = 0;
+			int bestDistance = INT_MAX;
+			for (uint32_t p = 0; p < 8; p++)
+			{
+				const int distance = std::abs(int(block[i * 4 + channel]) - int(palette[p]));
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = p;
+				}
+			}
+
+			indices |= bestIndex << (3 * i);
+		}
+	}
+
+	output[0] = maxValue;
+	output[1] = minValue;
+	for (uint32_t i = 0; i < 6; i++)
+	{
+		output[2 + i] = uint8_t(indices >> (8 * i));
+	}
+}
+
+uint16_t BlockCompressor::toRgb565(const uint8_t *color)
+{
+	const uint16_t r = uint16_t((color[0] * 31 + 127) / 255);
+	const uint16_t g = uint16_t((color[1] * 63 + 127) / 255);
+	const uint16_t b = uint16_t((color[2] * 31 + 127) / 255);
+
+	return uint16_t(r << 11 | g << 5 | b);
+}
+
+void BlockCompressor::fromRgb565(uint16_t color, uint8_t *output)
+{
+	const uint8_t r = uint8_t(color >> 11 & 0x1F);
+	const uint8_t g = uint8_t(color >> 5 & 0x3F);
+	const uint8_t b = uint8_t(color & 0x1F);
+
+	output[0] = uint8_t(r << 3 | r >> 2);
+	output[1] = uint8_t(g << 2 | g >> 4);
+	output[2] = uint8_t(b << 3 | b >> 2);
+}
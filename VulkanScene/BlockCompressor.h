@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+
+// encodes RGBA8 pixels into block compressed formats (BC1, BC4, BC5),
+// endpoints are fitted by bounds of block colors, it's fast but not the best quality
+class BlockCompressor
+{
+public:
+	// returns true if format can be encoded
+	static bool supports(VkFormat format);
+
+	// image is divided into 4x4 blocks, blocks on edges are filled by edge pixels
+	static std::vector<uint8_t> encode(VkFormat format, const uint8_t *pixels, VkExtent2D extent);
+
+private:
+	static const uint32_t BLOCK_DIM = 4;
+
+	static const uint32_t BLOCK_PIXEL_COUNT = BLOCK_DIM * BLOCK_DIM;
+
+	// RGBA8 pixels of one block
+	typedef uint8_t Block[BLOCK_PIXEL_COUNT * 4];
+
+	// 8 bytes: two RGB565 endpoints and 2 bit indices
+	static void encodeBc1(const Block &block, uint8_t *output);
+
+	// 8 bytes: two 8 bit endpoints of channel and 3 bit indices
+	static void encodeBc4(const Block &block, uint32_t channel, uint8_t *output);
+
+	static uint16_t toRgb565(const uint8_t *color);
+
+	static void fromRgb565(uint16_t color, uint8_t *output);
+};
+
@@ -0,0 +1,49 @@
+#include "BoundingVolume.h"
+
+// public:
+
+BoundingVolume::BoundingVolume(glm::vec3 min, glm::vec3 max) : min(min), max(max)
+{
+	center = (min + max) * 0.5f;
+	radius = glm::length(max - min) * 0.5f;
+}
+
+glm::vec3 BoundingVolume::getMin() const
+{
+	return min;
+}
+
+glm::vec3 BoundingVolume::getMax() const
+{
+	return max;
+}
+
+glm::vec3 BoundingVolume::getCenter() const
+{
+	return center;
+}
+
+float BoundingVolume::getRadius() const
+{
+	return radius;
+}
+
+BoundingVolume BoundingVolume::merge(const BoundingVolume &volume) const
+{
+	return BoundingVolume(glm::min(min, volume.min), glm::max(max, volume.max));
+}
+
+BoundingVolume BoundingVolume::transform(const glm::mat4 &matrix) const
+{
+	// extents of transformed box are projections of its half sizes onto world axes
+	const glm::vec3 halfSize = (max - min) * 0.5f;
+	const glm::vec3 newCenter = glm::vec3(matrix * glm::vec4(center, 1.0f));
+
+	glm::vec3 newHalfSize(0.0f);
+	for (int i = 0; i < 3; i++)
+	{
+		newHalfSize += glm::abs(glm::vec3(matrix[i])) * halfSize[i];
+	}
+
+	return BoundingVolume(newCenter - newHalfSize, newCenter + newHalfSize);
+}
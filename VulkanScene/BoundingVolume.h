@@ -0,0 +1,40 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <limits>
+
+// axis aligned box with sphere around it
+class BoundingVolume
+{
+public:
+	// creates empty volume
+	BoundingVolume() = default;
+
+	BoundingVolume(glm::vec3 min, glm::vec3 max);
+
+	glm::vec3 getMin() const;
+
+	glm::vec3 getMax() const;
+
+	glm::vec3 getCenter() const;
+
+	float getRadius() const;
+
+	// returns volume which contains both volumes
+	BoundingVolume merge(const BoundingVolume &volume) const;
+
+	// returns volume which contains this volume transformed by matrix
+	BoundingVolume transform(const glm::mat4 &matrix) const;
+
+private:
+	glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+
+	glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+
+	glm::vec3 center = glm::vec3(0.0f);
+
+	float radius = 0.0f;
+};
+
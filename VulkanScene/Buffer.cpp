@@ -1,22 +1,50 @@
+#include <cassert>
+
 #include "Buffer.h"
 
 // public:
 
-Buffer::Buffer(Device *device, VkBufferUsageFlags usage, VkDeviceSize size) : StagingBuffer(device, size)
+Buffer::Buffer(Device *device, VkBufferUsageFlags usage, VkDeviceSize size, Mode mode)
 {
-	createBuffer(
-		device,
-		size,
-		usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-		&buffer,
-		&memory);
+	this->device = device;
+	this->size = size;
+	this->mode = mode;
+
+	if (mode == STATIC)
+	{
+		totalStaticSize += size;
+
+		StagingBuffer::createBuffer(
+			device,
+			size,
+			usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			MemoryAllocator::FREE_LIST,
+			&buffer,
+			&memory);
+	}
+	else
+	{
+		StagingBuffer::createBuffer(
+			device,
+			size,
+			usage,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			MemoryAllocator::FREE_LIST,
+			&buffer,
+			&memory);
+	}
 }
 
 Buffer::~Buffer()
 {
-	vkFreeMemory(device->get(), memory, nullptr);
+	if (mode == STATIC)
+	{
+		totalStaticSize -= size;
+	}
+
 	vkDestroyBuffer(device->get(), buffer, nullptr);
+	device->getMemoryAllocator()->free(memory);
 }
 
 VkBuffer Buffer::get() const
@@ -24,16 +52,54 @@ VkBuffer Buffer::get() const
 	return buffer;
 }
 
+VkDeviceSize Buffer::getSize() const
+{
+	return size;
+}
+
+Buffer::Mode Buffer::getMode() const
+{
+	return mode;
+}
+
 void Buffer::updateData(const void *data, VkDeviceSize dataSize, VkDeviceSize offset)
 {
-	StagingBuffer::updateData(data, dataSize, offset);
+	assert(offset + dataSize <= size);
+
+	if (mode == DYNAMIC)
+	{
+		memcpy(reinterpret_cast<uint8_t*>(memory.mappedData) + offset, data, dataSize);
+		return;
+	}
 
-	VkCommandBuffer commandBuffer = device->beginOneTimeCommands();
+	// staging memory is taken from transient upload arena and returned when copying is executed
+	StagingBuffer *stagingBuffer = new StagingBuffer(device, dataSize);
+	stagingBuffer->updateData(data, dataSize, 0);
+
+	VkCommandBuffer commandBuffer = device->beginTransferCommands();
 	VkBufferCopy region{
-		offset,
+		0,
 		offset,	
 		dataSize,
 	};
-	vkCmdCopyBuffer(commandBuffer, stagingBuffer, buffer, 1, &region);
-	device->endOneTimeCommands(commandBuffer);
+	vkCmdCopyBuffer(commandBuffer, stagingBuffer->get(), buffer, 1, &region);
+	device->endTransferCommands(commandBuffer);
+
+	device->releaseStagingBuffer(stagingBuffer);
+}
+
+const void* Buffer::getMappedData() const
+{
+	assert(mode == DYNAMIC);
+
+	return memory.mappedData;
 }
+
+VkDeviceSize Buffer::getTotalStaticSize()
+{
+	return totalStaticSize;
+}
+
+// private:
+
+VkDeviceSize Buffer::totalStaticSize = 0;
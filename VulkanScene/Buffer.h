@@ -4,21 +4,47 @@
 #include "Device.h"
 #include "StagingBuffer.h"
 
-// buffer with device local memory 
-// updates using staging buffer
-class Buffer : public StagingBuffer
+// buffer that is used by GPU
+class Buffer
 {
 public:
-	Buffer(Device *device, VkBufferUsageFlags usage, VkDeviceSize size);
+	enum Mode
+	{
+		// device local memory, updates are copied from transient staging buffer
+		STATIC,
+
+		// host visible memory, updates are written directly (for often updated data)
+		DYNAMIC
+	};
+
+	Buffer(Device *device, VkBufferUsageFlags usage, VkDeviceSize size, Mode mode = STATIC);
 	~Buffer();
 
 	VkBuffer get() const;
 
-	void updateData(const void *data, VkDeviceSize dataSize, VkDeviceSize offset) override;
+	VkDeviceSize getSize() const;
+
+	Mode getMode() const;
+
+	void updateData(const void *data, VkDeviceSize dataSize, VkDeviceSize offset);
+
+	// returns host memory of dynamic buffer (e.g. to read data copied by GPU)
+	const void* getMappedData() const;
+
+	// size of all existing static buffers (host visible copies of their data aren't kept)
+	static VkDeviceSize getTotalStaticSize();
 
 private:
+	Device *device;
+
 	VkBuffer buffer;
 
-	VkDeviceMemory memory;
+	VkDeviceSize size;
+
+	Mode mode;
+
+	MemoryAllocation memory;
+
+	static VkDeviceSize totalStaticSize;
 };
 
@@ -6,7 +6,7 @@
 
 // public:
 
-Camera::Camera(Device *device, VkExtent2D extent) : extent(extent)
+Camera::Camera(Device *device, VkExtent2D extent, uint32_t frameCount) : extent(extent)
 {
 	attributes.position = glm::vec3(0.0f, 0.0f, 0.0f);
 	attributes.forward = glm::vec3(0.0f, 0.0f, 1.0f);
@@ -18,15 +18,16 @@ Camera::Camera(Device *device, VkExtent2D extent) : extent(extent)
 	attributes.farPlane = 100.0f;
 
 	initAngles();
-	initSpaceBuffer(device);
+	initSpaceBuffer(device, frameCount);
 }
 
-Camera::Camera(Device *device, VkExtent2D extent, Attributes attributes) : extent(extent), attributes(attributes)
+Camera::Camera(Device *device, VkExtent2D extent, Attributes attributes, uint32_t frameCount)
+	: extent(extent), attributes(attributes)
 {
 	projectionMatrix = createProjectionMatrix();
 
 	initAngles();
-	initSpaceBuffer(device);
+	initSpaceBuffer(device, frameCount);
 }
 
 Camera::~Camera()
@@ -49,7 +50,7 @@ glm::vec3 Camera::getUp() const
 	return attributes.up;
 }
 
-Buffer* Camera::getSpaceBuffer() const
+UniformRing* Camera::getSpaceBuffer() const
 {
 	return spaceBuffer;
 }
@@ -134,8 +135,6 @@ void Camera::setExtent(VkExtent2D extent)
 	this->extent = extent;
 
 	projectionMatrix = createProjectionMatrix();
-
-	updateSpace();
 }
 
 void Camera::setMovement(Movement movement)
@@ -143,10 +142,20 @@ void Camera::setMovement(Movement movement)
 	this->movement = movement;
 }
 
-void Camera::updateSpace() const
+void Camera::place(glm::vec3 position, glm::vec3 forward)
+{
+	attributes.position = position;
+	attributes.forward = normalize(forward);
+
+	// up vector is restored from angles
+	initAngles();
+	rotate(0.0f, 0.0f);
+}
+
+void Camera::updateSpace(uint32_t frameIndex) const
 {
 	Space space{ getViewMatrix(), projectionMatrix };
-	spaceBuffer->updateData(&space, sizeof(space), 0);
+	spaceBuffer->updateFrameData(&space, sizeof(space), 0, frameIndex);
 }
 
 // private:
@@ -188,10 +197,12 @@ void Camera::initAngles()
 	angleV = glm::degrees(glm::asin(attributes.forward.y));
 }
 
-void Camera::initSpaceBuffer(Device *device)
+void Camera::initSpaceBuffer(Device *device, uint32_t frameCount)
 {
-	spaceBuffer = new Buffer(device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(Space));
-    updateSpace();
+	spaceBuffer = new UniformRing(device, sizeof(Space), frameCount);
+
+	Space space{ getViewMatrix(), projectionMatrix };
+	spaceBuffer->updateData(&space, sizeof(space), 0);
 }
 
 glm::mat4 Camera::createProjectionMatrix() const
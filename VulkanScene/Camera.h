@@ -4,7 +4,7 @@
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 #include <vulkan/vulkan.h>
-#include "Buffer.h"
+#include "UniformRing.h"
 
 class Camera
 {
@@ -36,9 +36,9 @@ public:
 	};
 
     // creates camera located in (0.0, 0.0, 0.0), locking at z axis, with 45.0 degrees field of view
-	Camera(Device *device, VkExtent2D extent);
+	Camera(Device *device, VkExtent2D extent, uint32_t frameCount);
 
-	Camera(Device *device, VkExtent2D extent, Attributes attributes);
+	Camera(Device *device, VkExtent2D extent, Attributes attributes, uint32_t frameCount);
 
 	~Camera();
 
@@ -48,7 +48,7 @@ public:
 
 	glm::vec3 getUp() const;
 
-	Buffer* getSpaceBuffer() const;
+	UniformRing* getSpaceBuffer() const;
 
 	glm::vec2 getCenter() const;
 
@@ -68,7 +68,11 @@ public:
 
 	void setMovement(Movement movement);
 
-	void updateSpace() const;
+	// moves camera to position and turns it in forward direction (e.g. to replay camera path)
+	void place(glm::vec3 position, glm::vec3 forward);
+
+	// writes view and projection matrices into slice of this frame
+	void updateSpace(uint32_t frameIndex) const;
 
 private:
 	VkExtent2D extent;
@@ -86,11 +90,11 @@ private:
 
 	glm::mat4 projectionMatrix;
 
-	Buffer *spaceBuffer;
+	UniformRing *spaceBuffer;
 
 	void initAngles();
 
-	void initSpaceBuffer(Device *device);
+	void initSpaceBuffer(Device *device, uint32_t frameCount);
 
 	glm::mat4 createProjectionMatrix() const;
 };
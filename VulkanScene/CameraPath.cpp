@@ -0,0 +1,113 @@
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include "File.h"
+
+#include "CameraPath.h"
+
+// public:
+
+CameraPath::CameraPath(const std::string &path)
+{
+	std::ifstream stream(File::getAbsolute(path));
+	if (!stream.is_open())
+	{
+		throw std::runtime_error("Failed to open camera path: " + path);
+	}
+
+	nlohmann::json json;
+	stream >> json;
+
+	if (json.find("timeStep") != json.end())
+	{
+		timeStep = json["timeStep"].get<float>();
+	}
+
+	for (const auto &keyJson : json["keys"])
+	{
+		keys.push_back({
+			keyJson["time"].get<float>(),
+			getVec3(keyJson["position"]),
+			getVec3(keyJson["forward"])
+		});
+	}
+
+	if (keys.empty() || timeStep <= 0.0f)
+	{
+		throw std::invalid_argument("Camera path must contain keys and positive time step");
+	}
+}
+
+void CameraPath::save(const std::string &path) const
+{
+	nlohmann::json json;
+	json["timeStep"] = timeStep;
+	json["keys"] = nlohmann::json::array();
+
+	for (const auto &key : keys)
+	{
+		json["keys"].push_back({
+			{ "time", key.time },
+			{ "position", getJson(key.position) },
+			{ "forward", getJson(key.forward) }
+		});
+	}
+
+	std::ofstream stream(File::getAbsolute(path));
+	stream << json.dump(4);
+}
+
+void CameraPath::addKey(float time, const Camera *camera)
+{
+	keys.push_back({ time, camera->getPos(), camera->getTarget() - camera->getPos() });
+}
+
+float CameraPath::getDuration() const
+{
+	return keys.empty() ? 0.0f : keys.back().time;
+}
+
+float CameraPath::getTimeStep() const
+{
+	return timeStep;
+}
+
+void CameraPath::apply(Camera *camera, float time) const
+{
+	// first key which is later than time
+	const auto next = std::upper_bound(
+		keys.begin(),
+		keys.end(),
+		time,
+		[](float time, const Key &key) { return time < key.time; });
+
+	if (next == keys.begin() || next == keys.end())
+	{
+		const Key &key = next == keys.begin() ? keys.front() : keys.back();
+		camera->place(key.position, key.forward);
+		return;
+	}
+
+	const Key &previous = *(next - 1);
+	const float t = (time - previous.time) / (next->time - previous.time);
+
+	camera->place(
+		glm::mix(previous.position, next->position, t),
+		glm::mix(previous.forward, next->forward, t));
+}
+
+// private:
+
+glm::vec3 CameraPath::getVec3(nlohmann::json json)
+{
+	return glm::vec3(json["x"].get<float>(), json["y"].get<float>(), json["z"].get<float>());
+}
+
+nlohmann::json CameraPath::getJson(glm::vec3 vector)
+{
+	return {
+		{ "x", vector.x },
+		{ "y", vector.y },
+		{ "z", vector.z }
+	};
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "Camera.h"
+
+// positions and directions of camera in time points,
+// it is recorded while user controls camera and replayed by benchmark
+class CameraPath
+{
+public:
+	CameraPath() = default;
+
+	CameraPath(const std::string &path);
+
+	void save(const std::string &path) const;
+
+	// time points of keys must increase
+	void addKey(float time, const Camera *camera);
+
+	// time of last key
+	float getDuration() const;
+
+	// step between frames of replay
+	float getTimeStep() const;
+
+	// places camera in position interpolated between keys
+	void apply(Camera *camera, float time) const;
+
+private:
+	struct Key
+	{
+		float time;
+		glm::vec3 position;
+		glm::vec3 forward;
+	};
+
+	const float DEFAULT_TIME_STEP = 1.0f / 60.0f;
+
+	float timeStep = DEFAULT_TIME_STEP;
+
+	std::vector<Key> keys;
+
+	static glm::vec3 getVec3(nlohmann::json json);
+
+	static nlohmann::json getJson(glm::vec3 vector);
+};
+
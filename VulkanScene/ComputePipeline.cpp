@@ -0,0 +1,80 @@
+#include <cassert>
+
+#include "ComputePipeline.h"
+
+// public:
+
+ComputePipeline::ComputePipeline(
+	Device *device,
+	const std::vector<VkDescriptorSetLayout> &descriptorSetLayouts,
+	const std::vector<VkPushConstantRange> &pushConstantRanges,
+	std::shared_ptr<ShaderModule> shaderModule)
+{
+	this->device = device;
+
+	createLayout(descriptorSetLayouts, pushConstantRanges);
+
+	createPipeline(shaderModule);
+}
+
+ComputePipeline::~ComputePipeline()
+{
+	vkDestroyPipeline(device->get(), pipeline, nullptr);
+	vkDestroyPipelineLayout(device->get(), layout, nullptr);
+}
+
+VkPipeline ComputePipeline::get() const
+{
+	return pipeline;
+}
+
+VkPipelineLayout ComputePipeline::getLayout() const
+{
+	return layout;
+}
+
+// private:
+
+void ComputePipeline::createLayout(
+	const std::vector<VkDescriptorSetLayout> &descriptorSetLayouts,
+	const std::vector<VkPushConstantRange> &pushConstantRanges)
+{
+	VkPipelineLayoutCreateInfo createInfo{
+		VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+		nullptr,
+		0,
+		uint32_t(descriptorSetLayouts.size()),
+		descriptorSetLayouts.data(),
+		uint32_t(pushConstantRanges.size()),
+		pushConstantRanges.data(),
+	};
+
+	const VkResult result = vkCreatePipelineLayout(device->get(), &createInfo, nullptr, &layout);
+	assert(result == VK_SUCCESS);
+}
+
+void ComputePipeline::createPipeline(std::shared_ptr<ShaderModule> shaderModule)
+{
+	const VkPipelineShaderStageCreateInfo shaderStageCreateInfo{
+		VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+		nullptr,
+		0,
+		shaderModule->getStage(),
+		shaderModule->getModule(),
+		"main",
+		shaderModule->getSpecializationInfo(),
+	};
+
+	VkComputePipelineCreateInfo createInfo{
+		VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+		nullptr,
+		0,
+		shaderStageCreateInfo,
+		layout,
+		nullptr,
+		-1
+	};
+
+	const VkResult result = vkCreateComputePipelines(device->get(), device->getPipelineCache(), 1, &createInfo, nullptr, &pipeline);
+	assert(result == VK_SUCCESS);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "ShaderModule.h"
+#include <memory>
+
+class ComputePipeline
+{
+public:
+	ComputePipeline(
+		Device *device,
+		const std::vector<VkDescriptorSetLayout> &descriptorSetLayouts,
+		const std::vector<VkPushConstantRange> &pushConstantRanges,
+		std::shared_ptr<ShaderModule> shaderModule);
+
+	~ComputePipeline();
+
+	VkPipeline get() const;
+
+	VkPipelineLayout getLayout() const;
+
+private:
+	Device *device;
+
+	VkPipeline pipeline;
+
+	VkPipelineLayout layout;
+
+	void createLayout(
+		const std::vector<VkDescriptorSetLayout> &descriptorSetLayouts,
+		const std::vector<VkPushConstantRange> &pushConstantRanges);
+
+	void createPipeline(std::shared_ptr<ShaderModule> shaderModule);
+};
+
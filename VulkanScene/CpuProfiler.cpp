@@ -0,0 +1,101 @@
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include "File.h"
+
+#include "CpuProfiler.h"
+
+// public:
+
+CpuProfiler::Scope::Scope(const char *name)
+{
+	this->name = name;
+	active = enabled.load(std::memory_order_relaxed);
+
+	if (active)
+	{
+		startTime = std::chrono::steady_clock::now();
+	}
+}
+
+CpuProfiler::Scope::~Scope()
+{
+	if (active)
+	{
+		addEvent(name, startTime);
+	}
+}
+
+void CpuProfiler::setEnabled(bool enabled)
+{
+	CpuProfiler::enabled.store(enabled);
+}
+
+bool CpuProfiler::isEnabled()
+{
+	return enabled.load();
+}
+
+void CpuProfiler::saveTrace(const std::string &path)
+{
+	nlohmann::json traceEvents = nlohmann::json::array();
+
+	{
+		std::lock_guard<std::mutex> lock(eventsMutex);
+
+		for (const auto &event : events)
+		{
+			traceEvents.push_back({
+				{ "name", event.name },
+				{ "cat", "cpu" },
+				{ "ph", "X" },
+				{ "ts", event.start },
+				{ "dur", event.duration },
+				{ "pid", 0 },
+				{ "tid", event.threadId }
+			});
+		}
+	}
+
+	nlohmann::json trace;
+	trace["traceEvents"] = traceEvents;
+	trace["displayTimeUnit"] = "ms";
+
+	std::ofstream stream(File::getAbsolute(path));
+	stream << trace.dump();
+}
+
+// private:
+
+std::atomic<bool> CpuProfiler::enabled{ false };
+
+std::chrono::steady_clock::time_point CpuProfiler::origin = std::chrono::steady_clock::now();
+
+std::mutex CpuProfiler::eventsMutex;
+
+std::vector<CpuProfiler::Event> CpuProfiler::events;
+
+std::atomic<uint32_t> CpuProfiler::threadCount{ 0 };
+
+uint32_t CpuProfiler::getThreadId()
+{
+	thread_local const uint32_t threadId = threadCount++;
+
+	return threadId;
+}
+
+void CpuProfiler::addEvent(const char *name, std::chrono::steady_clock::time_point startTime)
+{
+	using microseconds = std::chrono::microseconds;
+
+	const auto endTime = std::chrono::steady_clock::now();
+
+	const Event event{
+		name,
+		getThreadId(),
+		std::chrono::duration_cast<microseconds>(startTime - origin).count(),
+		std::chrono::duration_cast<microseconds>(endTime - startTime).count()
+	};
+
+	std::lock_guard<std::mutex> lock(eventsMutex);
+	events.push_back(event);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+
+// records time of code scopes of all threads and saves them as Chrome trace
+// (chrome://tracing or Perfetto), disabled profiler only checks flag in scope constructor
+class CpuProfiler
+{
+public:
+	// measures time from construction to destruction,
+	// name must be string literal (it isn't copied)
+	class Scope
+	{
+	public:
+		Scope(const char *name);
+
+		~Scope();
+
+	private:
+		const char *name;
+
+		bool active;
+
+		std::chrono::steady_clock::time_point startTime;
+	};
+
+	static void setEnabled(bool enabled);
+
+	static bool isEnabled();
+
+	// writes all recorded scopes into json file
+	static void saveTrace(const std::string &path);
+
+private:
+	// microseconds since profiler origin
+	struct Event
+	{
+		const char *name;
+		uint32_t threadId;
+		int64_t start;
+		int64_t duration;
+	};
+
+	static std::atomic<bool> enabled;
+
+	static std::chrono::steady_clock::time_point origin;
+
+	static std::mutex eventsMutex;
+
+	static std::vector<Event> events;
+
+	static std::atomic<uint32_t> threadCount;
+
+	// small sequential id of calling thread
+	static uint32_t getThreadId();
+
+	static void addEvent(const char *name, std::chrono::steady_clock::time_point startTime);
+};
+
@@ -4,7 +4,13 @@
 
 // public:
 
-DescriptorPool::DescriptorPool(Device *device, uint32_t bufferCount, uint32_t textureCount, uint32_t setCount)
+DescriptorPool::DescriptorPool(
+	Device *device,
+	uint32_t bufferCount,
+	uint32_t dynamicBufferCount,
+	uint32_t textureCount,
+	uint32_t storageBufferCount,
+	uint32_t setCount)
 {
 	this->device = device;
 
@@ -12,12 +18,20 @@ DescriptorPool::DescriptorPool(Device *device, uint32_t bufferCount, uint32_t te
 		VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
 		bufferCount,
 	};
+	const VkDescriptorPoolSize dynamicUniformBuffersSize{
+		VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+		dynamicBufferCount,
+	};
     const VkDescriptorPoolSize texturesSize{
 		VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
 		textureCount,
 	};
 
-	std::vector<VkDescriptorPoolSize> poolSizes{ uniformBuffersSize, texturesSize };
+	std::vector<VkDescriptorPoolSize> poolSizes{ uniformBuffersSize, dynamicUniformBuffersSize, texturesSize };
+	if (storageBufferCount > 0)
+	{
+		poolSizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, storageBufferCount });
+	}
 
 	VkDescriptorPoolCreateInfo createInfo{
 		VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
@@ -39,7 +53,9 @@ DescriptorPool::~DescriptorPool()
 
 VkDescriptorSetLayout DescriptorPool::createDescriptorSetLayout(
 	std::vector<VkShaderStageFlags> buffersShaderStages,
-	std::vector<VkShaderStageFlags> texturesShaderStages) const
+	std::vector<VkShaderStageFlags> dynamicBuffersShaderStages,
+	std::vector<VkShaderStageFlags> texturesShaderStages,
+	std::vector<VkShaderStageFlags> storageBuffersShaderStages) const
 {
 	std::vector<VkDescriptorSetLayoutBinding> bindings;
 
@@ -56,10 +72,23 @@ VkDescriptorSetLayout DescriptorPool::createDescriptorSetLayout(
 		bindings.push_back(uniformBufferLayoutBinding);
 	}
 
+	for (size_t i = 0; i < dynamicBuffersShaderStages.size(); i++)
+	{
+		VkDescriptorSetLayoutBinding dynamicBufferLayoutBinding{
+			uint32_t(buffersShaderStages.size() + i),
+			VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+			1,
+			dynamicBuffersShaderStages[i],
+			nullptr
+		};
+
+		bindings.push_back(dynamicBufferLayoutBinding);
+	}
+
 	for (size_t i = 0; i < texturesShaderStages.size(); i++)
 	{
 		VkDescriptorSetLayoutBinding textureLayoutBinding{
-			uint32_t(buffersShaderStages.size() + i),    
+			uint32_t(buffersShaderStages.size() + dynamicBuffersShaderStages.size() + i),
 			VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 
 			1,                                         
 			texturesShaderStages[i],                   
@@ -69,6 +98,20 @@ VkDescriptorSetLayout DescriptorPool::createDescriptorSetLayout(
 		bindings.push_back(textureLayoutBinding);
 	}
 
+	const size_t storageBuffersOffset = buffersShaderStages.size() + dynamicBuffersShaderStages.size() + texturesShaderStages.size();
+	for (size_t i = 0; i < storageBuffersShaderStages.size(); i++)
+	{
+		VkDescriptorSetLayoutBinding storageBufferLayoutBinding{
+			uint32_t(storageBuffersOffset + i),
+			VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+			1,
+			storageBuffersShaderStages[i],
+			nullptr
+		};
+
+		bindings.push_back(storageBufferLayoutBinding);
+	}
+
 	VkDescriptorSetLayoutCreateInfo createInfo{
 		VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
 		nullptr,											
@@ -104,7 +147,9 @@ VkDescriptorSet DescriptorPool::getDescriptorSet(VkDescriptorSetLayout layout) c
 void DescriptorPool::updateDescriptorSet(
 	VkDescriptorSet set, 
 	std::vector<Buffer*> buffers,
-	std::vector<TextureImage*> textures) const
+	std::vector<UniformRing*> dynamicBuffers,
+	std::vector<TextureImage*> textures,
+	std::vector<Buffer*> storageBuffers) const
 {
 	std::vector<VkWriteDescriptorSet> buffersWrites;
 	std::vector<VkDescriptorBufferInfo> buffersInfo(buffers.size());
@@ -133,6 +178,32 @@ void DescriptorPool::updateDescriptorSet(
 		buffersWrites.push_back(bufferWrite);
 	}
 
+	std::vector<VkDescriptorBufferInfo> dynamicBuffersInfo(dynamicBuffers.size());
+
+	for (size_t i = 0; i < dynamicBuffers.size(); i++)
+	{
+		dynamicBuffersInfo[i] = {
+			dynamicBuffers[i]->get(),
+			0,
+			dynamicBuffers[i]->getFrameSize()
+		};
+
+		VkWriteDescriptorSet bufferWrite{
+			VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			nullptr,
+			set,
+			uint32_t(buffers.size() + i),
+			0,
+			1,
+			VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+			nullptr,
+			&dynamicBuffersInfo[i],
+			nullptr,
+		};
+
+		buffersWrites.push_back(bufferWrite);
+	}
+
 	std::vector<VkWriteDescriptorSet> texturesWrites;
 	std::vector<VkDescriptorImageInfo> imagesInfo(textures.size());
 
@@ -148,7 +219,7 @@ void DescriptorPool::updateDescriptorSet(
 			VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
 			nullptr,									
 			set,										
-			uint32_t(buffers.size() + i),						
+			uint32_t(buffers.size() + dynamicBuffers.size() + i),
 			0,											
 			1,											
 			VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,	
@@ -160,6 +231,32 @@ void DescriptorPool::updateDescriptorSet(
 		texturesWrites.push_back(textureWrite);
 	}
 
+	std::vector<VkDescriptorBufferInfo> storageBuffersInfo(storageBuffers.size());
+
+	for (size_t i = 0; i < storageBuffers.size(); i++)
+	{
+		storageBuffersInfo[i] = {
+			storageBuffers[i]->get(),
+			0,
+			storageBuffers[i]->getSize()
+		};
+
+		VkWriteDescriptorSet bufferWrite{
+			VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			nullptr,
+			set,
+			uint32_t(buffers.size() + dynamicBuffers.size() + textures.size() + i),
+			0,
+			1,
+			VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+			nullptr,
+			&storageBuffersInfo[i],
+			nullptr,
+		};
+
+		buffersWrites.push_back(bufferWrite);
+	}
+
 	std::vector<VkWriteDescriptorSet> descriptorWrites(buffersWrites.begin(), buffersWrites.end());
 	descriptorWrites.insert(descriptorWrites.end(), texturesWrites.begin(), texturesWrites.end());
 
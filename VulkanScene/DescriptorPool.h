@@ -3,25 +3,39 @@
 #include <vulkan/vulkan.h>
 #include "Device.h"
 #include "Buffer.h"
+#include "UniformRing.h"
 #include "TextureImage.h"
 
 class DescriptorPool
 {
 public:
-	DescriptorPool(Device *device, uint32_t bufferCount, uint32_t textureCount, uint32_t setCount);
+	DescriptorPool(
+		Device *device,
+		uint32_t bufferCount,
+		uint32_t dynamicBufferCount,
+		uint32_t textureCount,
+		uint32_t storageBufferCount,
+		uint32_t setCount);
 
 	~DescriptorPool();
 
+	// bindings order: buffers, dynamic buffers, textures, storage buffers
 	VkDescriptorSetLayout createDescriptorSetLayout(
 		std::vector<VkShaderStageFlags> buffersShaderStages,
-		std::vector<VkShaderStageFlags> texturesShaderStages) const;
+		std::vector<VkShaderStageFlags> dynamicBuffersShaderStages,
+		std::vector<VkShaderStageFlags> texturesShaderStages,
+		std::vector<VkShaderStageFlags> storageBuffersShaderStages = {}) const;
 
 	VkDescriptorSet getDescriptorSet(VkDescriptorSetLayout layout) const;
 
+	// dynamic buffers are bound with range of one frame slice,
+	// offset of slice is set with vkCmdBindDescriptorSets
 	void updateDescriptorSet(
 		VkDescriptorSet set,
 		std::vector<Buffer*> buffers,
-		std::vector<TextureImage*> textures) const;
+		std::vector<UniformRing*> dynamicBuffers,
+		std::vector<TextureImage*> textures,
+		std::vector<Buffer*> storageBuffers = {}) const;
 
 private:
 	Device *device;
@@ -1,10 +1,18 @@
 #include <vector>
 #include <set>
 #include <cassert>
+#include "StagingBuffer.h"
+#include "TextureCache.h"
+#include "TextureStreamer.h"
 
 #include "Device.h"
 #include <algorithm>
 #include <stdexcept>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include "File.h"
+#include "CpuProfiler.h"
 
 // public:
 
@@ -21,11 +29,26 @@ Device::Device(
 	sampleCount = maxSupportedSampleCount > maxRequiredSampleCount ? maxRequiredSampleCount : maxSupportedSampleCount;
 
 	createDevice(requiredLayers);
-	createCommandPool();
+	createCommandPools();
+	createPipelineCache();
+
+	memoryAllocator = new MemoryAllocator(this);
+	textureCache = new TextureCache();
 }
 
 Device::~Device()
 {
+	// unsaved cache is only rebuilt on next launch
+	savePipelineCache();
+	vkDestroyPipelineCache(device, pipelineCache, nullptr);
+
+	delete textureCache;
+	delete textureStreamer;
+	delete memoryAllocator;
+	if (transferCommandPool != commandPool)
+	{
+		vkDestroyCommandPool(device, transferCommandPool, nullptr);
+	}
 	vkDestroyCommandPool(device, commandPool, nullptr);
 	vkDestroyDevice(device, nullptr);
 }
@@ -45,6 +68,11 @@ VkQueue Device::getPresentQueue() const
 	return presentQueue;
 }
 
+VkQueue Device::getTransferQueue() const
+{
+	return transferQueue;
+}
+
 VkCommandPool Device::getCommandPool() const
 {
 	return commandPool;
@@ -58,6 +86,44 @@ VkFormatProperties Device::getFormatProperties(VkFormat format) const
 	return formatProperties;
 }
 
+VkPhysicalDeviceLimits Device::getLimits() const
+{
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	return properties.limits;
+}
+
+VkPhysicalDeviceMemoryProperties Device::getMemoryProperties() const
+{
+	VkPhysicalDeviceMemoryProperties memoryProperties;
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+	return memoryProperties;
+}
+
+MemoryAllocator* Device::getMemoryAllocator() const
+{
+	return memoryAllocator;
+}
+
+TextureCache* Device::getTextureCache() const
+{
+	return textureCache;
+}
+
+void Device::enableTextureStreaming(VkDeviceSize budget, uint32_t frameCount)
+{
+	assert(!textureStreamer);
+
+	textureStreamer = new TextureStreamer(this, budget, frameCount);
+}
+
+TextureStreamer* Device::getTextureStreamer() const
+{
+	return textureStreamer;
+}
+
 uint32_t Device::findMemoryTypeIndex(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
 {
 	VkPhysicalDeviceMemoryProperties memProperties;
@@ -110,57 +176,183 @@ VkSampleCountFlagBits Device::getSampleCount() const
 	return sampleCount;
 }
 
-VkCommandBuffer Device::beginOneTimeCommands() const
+VkPipelineCache Device::getPipelineCache() const
 {
-	VkCommandBuffer commandBuffer;
+	return pipelineCache;
+}
 
-	VkCommandBufferAllocateInfo allocInfo{
-		VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-		nullptr,
-		commandPool,
-		VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-		1,
-	};
+bool Device::isPipelineCacheLoaded() const
+{
+	return pipelineCacheLoaded;
+}
 
-	VkResult result = vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
-	assert(result == VK_SUCCESS);
+bool Device::isDrawIndirectFirstInstanceSupported() const
+{
+	return drawIndirectFirstInstanceSupported;
+}
 
-	VkCommandBufferBeginInfo beginInfo{
-		VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-		nullptr,
-		VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-		nullptr,
-	};
+bool Device::isMultiDrawIndirectSupported() const
+{
+	return multiDrawIndirectSupported;
+}
 
-	result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
-	assert(result == VK_SUCCESS);
+bool Device::isPipelineStatisticsQuerySupported() const
+{
+	return pipelineStatisticsQuerySupported;
+}
 
-	return commandBuffer;
+bool Device::isTextureCompressionBcSupported() const
+{
+	return textureCompressionBcSupported;
+}
+
+bool Device::isDepthClampSupported() const
+{
+	return depthClampSupported;
+}
+
+PFN_vkCmdDrawIndexedIndirectCountKHR Device::getDrawIndexedIndirectCount() const
+{
+	return drawIndexedIndirectCount;
+}
+
+VkCommandBuffer Device::beginOneTimeCommands() const
+{
+	if (uploadBatchActive)
+	{
+		return batchCommandBuffer;
+	}
+
+	return beginCommands(commandPool);
 }
 
 void Device::endOneTimeCommands(VkCommandBuffer commandBuffer) const
 {
-	VkResult result = vkEndCommandBuffer(commandBuffer);
+	if (uploadBatchActive)
+	{
+		recordBatchBarrier(commandBuffer);
+		return;
+	}
+
+	submitCommands(commandBuffer, graphicsQueue, commandPool);
+}
+
+VkCommandBuffer Device::beginTransferCommands() const
+{
+	if (uploadBatchActive)
+	{
+		return batchTransferCommandBuffer;
+	}
+
+	return beginCommands(transferCommandPool);
+}
+
+void Device::endTransferCommands(VkCommandBuffer commandBuffer) const
+{
+	if (uploadBatchActive)
+	{
+		recordBatchBarrier(commandBuffer);
+		return;
+	}
+
+	submitCommands(commandBuffer, transferQueue, transferCommandPool);
+}
+
+void Device::beginUploadBatch()
+{
+	assert(!uploadBatchActive);
+
+	batchCommandBuffer = beginCommands(commandPool);
+	batchTransferCommandBuffer = beginCommands(transferCommandPool);
+
+	uploadBatchActive = true;
+}
+
+void Device::endUploadBatch()
+{
+	assert(uploadBatchActive);
+	uploadBatchActive = false;
+
+	VkResult result = vkEndCommandBuffer(batchTransferCommandBuffer);
+	assert(result == VK_SUCCESS);
+	result = vkEndCommandBuffer(batchCommandBuffer);
 	assert(result == VK_SUCCESS);
 
+	VkFenceCreateInfo fenceInfo{
+		VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+		nullptr,
+		0,
+	};
+
+	std::vector<VkFence> fences(2);
+	for (auto &fence : fences)
+	{
+		result = vkCreateFence(device, &fenceInfo, nullptr, &fence);
+		assert(result == VK_SUCCESS);
+	}
+
+	// buffer copies and image commands don't depend on each other,
+	// so they are executed by different queues at the same time
 	VkSubmitInfo submitInfo{
 		VK_STRUCTURE_TYPE_SUBMIT_INFO,
 		nullptr,
 		0,
 		nullptr,
-		nullptr,	
+		nullptr,
 		1,
-		&commandBuffer,
+		&batchTransferCommandBuffer,
 		0,
-		nullptr,	
+		nullptr,
 	};
+	result = vkQueueSubmit(transferQueue, 1, &submitInfo, fences[0]);
+	assert(result == VK_SUCCESS);
+
+	submitInfo.pCommandBuffers = &batchCommandBuffer;
+	result = vkQueueSubmit(graphicsQueue, 1, &submitInfo, fences[1]);
+	assert(result == VK_SUCCESS);
 
-	result = vkQueueSubmit(graphicsQueue, 1, &submitInfo, nullptr);
+	{
+		const CpuProfiler::Scope profilerScope("Device::waitUploadBatch");
+		result = vkWaitForFences(device, uint32_t(fences.size()), fences.data(), VK_TRUE, UINT64_MAX);
+	}
 	assert(result == VK_SUCCESS);
 
-	vkQueueWaitIdle(graphicsQueue);  // TODO: replace wait idle to signal semaphore
+	for (auto fence : fences)
+	{
+		vkDestroyFence(device, fence, nullptr);
+	}
+	vkFreeCommandBuffers(device, transferCommandPool, 1, &batchTransferCommandBuffer);
+	vkFreeCommandBuffers(device, commandPool, 1, &batchCommandBuffer);
+
+	for (auto stagingBuffer : batchStagingBuffers)
+	{
+		delete stagingBuffer;
+	}
+	batchStagingBuffers.clear();
+	batchStagingSize = 0;
+}
+
+void Device::releaseStagingBuffer(StagingBuffer *stagingBuffer)
+{
+	if (!uploadBatchActive)
+	{
+		delete stagingBuffer;
+		return;
+	}
+
+	batchStagingBuffers.push_back(stagingBuffer);
+	batchStagingSize += stagingBuffer->getSize();
+
+	if (batchStagingSize > MAX_BATCH_STAGING_SIZE)
+	{
+		endUploadBatch();
+		beginUploadBatch();
+	}
+}
 
-	vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+uint64_t Device::getWaitIdleCount() const
+{
+	return waitIdleCount;
 }
 
 // private:
@@ -176,7 +368,7 @@ VkPhysicalDevice Device::pickPhysicalDevice(VkInstance instance, const std::vect
 
 	for (auto device : physicalDevices)
 	{
-		if (physicalDeviceSuitable(device, layers, EXTENSIONS))
+		if (physicalDeviceSuitable(device, layers, getRequiredExtensions()))
 		{
 			return  device;
 		}
@@ -211,12 +403,18 @@ bool Device::physicalDeviceSuitable(
     const std::vector<const char*> &requiredExtensions) const
 {
 	QueueFamilyIndices indices(device, surface);
-	SurfaceSupportDetails details(device, surface);
+
+	// device without surface doesn't present frames
+	bool surfaceSupport = true;
+	if (surface != VK_NULL_HANDLE)
+	{
+		surfaceSupport = SurfaceSupportDetails(device, surface).suitable();
+	}
 
     const bool layerSupport = checkDeviceLayerSupport(device, requiredLayers);
     const bool extensionSupport = checkDeviceExtensionSupport(device, requiredExtensions);
 
-	return indices.completed() && details.suitable() && layerSupport && extensionSupport;
+	return indices.completed() && surfaceSupport && layerSupport && extensionSupport;
 }
 
 bool Device::checkDeviceLayerSupport(VkPhysicalDevice device, const std::vector<const char*> &requiredLayers)
@@ -257,13 +455,24 @@ bool Device::checkDeviceExtensionSupport(VkPhysicalDevice device, const std::vec
 	return requiredExtensionSet.empty();
 }
 
+std::vector<const char*> Device::getRequiredExtensions() const
+{
+	if (surface != VK_NULL_HANDLE)
+	{
+		return PRESENT_EXTENSIONS;
+	}
+
+	return {};
+}
+
 void Device::createDevice(const std::vector<const char*> &layers)
 {
 	QueueFamilyIndices queueFamilyIndices = getQueueFamilyIndices();
 
 	std::set<uint32_t> uniqueQueueFamilyIndices{
 		queueFamilyIndices.getGraphics(),
-		queueFamilyIndices.getPresent()
+		queueFamilyIndices.getPresent(),
+		queueFamilyIndices.getTransfer()
 	};
 
 	// info about each unique queue family
@@ -283,9 +492,31 @@ void Device::createDevice(const std::vector<const char*> &layers)
 		queueCreateInfos.push_back(queueCreateInfo);
 	}
 
+	VkPhysicalDeviceFeatures supportedFeatures;
+	vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+	drawIndirectFirstInstanceSupported = supportedFeatures.drawIndirectFirstInstance;
+	multiDrawIndirectSupported = supportedFeatures.multiDrawIndirect;
+	pipelineStatisticsQuerySupported = supportedFeatures.pipelineStatisticsQuery;
+	textureCompressionBcSupported = supportedFeatures.textureCompressionBC;
+	depthClampSupported = supportedFeatures.depthClamp;
+
 	VkPhysicalDeviceFeatures deviceFeatures{};
 	deviceFeatures.samplerAnisotropy = true;
 	deviceFeatures.sampleRateShading = true;
+	deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+	deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+	deviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
+	deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+	deviceFeatures.depthClamp = supportedFeatures.depthClamp;
+
+	std::vector<const char*> extensions = getRequiredExtensions();
+	for (auto extension : OPTIONAL_EXTENSIONS)
+	{
+		if (checkDeviceExtensionSupport(physicalDevice, { extension }))
+		{
+			extensions.push_back(extension);
+		}
+	}
 
 	VkDeviceCreateInfo deviceCreateInfo{
 		VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
@@ -295,8 +526,8 @@ void Device::createDevice(const std::vector<const char*> &layers)
 		queueCreateInfos.data(),
 		uint32_t(layers.size()),
 		layers.data(),
-		uint32_t(EXTENSIONS.size()),
-		EXTENSIONS.data(),
+		uint32_t(extensions.size()),
+		extensions.data(),
 		&deviceFeatures
 	};
 
@@ -306,17 +537,190 @@ void Device::createDevice(const std::vector<const char*> &layers)
 	// save queue handlers
 	vkGetDeviceQueue(device, queueFamilyIndices.getGraphics(), 0, &graphicsQueue);
 	vkGetDeviceQueue(device, queueFamilyIndices.getPresent(), 0, &presentQueue);
+	vkGetDeviceQueue(device, queueFamilyIndices.getTransfer(), 0, &transferQueue);
+
+	if (checkDeviceExtensionSupport(physicalDevice, { VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME }))
+	{
+		drawIndexedIndirectCount = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(
+			vkGetDeviceProcAddr(device, "vkCmdDrawIndexedIndirectCountKHR"));
+	}
 }
 
-void Device::createCommandPool()
+void Device::createCommandPools()
 {
+	const QueueFamilyIndices queueFamilyIndices = getQueueFamilyIndices();
+
 	VkCommandPoolCreateInfo createInfo{
 		VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
 		nullptr,
 		0,
-        getQueueFamilyIndices().getGraphics()
+        queueFamilyIndices.getGraphics()
     };
 
-    const VkResult result = vkCreateCommandPool(device, &createInfo, nullptr, &commandPool);
+    VkResult result = vkCreateCommandPool(device, &createInfo, nullptr, &commandPool);
+	assert(result == VK_SUCCESS);
+
+	transferCommandPool = commandPool;
+	if (queueFamilyIndices.hasDedicatedTransfer())
+	{
+		createInfo.queueFamilyIndex = queueFamilyIndices.getTransfer();
+		result = vkCreateCommandPool(device, &createInfo, nullptr, &transferCommandPool);
+		assert(result == VK_SUCCESS);
+	}
+}
+
+std::string Device::getPipelineCachePath() const
+{
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	std::stringstream path;
+	path << "Cache/Pipelines_" << std::hex << properties.vendorID << "_" << properties.deviceID << "_";
+	for (auto byte : properties.pipelineCacheUUID)
+	{
+		path << std::setw(2) << std::setfill('0') << uint32_t(byte);
+	}
+	path << ".bin";
+
+	return path.str();
+}
+
+void Device::createPipelineCache()
+{
+	const std::string path = getPipelineCachePath();
+
+	std::vector<char> data;
+	if (File::exists(path))
+	{
+		data = File::getBytes(path);
+	}
+
+	// data saved by other driver version is not passed to driver
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	const size_t headerSize = 4 * sizeof(uint32_t) + VK_UUID_SIZE;
+	if (data.size() >= headerSize)
+	{
+		uint32_t header[4];
+		memcpy(header, data.data(), sizeof header);
+
+		// first field is length of header, it can't exceed data
+		const bool valid = header[0] >= headerSize
+			&& header[0] <= data.size()
+			&& header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+			&& header[2] == properties.vendorID
+			&& header[3] == properties.deviceID
+			&& memcmp(data.data() + sizeof header, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+
+		if (!valid)
+		{
+			data.clear();
+		}
+	}
+	else
+	{
+		data.clear();
+	}
+
+	VkPipelineCacheCreateInfo createInfo{
+		VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+		nullptr,
+		0,
+		data.size(),
+		data.data()
+	};
+
+	const VkResult result = vkCreatePipelineCache(device, &createInfo, nullptr, &pipelineCache);
+	assert(result == VK_SUCCESS);
+
+	pipelineCacheLoaded = !data.empty();
+}
+
+bool Device::savePipelineCache() const
+{
+	size_t size;
+	VkResult result = vkGetPipelineCacheData(device, pipelineCache, &size, nullptr);
+	assert(result == VK_SUCCESS);
+
+	std::vector<char> data(size);
+	result = vkGetPipelineCacheData(device, pipelineCache, &size, data.data());
+	assert(result == VK_SUCCESS);
+
+	return File::writeBytes(getPipelineCachePath(), data);
+}
+
+VkCommandBuffer Device::beginCommands(VkCommandPool pool) const
+{
+	VkCommandBuffer commandBuffer;
+
+	VkCommandBufferAllocateInfo allocInfo{
+		VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+		nullptr,
+		pool,
+		VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+		1,
+	};
+
+	VkResult result = vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
+	assert(result == VK_SUCCESS);
+
+	VkCommandBufferBeginInfo beginInfo{
+		VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+		nullptr,
+		VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+		nullptr,
+	};
+
+	result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+	assert(result == VK_SUCCESS);
+
+	return commandBuffer;
+}
+
+void Device::submitCommands(VkCommandBuffer commandBuffer, VkQueue queue, VkCommandPool pool) const
+{
+	VkResult result = vkEndCommandBuffer(commandBuffer);
+	assert(result == VK_SUCCESS);
+
+	VkSubmitInfo submitInfo{
+		VK_STRUCTURE_TYPE_SUBMIT_INFO,
+		nullptr,
+		0,
+		nullptr,
+		nullptr,	
+		1,
+		&commandBuffer,
+		0,
+		nullptr,	
+	};
+
+	result = vkQueueSubmit(queue, 1, &submitInfo, nullptr);
 	assert(result == VK_SUCCESS);
+
+	{
+		const CpuProfiler::Scope profilerScope("Device::waitOneTimeCommands");
+		vkQueueWaitIdle(queue);  // TODO: replace wait idle to signal semaphore
+	}
+	waitIdleCount++;
+
+	vkFreeCommandBuffers(device, pool, 1, &commandBuffer);
+}
+
+void Device::recordBatchBarrier(VkCommandBuffer commandBuffer)
+{
+	VkMemoryBarrier barrier{
+		VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+		nullptr,
+		VK_ACCESS_TRANSFER_WRITE_BIT,
+		VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+	};
+
+	vkCmdPipelineBarrier(
+		commandBuffer,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0,
+		1, &barrier,
+		0, nullptr,
+		0, nullptr);
 }
\ No newline at end of file
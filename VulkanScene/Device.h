@@ -1,12 +1,19 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
+#include <string>
 #include "QueueFamilyIndices.h"
 #include "SurfaceSupportDetails.h"
+#include "MemoryAllocator.h"
+
+class StagingBuffer;
+class TextureCache;
+class TextureStreamer;
 
 class Device
 {
 public:
+	// surface can be null if device doesn't present frames (offscreen rendering)
 	Device(
 		VkInstance instance,
 		VkSurfaceKHR surface,
@@ -21,10 +28,36 @@ public:
 
 	VkQueue getPresentQueue() const;
 
+	// returns dedicated transfer queue or graphics queue if device doesn't have it
+	VkQueue getTransferQueue() const;
+
 	VkCommandPool getCommandPool() const;
 
 	VkFormatProperties getFormatProperties(VkFormat format) const;
 
+	VkPhysicalDeviceLimits getLimits() const;
+
+	VkPhysicalDeviceMemoryProperties getMemoryProperties() const;
+
+	// all buffers and images allocate their memory with this allocator
+	MemoryAllocator* getMemoryAllocator() const;
+
+	// textures loaded from files are shared through this cache
+	TextureCache* getTextureCache() const;
+
+	// textures of KTX2 files are streamed if it's enabled before they are created,
+	// budget limits device memory of their levels above tails
+	void enableTextureStreaming(VkDeviceSize budget, uint32_t frameCount);
+
+	// returns null if texture streaming isn't enabled
+	TextureStreamer* getTextureStreamer() const;
+
+	// all pipelines are created with this cache, it is saved to disk when device is destroyed
+	VkPipelineCache getPipelineCache() const;
+
+	// true if pipeline cache was loaded from file saved by previous run
+	bool isPipelineCacheLoaded() const;
+
 	// returns index of memory type with such properties (for this physical device)
 	uint32_t findMemoryTypeIndex(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
 
@@ -40,21 +73,76 @@ public:
 
 	VkSampleCountFlagBits getSampleCount() const;
 
+	// indirect draws can start from non zero instance
+	bool isDrawIndirectFirstInstanceSupported() const;
+
+	// one indirect draw can read more than one command
+	bool isMultiDrawIndirectSupported() const;
+
+	// vertex and fragment invocations can be counted by queries
+	bool isPipelineStatisticsQuerySupported() const;
+
+	// textures can have block compressed formats (BC1 - BC7)
+	bool isTextureCompressionBcSupported() const;
+
+	// fragment depth can be clamped instead of clipping primitives by near and far planes
+	bool isDepthClampSupported() const;
+
+	// returns null if VK_KHR_draw_indirect_count isn't supported
+	PFN_vkCmdDrawIndexedIndirectCountKHR getDrawIndexedIndirectCount() const;
+
 	// returns command buffer to write one time commands
 	VkCommandBuffer beginOneTimeCommands() const;
 
 	// ends command buffer and submit it to graphics queue
 	void endOneTimeCommands(VkCommandBuffer commandBuffer) const;
 
+	// returns command buffer to write one time buffer copies (executed by transfer queue)
+	VkCommandBuffer beginTransferCommands() const;
+
+	// ends command buffer and submit it to transfer queue
+	void endTransferCommands(VkCommandBuffer commandBuffer) const;
+
+	// while upload batch is active one time commands are recorded into shared command buffers
+	// which are submitted only when batch ends, so loading doesn't wait for each upload
+	void beginUploadBatch();
+
+	// submits recorded commands and waits until they are executed
+	void endUploadBatch();
+
+	// staging buffer is destroyed when commands that use it are executed
+	void releaseStagingBuffer(StagingBuffer *stagingBuffer);
+
+	// returns count of graphics queue wait idles caused by one time commands
+	uint64_t getWaitIdleCount() const;
+
 private:
-	const std::vector<const char*> EXTENSIONS{
+	// required only if device presents frames to surface
+	const std::vector<const char*> PRESENT_EXTENSIONS{
 		VK_KHR_SWAPCHAIN_EXTENSION_NAME
 	};
 
+	// enabled only if device supports them
+	const std::vector<const char*> OPTIONAL_EXTENSIONS{
+		VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME
+	};
+
 	VkDevice device;
 
 	VkSampleCountFlagBits sampleCount;
 
+	bool drawIndirectFirstInstanceSupported = false;
+
+	bool multiDrawIndirectSupported = false;
+
+	bool pipelineStatisticsQuerySupported = false;
+
+	bool textureCompressionBcSupported = false;
+
+	bool depthClampSupported = false;
+
+	PFN_vkCmdDrawIndexedIndirectCountKHR drawIndexedIndirectCount = nullptr;
+
 	VkPhysicalDevice physicalDevice;  // GPU
 
 	VkSurfaceKHR surface;
@@ -63,8 +151,37 @@ private:
 
 	VkQueue presentQueue;
 
+	VkQueue transferQueue;
+
 	VkCommandPool commandPool;
 
+	VkCommandPool transferCommandPool;
+
+	MemoryAllocator *memoryAllocator;
+
+	TextureCache *textureCache;
+
+	TextureStreamer *textureStreamer = nullptr;
+
+	VkPipelineCache pipelineCache;
+
+	bool pipelineCacheLoaded = false;
+
+	mutable uint64_t waitIdleCount = 0;
+
+	// staging data of one batch is limited, when limit is reached batch is flushed
+	const VkDeviceSize MAX_BATCH_STAGING_SIZE = 256 * 1024 * 1024;
+
+	bool uploadBatchActive = false;
+
+	VkCommandBuffer batchCommandBuffer;
+
+	VkCommandBuffer batchTransferCommandBuffer;
+
+	std::vector<StagingBuffer*> batchStagingBuffers;
+
+	VkDeviceSize batchStagingSize = 0;
+
     VkPhysicalDevice pickPhysicalDevice(VkInstance instance, const std::vector<const char*> &layers) const;
 
 	// has all required queue families,
@@ -81,8 +198,25 @@ private:
 
 	static bool checkDeviceExtensionSupport(VkPhysicalDevice device, const std::vector<const char*> &requiredExtensions);
 
+	std::vector<const char*> getRequiredExtensions() const;
+
 	void createDevice(const std::vector<const char*> &layers);
 
-	void createCommandPool();
+	void createCommandPools();
+
+	// cache file is unique for vendor, device and driver (pipeline cache UUID)
+	std::string getPipelineCachePath() const;
+
+	void createPipelineCache();
+
+	// returns false if cache file can't be written (e.g. read only directory)
+	bool savePipelineCache() const;
+
+	VkCommandBuffer beginCommands(VkCommandPool pool) const;
+
+	void submitCommands(VkCommandBuffer commandBuffer, VkQueue queue, VkCommandPool pool) const;
+
+	// makes next batched commands wait for transfers of previous ones
+	static void recordBatchBarrier(VkCommandBuffer commandBuffer);
 };
 
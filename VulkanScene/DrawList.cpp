@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <functional>
+#include "Model.h"
+
+#include "DrawList.h"
+
+// public:
+
+uint32_t DrawList::Statistics::getBindCount() const
+{
+	return pipelineBindCount + descriptorSetBindCount + geometryBindCount;
+}
+
+DrawList::Statistics& DrawList::Statistics::operator+=(const Statistics &other)
+{
+	drawCount += other.drawCount;
+	pipelineBindCount += other.pipelineBindCount;
+	descriptorSetBindCount += other.descriptorSetBindCount;
+	geometryBindCount += other.geometryBindCount;
+
+	return *this;
+}
+
+void DrawList::add(const Item &item)
+{
+	items.push_back(item);
+}
+
+void DrawList::sort(Order order)
+{
+	std::sort(items.begin(), items.end(), [order](const Item &a, const Item &b)
+	{
+		if (order == BACK_TO_FRONT && a.distance != b.distance)
+		{
+			return a.distance > b.distance;
+		}
+		if (a.pipeline != b.pipeline)
+		{
+			return std::less<GraphicsPipeline*>()(a.pipeline, b.pipeline);
+		}
+		if (a.materialDescriptorSet != b.materialDescriptorSet)
+		{
+			return std::less<VkDescriptorSet>()(a.materialDescriptorSet, b.materialDescriptorSet);
+		}
+		if (a.model != b.model)
+		{
+			return std::less<const Model*>()(a.model, b.model);
+		}
+
+		return order == FRONT_TO_BACK && a.distance < b.distance;
+	});
+}
+
+void DrawList::render(
+	VkCommandBuffer commandBuffer,
+	const std::vector<VkDescriptorSet> &descriptorSets,
+	const std::vector<uint32_t> &dynamicOffsets,
+	const std::vector<VkPushConstantRange> &pushConstantRanges,
+	const std::vector<const void *> &pushConstantData,
+	uint32_t frameIndex)
+{
+	GraphicsPipeline *boundPipeline = nullptr;
+	VkDescriptorSet boundMaterialDescriptorSet = VK_NULL_HANDLE;
+	const Model *boundModel = nullptr;
+
+	for (const auto &item : items)
+	{
+		const VkPipelineLayout layout = item.pipeline->getLayout();
+
+		if (item.pipeline != boundPipeline)
+		{
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, item.pipeline->get());
+			statistics.pipelineBindCount++;
+
+			if (!boundPipeline)
+			{
+				for (uint32_t i = 0; i < pushConstantRanges.size(); i++)
+				{
+					vkCmdPushConstants(
+						commandBuffer,
+						layout,
+						pushConstantRanges[i].stageFlags,
+						pushConstantRanges[i].offset,
+						pushConstantRanges[i].size,
+						pushConstantData[i]);
+				}
+
+				vkCmdBindDescriptorSets(
+					commandBuffer,
+					VK_PIPELINE_BIND_POINT_GRAPHICS,
+					layout,
+					0,
+					uint32_t(descriptorSets.size()),
+					descriptorSets.data(),
+					uint32_t(dynamicOffsets.size()),
+					dynamicOffsets.data());
+				statistics.descriptorSetBindCount++;
+			}
+
+			boundPipeline = item.pipeline;
+		}
+
+		if (item.materialDescriptorSet != boundMaterialDescriptorSet)
+		{
+			vkCmdBindDescriptorSets(
+				commandBuffer,
+				VK_PIPELINE_BIND_POINT_GRAPHICS,
+				layout,
+				uint32_t(descriptorSets.size()),
+				1,
+				&item.materialDescriptorSet,
+				0,
+				nullptr);
+			statistics.descriptorSetBindCount++;
+
+			boundMaterialDescriptorSet = item.materialDescriptorSet;
+		}
+
+		if (item.model != boundModel)
+		{
+			item.model->bindGeometry(commandBuffer);
+			statistics.geometryBindCount++;
+
+			boundModel = item.model;
+		}
+
+		item.model->renderDraw(commandBuffer, layout, item.drawIndex, item.viewIndex, frameIndex);
+		statistics.drawCount++;
+	}
+
+	items.clear();
+}
+
+DrawList::Statistics DrawList::getStatistics() const
+{
+	return statistics;
+}
+
+void DrawList::resetStatistics()
+{
+	statistics = {};
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "GraphicsPipeline.h"
+
+class Model;
+
+// draw items of meshes of all models rendered by pass, they are sorted by state
+// (pipeline, material descriptor set and geometry of model), so each state is bound only when it changes
+class DrawList
+{
+public:
+	struct Item
+	{
+		GraphicsPipeline *pipeline;
+
+		VkDescriptorSet materialDescriptorSet;
+
+		// owner of geometry arena and instance buffer of mesh
+		const Model *model;
+
+		// mesh of model (or draw group of model with GPU culling)
+		uint32_t drawIndex;
+
+		uint32_t viewIndex;
+
+		// distance from camera to the nearest instance of mesh (not used by state order)
+		float distance;
+	};
+
+	enum Order
+	{
+		// only by state, depth pass has no use of distance
+		STATE,
+
+		// opaque meshes, occluders are drawn first to reject hidden fragments early,
+		// distance is secondary key, so state changes stay minimal
+		FRONT_TO_BACK,
+
+		// transparent meshes are blended, so distance is primary key and state is secondary
+		BACK_TO_FRONT
+	};
+
+	// commands recorded since last reset
+	struct Statistics
+	{
+		uint32_t drawCount;
+
+		uint32_t pipelineBindCount;
+
+		uint32_t descriptorSetBindCount;
+
+		// vertex streams, indices and instances of model
+		uint32_t geometryBindCount;
+
+		uint32_t getBindCount() const;
+
+		Statistics& operator+=(const Statistics &other);
+	};
+
+	void add(const Item &item);
+
+	// sorts items by pipeline, material descriptor set, model and distance in the given order
+	void sort(Order order);
+
+	// pipelines of models have compatible layouts, so global descriptor sets and push constants of pass
+	// are bound once and stay valid when pipeline changes, list is cleared after recording
+	void render(
+		VkCommandBuffer commandBuffer,
+		const std::vector<VkDescriptorSet> &descriptorSets,
+		const std::vector<uint32_t> &dynamicOffsets,
+		const std::vector<VkPushConstantRange> &pushConstantRanges,
+		const std::vector<const void *> &pushConstantData,
+		uint32_t frameIndex);
+
+	Statistics getStatistics() const;
+
+	void resetStatistics();
+
+private:
+	std::vector<Item> items;
+
+	Statistics statistics{};
+};
@@ -1,3 +1,5 @@
+#include <stdexcept>
+#include <chrono>
 #include "ShaderModule.h"
 #include "AssimpModel.h"
 #include "FinalRenderPass.h"
@@ -5,70 +7,78 @@
 #include "GeometryRenderPass.h"
 #include "LightingRenderPass.h"
 #include "SsaoRenderPass.h"
+#include "OffscreenTarget.h"
+#include "CpuProfiler.h"
+#include "TextureCache.h"
+#include "TextureStreamer.h"
 
 #include "Engine.h"
 
 // public:
 
+#ifdef _WIN32
 Engine::Engine(HWND hWnd, VkExtent2D frameExtent, Settings settings)
 {
-	const std::string validationLayer = "VK_LAYER_LUNARG_standard_validation";
-    std::vector<const char*> requiredLayers;
-#ifdef _DEBUG 
-	requiredLayers.push_back(validationLayer.c_str());
-#endif
+	const auto startTime = std::chrono::steady_clock::now();
 
 	const std::vector<const char*> extensions{
 		VK_KHR_SURFACE_EXTENSION_NAME,
         "VK_KHR_win32_surface"
 	};
 
-	instance = new Instance(requiredLayers, extensions);
+	setFrameCount(settings.frameCount);
+
+	instance = new Instance(getRequiredLayers(), extensions);
 	surface = new Surface(instance->get(), hWnd);
-	device = new Device(instance->get(), surface->get(), requiredLayers, settings.sampleCount);
+	device = new Device(instance->get(), surface->get(), getRequiredLayers(), settings.sampleCount);
 	swapChain = new SwapChain(device, surface->get(), frameExtent);
+	renderTarget = swapChain;
 
-	createRenderPasses(settings.shadowsDim);
-
-	scene = new Scene(device, swapChain->getExtent(), settings.scenePath);
-	descriptorPool = new DescriptorPool(
-        device,
-        scene->getBufferCount(),
-        scene->getTextureCount(),
-        scene->getDescriptorSetCount());
+	init(settings, startTime);
+}
+#endif
 
-	scene->prepareSceneRendering(descriptorPool, renderPasses);
+Engine::Engine(VkExtent2D frameExtent, uint32_t targetImageCount, Settings settings)
+{
+	const auto startTime = std::chrono::steady_clock::now();
 
-	imageAvailableSemaphore = nullptr;
-	createSemaphore(device->get(), imageAvailableSemaphore);
+	setFrameCount(settings.frameCount);
 
-	stageFinishedSemaphores.resize(renderPasses.size(), nullptr);
-    for (auto &semaphore : stageFinishedSemaphores)
-    {
-		createSemaphore(device->get(), semaphore);
-    }
+	// no window system extensions are required
+	instance = new Instance(getRequiredLayers(), {});
+	device = new Device(instance->get(), nullptr, getRequiredLayers(), settings.sampleCount);
+	renderTarget = new OffscreenTarget(device, frameExtent, targetImageCount);
 
-	initGraphicsCommands();
+	init(settings, startTime);
 }
 
 Engine::~Engine()
 {
 	vkDeviceWaitIdle(device->get());
-	vkDestroySemaphore(device->get(), imageAvailableSemaphore, nullptr);
-    for (auto semaphore : stageFinishedSemaphores)
-    {
-		vkDestroySemaphore(device->get(), semaphore, nullptr);
-    }
+	for (auto &frame : frames)
+	{
+		vkDestroyCommandPool(device->get(), frame.commandPool, nullptr);
+		vkDestroyFence(device->get(), frame.fence, nullptr);
+		vkDestroySemaphore(device->get(), frame.imageAvailableSemaphore, nullptr);
+		for (auto semaphore : frame.stageFinishedSemaphores)
+		{
+			vkDestroySemaphore(device->get(), semaphore, nullptr);
+		}
+		delete frame.readbackBuffer;
+	}
 
+    delete gpuProfiler;
     delete scene;
     delete descriptorPool;
     for (auto [type, renderPass] : renderPasses)
     {
         delete renderPass;
     }
-    delete swapChain;
+    delete renderTarget;
     delete device;
+#ifdef _WIN32
     delete surface;
+#endif
     delete instance;
 }
 
@@ -82,29 +92,169 @@ Camera* Engine::getCamera() const
 	return scene->getCamera();
 }
 
+void Engine::setReadbackCallback(ReadbackCallback callback)
+{
+	if (swapChain)
+	{
+		throw std::logic_error("Readback is available only for offscreen rendering");
+	}
+
+	waitIdle();
+
+	readbackCallback = callback;
+	createReadbackBuffers();
+
+	// readback copies are recorded with final render pass
+	initGraphicsCommands();
+}
+
+void Engine::waitIdle()
+{
+	vkDeviceWaitIdle(device->get());
+
+	for (uint32_t i = 0; i < frameCount; i++)
+	{
+		deliverReadback(frames[i]);
+		if (gpuProfiler)
+		{
+			gpuProfiler->collect(i);
+		}
+	}
+}
+
+double Engine::getLastWaitTime() const
+{
+	return lastWaitTime;
+}
+
+double Engine::getModelsLoadingTime() const
+{
+	return scene->getModelsLoadingTime();
+}
+
+Engine::StartupStatistics Engine::getStartupStatistics() const
+{
+	return startupStatistics;
+}
+
+void Engine::enableGpuProfiler(bool pipelineStatistics, const std::string &tracePath)
+{
+	waitIdle();
+
+	delete gpuProfiler;
+	gpuProfiler = new GpuProfiler(
+		device,
+		frameCount,
+		renderPasses.at(DEPTH)->getRenderCount(),
+		pipelineStatistics,
+		tracePath);
+
+	// queries are written by recorded commands
+	initGraphicsCommands();
+}
+
+GpuProfiler* Engine::getGpuProfiler() const
+{
+	return gpuProfiler;
+}
+
+uint64_t Engine::getFrameNumber() const
+{
+	return frameNumber;
+}
+
+uint64_t Engine::getWaitIdleCount() const
+{
+	return device->getWaitIdleCount();
+}
+
+std::vector<uint32_t> Engine::getSavedCascadeDraws() const
+{
+	return scene->getSavedCascadeDraws();
+}
+
+DrawList::Statistics Engine::getDrawStatistics() const
+{
+	return scene->getDrawStatistics();
+}
+
 void Engine::drawFrame()
 {
-	scene->updateScene();
+	const CpuProfiler::Scope profilerScope("Engine::drawFrame");
+
+	FrameResources &frame = frames[frameIndex];
+
+	// wait until GPU finishes previous frame with this index,
+	// after that uniform slices and commands of this frame can be reused
+	const auto waitStartTime = std::chrono::steady_clock::now();
+	VkResult result;
+	{
+		const CpuProfiler::Scope waitScope("Engine::waitForFrameFence");
+		result = vkWaitForFences(device->get(), 1, &frame.fence, VK_TRUE, UINT64_MAX);
+	}
+	assert(result == VK_SUCCESS);
+	lastWaitTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStartTime).count();
+
+	// pixels and queries of previous frame with this index are ready
+	deliverReadback(frame);
+	if (gpuProfiler)
+	{
+		gpuProfiler->collect(frameIndex);
+	}
+
+	scene->updateScene(frameIndex);
 
 	if (minimized) return;
 
-	uint32_t imageIndex;
-    VkResult result = vkAcquireNextImageKHR(
-        device->get(),
-        swapChain->get(),
-        UINT64_MAX,
-        imageAvailableSemaphore,
-        nullptr,
-        &imageIndex);
+	// visible instances are changed by scene update, so commands which render them are recorded again
+	for (const auto &[type, commandBuffers] : frame.commands)
+	{
+		if (type != FINAL && scene->dependsOnCulling(type))
+		{
+			recordCommands(commandBuffers[0], type, 0, frameIndex);
+		}
+	}
 
-	if (result == VK_ERROR_OUT_OF_DATE_KHR)
+	uint32_t imageIndex = targetImageIndex;
+	if (swapChain)
 	{
-		resize(swapChain->getExtent());
-		return;
+		result = vkAcquireNextImageKHR(
+			device->get(),
+			swapChain->get(),
+			UINT64_MAX,
+			frame.imageAvailableSemaphore,
+			nullptr,
+			&imageIndex);
+
+		if (result == VK_ERROR_OUT_OF_DATE_KHR)
+		{
+			resize(renderTarget->getExtent());
+			return;
+		}
+		assert(result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR);
+	}
+	else
+	{
+		// offscreen images are used in turn
+		targetImageIndex = (targetImageIndex + 1) % renderTarget->getImageCount();
+	}
+
+	const bool texturesUploaded = updateTextureStreaming(frameIndex);
+
+	if (scene->dependsOnCulling(FINAL))
+	{
+		recordCommands(frame.commands.at(FINAL)[imageIndex], FINAL, imageIndex, frameIndex);
 	}
-    assert(result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR);
+
+	const std::vector<VkSemaphore> &stageFinishedSemaphores = frame.stageFinishedSemaphores;
 
     // Depth:
+	// uploads of streamed textures are submitted first, so render passes sample new images after them
+	std::vector<VkCommandBuffer> depthCommandBuffers{ frame.commands.at(DEPTH)[0] };
+	if (texturesUploaded)
+	{
+		depthCommandBuffers.insert(depthCommandBuffers.begin(), frame.streamingCommandBuffer);
+	}
 	std::vector<VkSemaphore> signalSemaphores{ stageFinishedSemaphores[DEPTH] };
 	VkSubmitInfo submitInfo{
 		VK_STRUCTURE_TYPE_SUBMIT_INFO,
@@ -112,8 +262,8 @@ void Engine::drawFrame()
 		0,
 		nullptr,
 		nullptr,
-		1,
-		&graphicsCommands.at(DEPTH)[0],
+		uint32_t(depthCommandBuffers.size()),
+		depthCommandBuffers.data(),
 		uint32_t(signalSemaphores.size()),
 		signalSemaphores.data(),
 	};
@@ -129,7 +279,7 @@ void Engine::drawFrame()
 		nullptr,
 		nullptr,
 		1,
-		&graphicsCommands.at(GEOMETRY)[0],
+		&frame.commands.at(GEOMETRY)[0],
 		uint32_t(signalSemaphores.size()),
 		signalSemaphores.data(),
 	};
@@ -147,7 +297,7 @@ void Engine::drawFrame()
 		waitSemaphores.data(),
 		waitStages.data(),
 		1,
-		&graphicsCommands.at(SSAO)[0],
+		&frame.commands.at(SSAO)[0],
 		uint32_t(signalSemaphores.size()),
 		signalSemaphores.data(),
 	};
@@ -165,7 +315,7 @@ void Engine::drawFrame()
 		waitSemaphores.data(),
 		waitStages.data(),
 		1,
-		&graphicsCommands.at(SSAO_BLUR)[0],
+		&frame.commands.at(SSAO_BLUR)[0],
 		uint32_t(signalSemaphores.size()),
 		signalSemaphores.data(),
 	};
@@ -183,17 +333,23 @@ void Engine::drawFrame()
 		waitSemaphores.data(),
 		waitStages.data(),
 		1,
-		&graphicsCommands.at(LIGHTING)[0],
+		&frame.commands.at(LIGHTING)[0],
 		uint32_t(signalSemaphores.size()),
 		signalSemaphores.data(),
 	};
 	result = vkQueueSubmit(device->getGraphicsQueue(), 1, &submitInfo, nullptr);
 	assert(result == VK_SUCCESS);
 
-    // Final:
-	waitSemaphores = { stageFinishedSemaphores[LIGHTING], imageAvailableSemaphore };
-	waitStages = { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-	signalSemaphores = { stageFinishedSemaphores[FINAL] };
+    // Final (offscreen image isn't presented, so nobody waits for it):
+	waitSemaphores = { stageFinishedSemaphores[LIGHTING] };
+	waitStages = { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT };
+	signalSemaphores = {};
+	if (swapChain)
+	{
+		waitSemaphores.push_back(frame.imageAvailableSemaphore);
+		waitStages.push_back(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+		signalSemaphores.push_back(stageFinishedSemaphores[FINAL]);
+	}
 	submitInfo = {
 		VK_STRUCTURE_TYPE_SUBMIT_INFO,
 		nullptr,
@@ -201,13 +357,29 @@ void Engine::drawFrame()
 		waitSemaphores.data(),
 		waitStages.data(),
 		1,
-		&graphicsCommands.at(FINAL)[imageIndex],
+		&frame.commands.at(FINAL)[imageIndex],
 		uint32_t(signalSemaphores.size()),
 		signalSemaphores.data(),
 	};
-	result = vkQueueSubmit(device->getGraphicsQueue(), 1, &submitInfo, nullptr);
+	result = vkResetFences(device->get(), 1, &frame.fence);
+	assert(result == VK_SUCCESS);
+	result = vkQueueSubmit(device->getGraphicsQueue(), 1, &submitInfo, frame.fence);
 	assert(result == VK_SUCCESS);
 
+	frame.readbackPending = frame.readbackBuffer != nullptr;
+	if (gpuProfiler)
+	{
+		gpuProfiler->markSubmitted(frameIndex, frameNumber);
+	}
+	frameNumber++;
+
+	frameIndex = (frameIndex + 1) % frameCount;
+
+	if (!swapChain)
+	{
+		return;
+	}
+
 	std::vector<VkSwapchainKHR> swapChains{ swapChain->get() };
 	VkPresentInfoKHR presentInfo{
 		VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
@@ -223,7 +395,7 @@ void Engine::drawFrame()
 	result = vkQueuePresentKHR(device->getPresentQueue(), &presentInfo);
 	if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
 	{
-		resize(swapChain->getExtent());
+		resize(renderTarget->getExtent());
 	}
 	else
 	{
@@ -235,20 +407,25 @@ void Engine::resize(VkExtent2D newExtent)
 {
 	if (!minimized)
 	{
-		vkDeviceWaitIdle(device->get());
+		waitIdle();
 
-		swapChain->recreate(newExtent);
+		renderTarget->recreate(newExtent);
 
 		for (auto [type, renderPass] : renderPasses)
 		{
 			if (type != DEPTH)
 			{
-				renderPass->recreate(swapChain->getExtent());
+				renderPass->recreate(renderTarget->getExtent());
 			}
 		}
 
 		scene->updateDescriptorSets(descriptorPool, renderPasses);
-		scene->resizeExtent(swapChain->getExtent());
+		scene->resizeExtent(renderTarget->getExtent());
+
+		if (readbackCallback)
+		{
+			createReadbackBuffers();
+		}
 
 		initGraphicsCommands();
 	}
@@ -256,16 +433,97 @@ void Engine::resize(VkExtent2D newExtent)
 
 // private:
 
+std::vector<const char*> Engine::getRequiredLayers()
+{
+    std::vector<const char*> requiredLayers;
+#ifdef _DEBUG 
+	requiredLayers.push_back("VK_LAYER_LUNARG_standard_validation");
+#endif
+
+	return requiredLayers;
+}
+
+void Engine::setFrameCount(uint32_t frameCount)
+{
+	if (frameCount < 1 || frameCount > 3)
+	{
+		throw std::invalid_argument("Frame count must be from 1 to 3");
+	}
+	this->frameCount = frameCount;
+}
+
+void Engine::init(Settings settings, std::chrono::steady_clock::time_point startTime)
+{
+	const CpuProfiler::Scope profilerScope("Engine::init");
+
+	createRenderPasses(settings.shadowsDim);
+
+	// only tail levels of streamed textures are uploaded while scene is loaded
+	if (settings.textureStreamingBudget > 0)
+	{
+		device->enableTextureStreaming(settings.textureStreamingBudget, frameCount);
+	}
+
+	// all uploads of scene loading are submitted together
+	device->beginUploadBatch();
+
+	scene = new Scene(
+		device,
+		renderTarget->getExtent(),
+		settings.scenePath,
+		frameCount,
+		settings.gpuCulling,
+		settings.loadingThreadCount);
+	descriptorPool = new DescriptorPool(
+        device,
+        scene->getBufferCount(),
+        scene->getDynamicBufferCount(),
+        scene->getTextureCount(),
+        scene->getStorageBufferCount(),
+        scene->getDescriptorSetCount());
+
+	// pipelines are created here, so its time depends on pipeline cache state
+	const auto preparingStartTime = std::chrono::steady_clock::now();
+	scene->prepareSceneRendering(descriptorPool, renderPasses);
+	const auto preparingTime = std::chrono::steady_clock::now() - preparingStartTime;
+
+	device->endUploadBatch();
+
+	// staging memory used for loading isn't needed anymore
+	device->getMemoryAllocator()->releaseEmptyBlocks();
+
+	createFrames();
+	initGraphicsCommands();
+
+	const TextureCache::Statistics textureCacheStatistics = device->getTextureCache()->getStatistics();
+
+	using milliseconds = std::chrono::duration<double, std::milli>;
+	startupStatistics.startupTime = milliseconds(std::chrono::steady_clock::now() - startTime).count();
+	startupStatistics.modelsLoadingTime = scene->getModelsLoadingTime();
+	startupStatistics.preparingTime = milliseconds(preparingTime).count();
+	startupStatistics.pipelineCacheLoaded = device->isPipelineCacheLoaded();
+	startupStatistics.textureMemory = TextureImage::getTotalMemorySize();
+	startupStatistics.textureCacheHits = textureCacheStatistics.hits;
+	startupStatistics.textureCacheMisses = textureCacheStatistics.misses;
+	startupStatistics.textureCacheSavedBytes = textureCacheStatistics.savedBytes;
+	if (device->getTextureStreamer())
+	{
+		startupStatistics.streamedTextureCount = device->getTextureStreamer()->getStatistics().textureCount;
+	}
+	startupStatistics.memory = device->getMemoryAllocator()->getStats();
+	startupStatistics.staticBufferSize = Buffer::getTotalStaticSize();
+}
+
 void Engine::createRenderPasses(uint32_t shadowsDim)
 {
 	const VkExtent2D depthTextureExtent = { shadowsDim, shadowsDim };
 
 	renderPasses.insert({ DEPTH, new DepthRenderPass(device, depthTextureExtent) });
-	renderPasses.insert({ GEOMETRY, new GeometryRenderPass(device, swapChain->getExtent()) });
-	renderPasses.insert({ SSAO, new SsaoRenderPass(device, swapChain->getExtent()) });
-	renderPasses.insert({ SSAO_BLUR, new SsaoRenderPass(device, swapChain->getExtent()) });
-	renderPasses.insert({ LIGHTING, new LightingRenderPass(device, swapChain) });
-	renderPasses.insert({ FINAL, new FinalRenderPass(device, swapChain) });
+	renderPasses.insert({ GEOMETRY, new GeometryRenderPass(device, renderTarget->getExtent()) });
+	renderPasses.insert({ SSAO, new SsaoRenderPass(device, renderTarget->getExtent()) });
+	renderPasses.insert({ SSAO_BLUR, new SsaoRenderPass(device, renderTarget->getExtent()) });
+	renderPasses.insert({ LIGHTING, new LightingRenderPass(device, renderTarget) });
+	renderPasses.insert({ FINAL, new FinalRenderPass(device, renderTarget) });
 
     for (auto [type, renderPass] : renderPasses)
     {
@@ -279,76 +537,205 @@ void Engine::createRenderPasses(uint32_t shadowsDim)
     }
 }
 
-void Engine::initGraphicsCommands()
+void Engine::createFrames()
 {
-    if (graphicsCommands.empty())
-    {
-		for (auto[type, renderPass] : renderPasses)
+	frames.resize(frameCount);
+
+	for (auto &frame : frames)
+	{
+		frame.commandPool = nullptr;
+		createCommandPool(device, frame.commandPool);
+
+		for (auto [type, renderPass] : renderPasses)
 		{
-			graphicsCommands.insert({ type, {} });
+			frame.commands.insert({ type, {} });
 		}
-    }
 
-    const VkCommandPool commandPool = device->getCommandPool();
+		frame.fence = nullptr;
+		createFence(device->get(), frame.fence);
 
-    for (auto &[type, commandBuffers] : graphicsCommands)
-    {
-		if (!commandBuffers.empty())
+		frame.imageAvailableSemaphore = nullptr;
+		createSemaphore(device->get(), frame.imageAvailableSemaphore);
+
+		frame.stageFinishedSemaphores.resize(renderPasses.size(), nullptr);
+		for (auto &semaphore : frame.stageFinishedSemaphores)
 		{
-			vkFreeCommandBuffers(device->get(), commandPool, uint32_t(commandBuffers.size()), commandBuffers.data());
+			createSemaphore(device->get(), semaphore);
 		}
 
-		uint32_t size = 1;
-        if (type == FINAL)
-        {
-			size = swapChain->getImageCount();
-        }
-		commandBuffers.resize(size);
+		if (device->getTextureStreamer())
+		{
+			VkCommandBufferAllocateInfo allocInfo{
+				VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+				nullptr,
+				frame.commandPool,
+				VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+				1,
+			};
+
+			const VkResult result = vkAllocateCommandBuffers(device->get(), &allocInfo, &frame.streamingCommandBuffer);
+			assert(result == VK_SUCCESS);
+		}
+	}
+}
 
-		VkCommandBufferAllocateInfo allocInfo{
-		    VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-		    nullptr,
-		    commandPool,
-		    VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-		    size,
-		};
+void Engine::initGraphicsCommands()
+{
+	for (uint32_t frame = 0; frame < frameCount; frame++)
+	{
+		const VkCommandPool commandPool = frames[frame].commandPool;
 
-		VkResult result = vkAllocateCommandBuffers(device->get(), &allocInfo, commandBuffers.data());
-		assert(result == VK_SUCCESS);
+		for (auto &[type, commandBuffers] : frames[frame].commands)
+		{
+			if (!commandBuffers.empty())
+			{
+				vkFreeCommandBuffers(device->get(), commandPool, uint32_t(commandBuffers.size()), commandBuffers.data());
+			}
 
-		VkCommandBufferBeginInfo beginInfo{
-			VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-			nullptr,
-			VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
-			nullptr,
-		};
+			uint32_t size = 1;
+			if (type == FINAL)
+			{
+				size = renderTarget->getImageCount();
+			}
+			commandBuffers.resize(size);
 
-        for (uint32_t i = 0; i < size; i++)
-        {
-			result = vkBeginCommandBuffer(commandBuffers[i], &beginInfo);
+			VkCommandBufferAllocateInfo allocInfo{
+				VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+				nullptr,
+				commandPool,
+				VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+				size,
+			};
+
+			const VkResult result = vkAllocateCommandBuffers(device->get(), &allocInfo, commandBuffers.data());
 			assert(result == VK_SUCCESS);
 
-			recordRenderPassCommands(type, i, renderPasses.at(type)->getRenderCount());
+			for (uint32_t i = 0; i < size; i++)
+			{
+				recordCommands(commandBuffers[i], type, i, frame);
+			}
+		}
+	}
+}
+
+bool Engine::updateTextureStreaming(uint32_t frameIndex)
+{
+	TextureStreamer *textureStreamer = device->getTextureStreamer();
+	if (!textureStreamer)
+	{
+		return false;
+	}
 
-			result = vkEndCommandBuffer(commandBuffers[i]);
-			assert(result == VK_SUCCESS);
-        }
-    }
+	FrameResources &frame = frames[frameIndex];
+
+	scene->requestTextures(textureStreamer);
+
+	VkCommandBufferBeginInfo beginInfo{
+		VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+		nullptr,
+		VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+		nullptr,
+	};
+
+	VkResult result = vkBeginCommandBuffer(frame.streamingCommandBuffer, &beginInfo);
+	assert(result == VK_SUCCESS);
+
+	const bool uploaded = textureStreamer->update(frame.streamingCommandBuffer);
+
+	result = vkEndCommandBuffer(frame.streamingCommandBuffer);
+	assert(result == VK_SUCCESS);
+
+	// descriptor sets of other frames are updated when their fences are signaled,
+	// commands which bind updated descriptor sets are invalidated, so all commands of this frame are recorded again
+	if (frame.textureReplacementCount != textureStreamer->getReplacementCount())
+	{
+		frame.textureReplacementCount = textureStreamer->getReplacementCount();
+
+		scene->updateMaterialDescriptorSets(frameIndex);
+		for (const auto &[type, commandBuffers] : frame.commands)
+		{
+			for (uint32_t i = 0; i < commandBuffers.size(); i++)
+			{
+				recordCommands(commandBuffers[i], type, i, frameIndex);
+			}
+		}
+	}
+
+	return uploaded;
+}
+
+void Engine::recordCommands(VkCommandBuffer commandBuffer, RenderPassType type, uint32_t framebufferIndex, uint32_t frameIndex)
+{
+	// commands of one frame are never pending twice, because frame waits for its fence
+	VkCommandBufferBeginInfo beginInfo{
+		VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+		nullptr,
+		0,
+		nullptr,
+	};
+
+	VkResult result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+	assert(result == VK_SUCCESS);
+
+	// time of depth pass includes GPU culling
+	if (gpuProfiler)
+	{
+		gpuProfiler->recordPassBegin(commandBuffer, type, frameIndex);
+	}
+
+	// depth pass is submitted first, so culling results are ready for all render passes
+	if (type == DEPTH)
+	{
+		scene->recordCulling(commandBuffer, frameIndex);
+	}
+
+	recordRenderPassCommands(commandBuffer, type, framebufferIndex, renderPasses.at(type)->getRenderCount(), frameIndex);
+
+	if (gpuProfiler)
+	{
+		gpuProfiler->recordPassEnd(commandBuffer, type, frameIndex);
+	}
+
+	if (type == FINAL && frames[frameIndex].readbackBuffer)
+	{
+		recordReadback(commandBuffer, framebufferIndex, frames[frameIndex].readbackBuffer);
+	}
+
+	result = vkEndCommandBuffer(commandBuffer);
+	assert(result == VK_SUCCESS);
 }
 
-void Engine::recordRenderPassCommands(RenderPassType type, uint32_t commandBufferIndex, uint32_t renderCount)
+void Engine::recordRenderPassCommands(
+	VkCommandBuffer commandBuffer,
+	RenderPassType type,
+	uint32_t framebufferIndex,
+	uint32_t renderCount,
+	uint32_t frameIndex)
 {
+	// each render of depth pass is cascade of shadow map
+	const bool cascadesProfiled = gpuProfiler && type == DEPTH;
+
 	for (uint32_t i = 0; i < renderCount; i++)
 	{
-		beginRenderPass(type, commandBufferIndex, commandBufferIndex + i);
+		if (cascadesProfiled)
+		{
+			gpuProfiler->recordCascadeBegin(commandBuffer, i, frameIndex);
+		}
+
+		beginRenderPass(commandBuffer, type, framebufferIndex + i);
 
-		scene->render(graphicsCommands.at(type)[commandBufferIndex], type, i);
+		scene->render(commandBuffer, type, i, frameIndex);
 
-		vkCmdEndRenderPass(graphicsCommands.at(type)[commandBufferIndex]);
+		vkCmdEndRenderPass(commandBuffer);
+
+		if (cascadesProfiled)
+		{
+			gpuProfiler->recordCascadeEnd(commandBuffer, i, frameIndex);
+		}
 	}
 }
 
-void Engine::beginRenderPass(RenderPassType type, uint32_t commandBufferIndex, uint32_t framebufferIndex)
+void Engine::beginRenderPass(VkCommandBuffer commandBuffer, RenderPassType type, uint32_t framebufferIndex)
 {
 	const VkRect2D renderArea{
 		{ 0, 0 },
@@ -367,7 +754,131 @@ void Engine::beginRenderPass(RenderPassType type, uint32_t commandBufferIndex, u
 		clearValues.data()
 	};
 
-	vkCmdBeginRenderPass(graphicsCommands.at(type)[commandBufferIndex], &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+	// all pipelines use dynamic viewport and scissor
+	const VkViewport viewport{
+		0,
+		0,
+		float(renderArea.extent.width),
+		float(renderArea.extent.height),
+		0,
+		1
+	};
+
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	vkCmdSetScissor(commandBuffer, 0, 1, &renderArea);
+}
+
+void Engine::createReadbackBuffers()
+{
+	// buffers are deleted if readback is disabled
+	const auto target = dynamic_cast<OffscreenTarget*>(renderTarget);
+	const VkExtent2D extent = target->getExtent();
+	const VkDeviceSize size = VkDeviceSize(extent.width) * extent.height * target->getPixelSize();
+
+	for (auto &frame : frames)
+	{
+		delete frame.readbackBuffer;
+		frame.readbackBuffer = nullptr;
+		frame.readbackPending = false;
+
+		if (readbackCallback)
+		{
+			frame.readbackBuffer = new Buffer(device, VK_BUFFER_USAGE_TRANSFER_DST_BIT, size, Buffer::DYNAMIC);
+		}
+	}
+}
+
+void Engine::recordReadback(VkCommandBuffer commandBuffer, uint32_t imageIndex, Buffer *readbackBuffer) const
+{
+	const auto target = dynamic_cast<OffscreenTarget*>(renderTarget);
+	const VkExtent2D extent = target->getExtent();
+
+	const VkImageSubresourceRange subresourceRange{
+		VK_IMAGE_ASPECT_COLOR_BIT,
+		0,
+		1,
+		0,
+		1,
+	};
+
+	// final render pass leaves image in transfer source layout
+	const VkImageMemoryBarrier imageBarrier{
+		VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+		nullptr,
+		VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+		VK_ACCESS_TRANSFER_READ_BIT,
+		VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		VK_QUEUE_FAMILY_IGNORED,
+		VK_QUEUE_FAMILY_IGNORED,
+		target->getImage(imageIndex),
+		subresourceRange
+	};
+
+	vkCmdPipelineBarrier(
+		commandBuffer,
+		VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0,
+		0,
+		nullptr,
+		0,
+		nullptr,
+		1,
+		&imageBarrier);
+
+	const VkBufferImageCopy region{
+		0,
+		0,
+		0,
+		{ VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 },
+		{ 0, 0, 0 },
+		{ extent.width, extent.height, 1 }
+	};
+
+	vkCmdCopyImageToBuffer(
+		commandBuffer,
+		target->getImage(imageIndex),
+		VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		readbackBuffer->get(),
+		1,
+		&region);
+
+	// host reads buffer after frame fence is signaled
+	const VkBufferMemoryBarrier bufferBarrier{
+		VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+		nullptr,
+		VK_ACCESS_TRANSFER_WRITE_BIT,
+		VK_ACCESS_HOST_READ_BIT,
+		VK_QUEUE_FAMILY_IGNORED,
+		VK_QUEUE_FAMILY_IGNORED,
+		readbackBuffer->get(),
+		0,
+		VK_WHOLE_SIZE
+	};
+
+	vkCmdPipelineBarrier(
+		commandBuffer,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_HOST_BIT,
+		0,
+		0,
+		nullptr,
+		1,
+		&bufferBarrier,
+		0,
+		nullptr);
+}
+
+void Engine::deliverReadback(FrameResources &frame)
+{
+	if (frame.readbackPending)
+	{
+		frame.readbackPending = false;
+		readbackCallback(reinterpret_cast<const uint8_t*>(frame.readbackBuffer->getMappedData()), renderTarget->getExtent());
+	}
 }
 
 void Engine::createSemaphore(VkDevice device, VkSemaphore &semaphore)
@@ -387,7 +898,38 @@ void Engine::createSemaphore(VkDevice device, VkSemaphore &semaphore)
 	assert(result == VK_SUCCESS);
 }
 
+void Engine::createFence(VkDevice device, VkFence &fence)
+{
+	if (fence)
+	{
+		vkDestroyFence(device, fence, nullptr);
+	}
 
+	// fence is created signaled so first wait for it doesn't block
+	VkFenceCreateInfo createInfo{
+		VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+		nullptr,
+		VK_FENCE_CREATE_SIGNALED_BIT,
+	};
 
+	const VkResult result = vkCreateFence(device, &createInfo, nullptr, &fence);
+	assert(result == VK_SUCCESS);
+}
 
+void Engine::createCommandPool(Device *device, VkCommandPool &commandPool)
+{
+	if (commandPool)
+	{
+		vkDestroyCommandPool(device->get(), commandPool, nullptr);
+	}
 
+	VkCommandPoolCreateInfo createInfo{
+		VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+		nullptr,
+		VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+		device->getQueueFamilyIndices().getGraphics()
+	};
+
+	const VkResult result = vkCreateCommandPool(device->get(), &createInfo, nullptr, &commandPool);
+	assert(result == VK_SUCCESS);
+}
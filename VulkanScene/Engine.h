@@ -1,21 +1,64 @@
 #pragma once
 
 #include <vector>
+#include <chrono>
+#include <functional>
 #include "Instance.h"
+#ifdef _WIN32
 #include "Surface.h"
+#endif
 #include "Device.h"
 #include "SwapChain.h"
+#include "RenderTarget.h"
+#include "Buffer.h"
+#include "GpuProfiler.h"
 #include "RenderPass.h"
 #include "Scene.h"
 #include "DescriptorPool.h"
 #include "Settings.h"
-#define VK_USE_PLATFORM_WIN32_KHR
 #include <vulkan/vulkan.h>
 
 class Engine
 {
 public:
+	// pixels of offscreen frame, they are valid only during callback
+	typedef std::function<void(const uint8_t *pixels, VkExtent2D extent)> ReadbackCallback;
+
+	// measured once by constructor (milliseconds and bytes)
+	struct StartupStatistics
+	{
+		double startupTime;
+
+		double modelsLoadingTime;
+
+		// pipelines are created at this stage, so it depends on pipeline cache state
+		double preparingTime;
+
+		bool pipelineCacheLoaded;
+
+		VkDeviceSize textureMemory;
+
+		uint64_t textureCacheHits;
+
+		uint64_t textureCacheMisses;
+
+		VkDeviceSize textureCacheSavedBytes;
+
+		// only tail levels of streamed textures are resident after startup
+		uint32_t streamedTextureCount;
+
+		// device memory blocks after scene loading (empty blocks are already released)
+		MemoryStats memory;
+
+		VkDeviceSize staticBufferSize;
+	};
+
+#ifdef _WIN32
     Engine(HWND hWnd, VkExtent2D frameExtent, Settings settings);
+#endif
+
+	// offscreen engine, frames are rendered in turn into target images instead of swapchain
+	Engine(VkExtent2D frameExtent, uint32_t targetImageCount, Settings settings);
 
 	~Engine();
 
@@ -27,16 +70,79 @@ public:
 
 	void resize(VkExtent2D newExtent);
 
+	// offscreen frames are copied to host and passed to callback when their fences are signaled,
+	// so callback is called several frames later
+	void setReadbackCallback(ReadbackCallback callback);
+
+	// waits until all frames are rendered and delivers their readbacks
+	void waitIdle();
+
+	// time that last drawFrame call waited for GPU to finish previous frame with same index
+	double getLastWaitTime() const;
+
+	// milliseconds spent on loading and uploading scene models
+	double getModelsLoadingTime() const;
+
+	StartupStatistics getStartupStatistics() const;
+
+	// render passes are measured by GPU profiler (results are written into trace file if path isn't empty)
+	void enableGpuProfiler(bool pipelineStatistics, const std::string &tracePath);
+
+	// returns null if profiler isn't enabled
+	GpuProfiler* getGpuProfiler() const;
+
+	// number of next submitted frame
+	uint64_t getFrameNumber() const;
+
+	// graphics queue wait idles caused by one time commands (they aren't expected during rendering)
+	uint64_t getWaitIdleCount() const;
+
+	// shadow caster instances culled in last frame for each cascade (empty with GPU culling)
+	std::vector<uint32_t> getSavedCascadeDraws() const;
+
+	// draws and binds in commands of all render passes of one frame
+	DrawList::Statistics getDrawStatistics() const;
+
 private:
 	typedef std::map<RenderPassType, std::vector<VkCommandBuffer>> GraphicsCommands;
 
+	// resources of one frame in flight,
+	// they can be reused only after fence of this frame is signaled
+	struct FrameResources
+	{
+		VkCommandPool commandPool;
+		GraphicsCommands commands;
+		VkFence fence;
+		VkSemaphore imageAvailableSemaphore;
+		std::vector<VkSemaphore> stageFinishedSemaphores;
+		Buffer *readbackBuffer = nullptr;
+		bool readbackPending = false;
+
+		// uploads of streamed textures which are executed before render passes
+		VkCommandBuffer streamingCommandBuffer = nullptr;
+
+		// replacement count of texture streamer when material descriptor sets of this frame were updated
+		uint64_t textureReplacementCount = 0;
+	};
+
 	Instance *instance;
 
-	Surface *surface;
+#ifdef _WIN32
+	Surface *surface = nullptr;
+#endif
 
 	Device *device;
 
-	SwapChain *swapChain;
+	// null if engine renders offscreen
+	SwapChain *swapChain = nullptr;
+
+	// swapchain or offscreen images
+	RenderTarget *renderTarget;
+
+	// next offscreen image
+	uint32_t targetImageIndex = 0;
+
+	ReadbackCallback readbackCallback;
 
 	RenderPassesMap renderPasses;
 
@@ -44,21 +150,64 @@ private:
 
 	DescriptorPool *descriptorPool;
 
-	GraphicsCommands graphicsCommands;
+	// count of frames that can be processed by GPU while CPU prepares next frame
+	uint32_t frameCount;
 
-	VkSemaphore imageAvailableSemaphore;
-	std::vector<VkSemaphore> stageFinishedSemaphores;
+	std::vector<FrameResources> frames;
+
+	uint32_t frameIndex = 0;
+
+	// milliseconds
+	double lastWaitTime = 0;
+
+	uint64_t frameNumber = 0;
+
+	GpuProfiler *gpuProfiler = nullptr;
 
 	bool minimized = false;
 
+	StartupStatistics startupStatistics{};
+
+	static std::vector<const char*> getRequiredLayers();
+
+	void setFrameCount(uint32_t frameCount);
+
+	// creates render passes, scene and frames
+	void init(Settings settings, std::chrono::steady_clock::time_point startTime);
+
 	void createRenderPasses(uint32_t shadowsDim);
 
+	void createFrames();
+
 	void initGraphicsCommands();
 
-	void recordRenderPassCommands(RenderPassType type, uint32_t commandBufferIndex, uint32_t renderCount);
+	// replaces images of streamed textures and records their uploads,
+	// returns true if streaming commands of this frame must be submitted
+	bool updateTextureStreaming(uint32_t frameIndex);
+
+	void recordCommands(VkCommandBuffer commandBuffer, RenderPassType type, uint32_t framebufferIndex, uint32_t frameIndex);
+
+	void recordRenderPassCommands(
+		VkCommandBuffer commandBuffer,
+		RenderPassType type,
+		uint32_t framebufferIndex,
+		uint32_t renderCount,
+		uint32_t frameIndex);
 
-	void beginRenderPass(RenderPassType type, uint32_t commandBufferIndex, uint32_t framebufferIndex);
+	void beginRenderPass(VkCommandBuffer commandBuffer, RenderPassType type, uint32_t framebufferIndex);
+
+	void createReadbackBuffers();
+
+	// copies target image into host visible buffer after final render pass
+	void recordReadback(VkCommandBuffer commandBuffer, uint32_t imageIndex, Buffer *readbackBuffer) const;
+
+	void deliverReadback(FrameResources &frame);
 
 	static void createSemaphore(VkDevice device, VkSemaphore &semaphore);
+
+	static void createFence(VkDevice device, VkFence &fence);
+
+	// command buffers of pool can be reset one by one
+	static void createCommandPool(Device *device, VkCommandPool &commandPool);
 };
 
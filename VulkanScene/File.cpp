@@ -2,7 +2,9 @@
 #include <cassert>
 #include <string>
 #include <filesystem>
+#ifdef _WIN32
 #include <Windows.h>
+#endif
 
 #include "File.h"
 
@@ -25,18 +27,43 @@ std::vector<char> File::getBytes(const std::string &path)
 	return stagingBuffer;
 }
 
+bool File::writeBytes(const std::string &path, const std::vector<char> &bytes)
+{
+	const std::filesystem::path absolutePath(getAbsolute(path));
+
+	std::error_code error;
+	std::filesystem::create_directories(absolutePath.parent_path(), error);
+
+	std::ofstream file(absolutePath, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	file.write(bytes.data(), bytes.size());
+
+	file.close();
+
+	return !file.fail();
+}
+
 std::string File::getBaseDirectory()
 {
+#ifdef _WIN32
 	char stagingBuffer[MAX_PATH];
 	GetModuleFileName(nullptr, stagingBuffer, MAX_PATH);
-    const std::string path(stagingBuffer);
+    const std::filesystem::path path(stagingBuffer);
+#else
+	const std::filesystem::path path = std::filesystem::read_symlink("/proc/self/exe");
+#endif
 
-	return std::filesystem::path(path).parent_path().parent_path().string();
+	// executable is placed in build configuration directory
+	return path.parent_path().parent_path().string();
 }
 
 std::string File::getAbsolute(const std::string &path)
 {
-	return getBaseDirectory() + "\\" + path;
+	return (std::filesystem::path(getBaseDirectory()) / path).string();
 }
 
 std::string File::getDirectory(const std::string &path)
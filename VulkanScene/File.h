@@ -8,6 +8,9 @@ class File
 public:
 	static std::vector<char> getBytes(const std::string &path);
 
+	// creates missing directories of path, returns false if file can't be written
+	static bool writeBytes(const std::string &path, const std::vector<char> &bytes);
+
 	static std::string getBaseDirectory();
 
 	static std::string getAbsolute(const std::string &path);
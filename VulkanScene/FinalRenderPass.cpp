@@ -4,10 +4,10 @@
 
 // public:
 
-FinalRenderPass::FinalRenderPass(Device *device, SwapChain *swapChain)
-    : RenderPass(device, swapChain->getExtent(), device->getSampleCount())
+FinalRenderPass::FinalRenderPass(Device *device, RenderTarget *renderTarget)
+    : RenderPass(device, renderTarget->getExtent(), device->getSampleCount())
 {
-    this->pSwapChain = swapChain;
+    this->renderTarget = renderTarget;
 }
 
 void FinalRenderPass::saveRenderPasses(GeometryRenderPass *geometryRenderPass, LightingRenderPass *lightingRenderPass)
@@ -56,14 +56,14 @@ void FinalRenderPass::createRenderPass()
 
     const VkAttachmentDescription resolveAttachmentDesc{
 		0,                         
-		pSwapChain->getImageFormat(),    
+		renderTarget->getImageFormat(),  
 		VK_SAMPLE_COUNT_1_BIT,           
 		VK_ATTACHMENT_LOAD_OP_DONT_CARE, 
 		VK_ATTACHMENT_STORE_OP_STORE,	 
 		VK_ATTACHMENT_LOAD_OP_DONT_CARE, 
 		VK_ATTACHMENT_STORE_OP_DONT_CARE,
 		VK_IMAGE_LAYOUT_UNDEFINED,		 
-		VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, 
+		renderTarget->getFinalLayout(),  
 	};
 
 	std::vector<VkAttachmentDescription> attachmentDescriptions{
@@ -151,11 +151,11 @@ void FinalRenderPass::createRenderPass()
 
 void FinalRenderPass::createFramebuffers()
 {
-	std::vector<VkImageView> swapChainImageViews = pSwapChain->getImageViews();
+	std::vector<VkImageView> targetImageViews = renderTarget->getImageViews();
 
-	for (auto swapChainImageView : swapChainImageViews)
+	for (auto targetImageView : targetImageViews)
 	{
-		addFramebuffer({ colorImage->getView(), depthImage->getView(), swapChainImageView});
+		addFramebuffer({ colorImage->getView(), depthImage->getView(), targetImageView});
 	}
 }
 
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "Image.h"
-#include "SwapChain.h"
+#include "RenderTarget.h"
 #include "RenderPass.h"
 #include "GeometryRenderPass.h"
 #include "LightingRenderPass.h"
@@ -9,7 +9,7 @@
 class FinalRenderPass : public RenderPass
 {
 public:
-	FinalRenderPass(Device *device, SwapChain *swapChain);
+	FinalRenderPass(Device *device, RenderTarget *renderTarget);
 
 	void saveRenderPasses(GeometryRenderPass *geometryRenderPass, LightingRenderPass *lightingRenderPass);
 
@@ -21,7 +21,7 @@ protected:
 	void createFramebuffers() override;
 
 private:
-    SwapChain *pSwapChain;
+    RenderTarget *renderTarget;
 
 	GeometryRenderPass *geometryRenderPass;
 
@@ -0,0 +1,120 @@
+#include <xmmintrin.h>
+#include <limits>
+
+#include "Frustum.h"
+
+// public:
+
+Frustum::Frustum(const glm::mat4 &viewProj, bool hasNearPlane)
+{
+	const glm::vec4 rows[4] = {
+		glm::vec4(viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]),
+		glm::vec4(viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]),
+		glm::vec4(viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]),
+		glm::vec4(viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]),
+	};
+
+	const glm::vec4 planes[PLANE_COUNT] = {
+		rows[3] + rows[0],  // left
+		rows[3] - rows[0],  // right
+		rows[3] + rows[1],  // bottom
+		rows[3] - rows[1],  // top
+		rows[2],            // near
+		rows[3] - rows[2],  // far
+	};
+
+	const uint32_t nearPlaneIndex = 4;
+
+	for (uint32_t i = 0; i < PADDED_PLANE_COUNT; i++)
+	{
+		glm::vec4 plane(0.0f, 0.0f, 0.0f, std::numeric_limits<float>::max());
+		if (i < PLANE_COUNT && (hasNearPlane || i != nearPlaneIndex))
+		{
+			plane = planes[i] / glm::length(glm::vec3(planes[i]));
+		}
+
+		planesX[i] = plane.x;
+		planesY[i] = plane.y;
+		planesZ[i] = plane.z;
+		planesW[i] = plane.w;
+	}
+}
+
+std::vector<glm::vec4> Frustum::getPlanes() const
+{
+	std::vector<glm::vec4> planes(PLANE_COUNT);
+	for (uint32_t i = 0; i < PLANE_COUNT; i++)
+	{
+		planes[i] = glm::vec4(planesX[i], planesY[i], planesZ[i], planesW[i]);
+	}
+
+	return planes;
+}
+
+bool Frustum::intersects(const BoundingVolume &volume) const
+{
+	const glm::vec3 center = volume.getCenter();
+	const __m128 centerX = _mm_set1_ps(center.x);
+	const __m128 centerY = _mm_set1_ps(center.y);
+	const __m128 centerZ = _mm_set1_ps(center.z);
+	const __m128 radius = _mm_set1_ps(volume.getRadius());
+	const __m128 negRadius = _mm_set1_ps(-volume.getRadius());
+
+	bool crossing = false;
+	for (uint32_t i = 0; i < PADDED_PLANE_COUNT; i += 4)
+	{
+		const __m128 x = _mm_load_ps(planesX + i);
+		const __m128 y = _mm_load_ps(planesY + i);
+		const __m128 z = _mm_load_ps(planesZ + i);
+		const __m128 w = _mm_load_ps(planesW + i);
+
+		const __m128 distance = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(x, centerX), _mm_mul_ps(y, centerY)),
+			_mm_add_ps(_mm_mul_ps(z, centerZ), w));
+
+		if (_mm_movemask_ps(_mm_cmplt_ps(distance, negRadius)) != 0)
+		{
+			return false;
+		}
+		crossing |= _mm_movemask_ps(_mm_cmplt_ps(distance, radius)) != 0;
+	}
+
+	if (!crossing)
+	{
+		return true;
+	}
+
+	// box is outside if its corner farthest along plane normal is behind the plane
+	const glm::vec3 min = volume.getMin();
+	const glm::vec3 max = volume.getMax();
+	const __m128 minX = _mm_set1_ps(min.x);
+	const __m128 minY = _mm_set1_ps(min.y);
+	const __m128 minZ = _mm_set1_ps(min.z);
+	const __m128 maxX = _mm_set1_ps(max.x);
+	const __m128 maxY = _mm_set1_ps(max.y);
+	const __m128 maxZ = _mm_set1_ps(max.z);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (uint32_t i = 0; i < PADDED_PLANE_COUNT; i += 4)
+	{
+		const __m128 x = _mm_load_ps(planesX + i);
+		const __m128 y = _mm_load_ps(planesY + i);
+		const __m128 z = _mm_load_ps(planesZ + i);
+		const __m128 w = _mm_load_ps(planesW + i);
+
+		const __m128 distance = _mm_add_ps(
+			_mm_add_ps(
+				_mm_max_ps(_mm_mul_ps(x, minX), _mm_mul_ps(x, maxX)),
+				_mm_max_ps(_mm_mul_ps(y, minY), _mm_mul_ps(y, maxY))),
+			_mm_add_ps(
+				_mm_max_ps(_mm_mul_ps(z, minZ), _mm_mul_ps(z, maxZ)),
+				w));
+
+		if (_mm_movemask_ps(_mm_cmplt_ps(distance, zero)) != 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
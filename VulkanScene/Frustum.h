@@ -0,0 +1,37 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <vector>
+#include "BoundingVolume.h"
+
+class Frustum
+{
+public:
+	// extracts planes of view volume from view projection matrix (depth range is [0, 1]),
+	// without near plane volume is extruded to infinity toward viewer (used to find shadow casters)
+	Frustum(const glm::mat4 &viewProj, bool hasNearPlane = true);
+
+	// sphere is tested first, box is tested only if sphere crosses some planes
+	bool intersects(const BoundingVolume &volume) const;
+
+	// returns planes (normal and distance), disabled near plane is infinitely far
+	std::vector<glm::vec4> getPlanes() const;
+
+	static const uint32_t PLANE_COUNT = 6;
+
+private:
+	// planes are stored by components, so 4 planes are tested with one SSE instruction,
+	// padding planes are infinitely far, so they don't cull anything
+	static const uint32_t PADDED_PLANE_COUNT = 8;
+
+	alignas(16) float planesX[PADDED_PLANE_COUNT];
+
+	alignas(16) float planesY[PADDED_PLANE_COUNT];
+
+	alignas(16) float planesZ[PADDED_PLANE_COUNT];
+
+	alignas(16) float planesW[PADDED_PLANE_COUNT];
+};
+
@@ -0,0 +1,85 @@
+#include <cassert>
+#include <limits>
+
+#include "GeometryArena.h"
+
+// public:
+
+GeometryArena::GeometryArena(
+	Device *device,
+	const std::vector<uint32_t> &streamStrides,
+	uint32_t vertexCount,
+	uint32_t indexCount,
+	uint32_t maxMeshVertexCount)
+	: streamStrides(streamStrides), vertexCount(vertexCount), indexCount(indexCount)
+{
+	VkDeviceSize vertexBufferSize = 0;
+	for (auto stride : streamStrides)
+	{
+		streamOffsets.push_back(vertexBufferSize);
+		vertexBufferSize += VkDeviceSize(vertexCount) * stride;
+	}
+
+	// indices of mesh are relative to its first vertex
+	const bool shortIndices = maxMeshVertexCount <= uint32_t(std::numeric_limits<uint16_t>::max()) + 1;
+	indexType = shortIndices ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+	const VkDeviceSize indexSize = shortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+
+	vertexBuffer = new Buffer(device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBufferSize);
+	indexBuffer = new Buffer(device, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexCount * indexSize);
+}
+
+GeometryArena::~GeometryArena()
+{
+	delete vertexBuffer;
+	delete indexBuffer;
+}
+
+VkIndexType GeometryArena::getIndexType() const
+{
+	return indexType;
+}
+
+GeometryArena::Range GeometryArena::add(
+	const std::vector<const void*> &streams,
+	uint32_t vertexCount,
+	const uint32_t *indices,
+	uint32_t indexCount)
+{
+	assert(streams.size() == streamStrides.size());
+	assert(usedVertexCount + vertexCount <= this->vertexCount);
+	assert(usedIndexCount + indexCount <= this->indexCount);
+
+	const Range range{ int32_t(usedVertexCount), usedIndexCount };
+
+	for (size_t i = 0; i < streams.size(); i++)
+	{
+		vertexBuffer->updateData(
+			streams[i],
+			VkDeviceSize(vertexCount) * streamStrides[i],
+			streamOffsets[i] + VkDeviceSize(usedVertexCount) * streamStrides[i]);
+	}
+
+	if (indexType == VK_INDEX_TYPE_UINT16)
+	{
+		const std::vector<uint16_t> shortIndices(indices, indices + indexCount);
+		indexBuffer->updateData(shortIndices.data(), indexCount * sizeof(uint16_t), usedIndexCount * sizeof(uint16_t));
+	}
+	else
+	{
+		indexBuffer->updateData(indices, indexCount * sizeof(uint32_t), usedIndexCount * sizeof(uint32_t));
+	}
+
+	usedVertexCount += vertexCount;
+	usedIndexCount += indexCount;
+
+	return range;
+}
+
+void GeometryArena::bind(VkCommandBuffer commandBuffer) const
+{
+	const std::vector<VkBuffer> vertexBuffers(streamOffsets.size(), vertexBuffer->get());
+	vkCmdBindVertexBuffers(commandBuffer, 0, uint32_t(vertexBuffers.size()), vertexBuffers.data(), streamOffsets.data());
+
+	vkCmdBindIndexBuffer(commandBuffer, indexBuffer->get(), 0, indexType);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "Device.h"
+#include "Buffer.h"
+
+// vertex streams and indices of all meshes of model in one vertex buffer and one index buffer,
+// meshes are drawn with their vertex offset and first index, so buffers are bound once for all of them
+class GeometryArena
+{
+public:
+	// place of mesh in arena
+	struct Range
+	{
+		int32_t vertexOffset;
+
+		uint32_t firstIndex;
+	};
+
+	// each stream has place for vertex count vertices (streams are placed one after another),
+	// indices are 16-bit if each mesh has no more than 65536 vertices
+	GeometryArena(
+		Device *device,
+		const std::vector<uint32_t> &streamStrides,
+		uint32_t vertexCount,
+		uint32_t indexCount,
+		uint32_t maxMeshVertexCount);
+
+	~GeometryArena();
+
+	VkIndexType getIndexType() const;
+
+	// copies vertex streams of mesh (one pointer for each stream) and its indices into next free place,
+	// indices are relative to first vertex of mesh
+	Range add(const std::vector<const void*> &streams, uint32_t vertexCount, const uint32_t *indices, uint32_t indexCount);
+
+	// binds streams from binding 0 and index buffer
+	void bind(VkCommandBuffer commandBuffer) const;
+
+private:
+	Buffer *vertexBuffer;
+
+	Buffer *indexBuffer;
+
+	std::vector<uint32_t> streamStrides;
+
+	std::vector<VkDeviceSize> streamOffsets;
+
+	VkIndexType indexType;
+
+	uint32_t vertexCount;
+
+	uint32_t indexCount;
+
+	uint32_t usedVertexCount = 0;
+
+	uint32_t usedIndexCount = 0;
+};
@@ -0,0 +1,287 @@
+#include <cassert>
+#include <stdexcept>
+
+#include "GpuProfiler.h"
+
+// public:
+
+GpuProfiler::GpuProfiler(
+	Device *device,
+	uint32_t frameCount,
+	uint32_t cascadeCount,
+	bool pipelineStatistics,
+	const std::string &tracePath)
+{
+	const VkPhysicalDeviceLimits limits = device->getLimits();
+	if (!limits.timestampComputeAndGraphics)
+	{
+		throw std::runtime_error("Device doesn't support timestamp queries");
+	}
+
+	this->device = device;
+	this->cascadeCount = cascadeCount;
+	this->pipelineStatistics = pipelineStatistics && device->isPipelineStatisticsQuerySupported();
+	timestampPeriod = limits.timestampPeriod;
+
+	createQueryPools(frameCount);
+
+	if (!tracePath.empty())
+	{
+		trace.open(tracePath);
+
+		trace << "frame";
+		for (auto type : PASS_TYPES)
+		{
+			trace << "," << getPassName(type);
+		}
+		for (uint32_t i = 0; i < cascadeCount; i++)
+		{
+			trace << ",CASCADE_" << i;
+		}
+		if (this->pipelineStatistics)
+		{
+			for (auto type : PASS_TYPES)
+			{
+				trace << "," << getPassName(type) << "_VERTICES," << getPassName(type) << "_FRAGMENTS";
+			}
+		}
+		trace << std::endl;
+	}
+}
+
+GpuProfiler::~GpuProfiler()
+{
+	for (auto &frame : frames)
+	{
+		vkDestroyQueryPool(device->get(), frame.timestampPool, nullptr);
+		if (frame.statisticsPool)
+		{
+			vkDestroyQueryPool(device->get(), frame.statisticsPool, nullptr);
+		}
+	}
+}
+
+bool GpuProfiler::isPipelineStatisticsEnabled() const
+{
+	return pipelineStatistics;
+}
+
+void GpuProfiler::recordPassBegin(VkCommandBuffer commandBuffer, RenderPassType type, uint32_t frameIndex) const
+{
+	const FrameQueries &frame = frames[frameIndex];
+
+	vkCmdResetQueryPool(commandBuffer, frame.timestampPool, getPassQuery(type), 2);
+	if (type == DEPTH)
+	{
+		vkCmdResetQueryPool(commandBuffer, frame.timestampPool, getCascadeQuery(0), 2 * cascadeCount);
+	}
+
+	if (pipelineStatistics)
+	{
+		vkCmdResetQueryPool(commandBuffer, frame.statisticsPool, uint32_t(type), 1);
+		vkCmdBeginQuery(commandBuffer, frame.statisticsPool, uint32_t(type), 0);
+	}
+
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.timestampPool, getPassQuery(type));
+}
+
+void GpuProfiler::recordPassEnd(VkCommandBuffer commandBuffer, RenderPassType type, uint32_t frameIndex) const
+{
+	const FrameQueries &frame = frames[frameIndex];
+
+	if (pipelineStatistics)
+	{
+		vkCmdEndQuery(commandBuffer, frame.statisticsPool, uint32_t(type));
+	}
+
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.timestampPool, getPassQuery(type) + 1);
+}
+
+void GpuProfiler::recordCascadeBegin(VkCommandBuffer commandBuffer, uint32_t cascadeIndex, uint32_t frameIndex) const
+{
+	vkCmdWriteTimestamp(
+		commandBuffer,
+		VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+		frames[frameIndex].timestampPool,
+		getCascadeQuery(cascadeIndex));
+}
+
+void GpuProfiler::recordCascadeEnd(VkCommandBuffer commandBuffer, uint32_t cascadeIndex, uint32_t frameIndex) const
+{
+	vkCmdWriteTimestamp(
+		commandBuffer,
+		VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		frames[frameIndex].timestampPool,
+		getCascadeQuery(cascadeIndex) + 1);
+}
+
+void GpuProfiler::markSubmitted(uint32_t frameIndex, uint64_t frameNumber)
+{
+	frames[frameIndex].pending = true;
+	frames[frameIndex].frameNumber = frameNumber;
+}
+
+void GpuProfiler::collect(uint32_t frameIndex)
+{
+	FrameQueries &frame = frames[frameIndex];
+	if (!frame.pending)
+	{
+		return;
+	}
+	frame.pending = false;
+
+	// frame fence is signaled, so results are ready and reading doesn't wait
+	std::vector<uint64_t> timestamps(getTimestampCount());
+	VkResult result = vkGetQueryPoolResults(
+		device->get(),
+		frame.timestampPool,
+		0,
+		uint32_t(timestamps.size()),
+		timestamps.size() * sizeof(uint64_t),
+		timestamps.data(),
+		sizeof(uint64_t),
+		VK_QUERY_RESULT_64_BIT);
+	if (result == VK_NOT_READY)
+	{
+		return;
+	}
+	assert(result == VK_SUCCESS);
+
+	const auto getTime = [&](uint32_t query)
+	{
+		return double(timestamps[query + 1] - timestamps[query]) * timestampPeriod / 1000000.0;
+	};
+
+	FrameResults frameResults{ frame.frameNumber };
+	for (auto type : PASS_TYPES)
+	{
+		frameResults.passTimes[type] = getTime(getPassQuery(type));
+	}
+	for (uint32_t i = 0; i < cascadeCount; i++)
+	{
+		frameResults.cascadeTimes.push_back(getTime(getCascadeQuery(i)));
+	}
+
+	if (pipelineStatistics)
+	{
+		std::vector<PassStatistics> statistics(PASS_TYPES.size());
+		result = vkGetQueryPoolResults(
+			device->get(),
+			frame.statisticsPool,
+			0,
+			uint32_t(statistics.size()),
+			statistics.size() * sizeof(PassStatistics),
+			statistics.data(),
+			sizeof(PassStatistics),
+			VK_QUERY_RESULT_64_BIT);
+		assert(result == VK_SUCCESS || result == VK_NOT_READY);
+
+		for (auto type : PASS_TYPES)
+		{
+			frameResults.statistics[type] = statistics[type];
+		}
+	}
+
+	writeTrace(frameResults);
+	results.push_back(frameResults);
+}
+
+std::vector<GpuProfiler::FrameResults> GpuProfiler::takeResults()
+{
+	std::vector<FrameResults> takenResults;
+	takenResults.swap(results);
+
+	return takenResults;
+}
+
+std::string GpuProfiler::getPassName(RenderPassType type)
+{
+	switch (type)
+	{
+	case DEPTH:
+		return "DEPTH";
+	case GEOMETRY:
+		return "GEOMETRY";
+	case SSAO:
+		return "SSAO";
+	case SSAO_BLUR:
+		return "SSAO_BLUR";
+	case LIGHTING:
+		return "LIGHTING";
+	case FINAL:
+		return "FINAL";
+	default:
+		throw std::invalid_argument("Unknown render pass type");
+	}
+}
+
+// private:
+
+uint32_t GpuProfiler::getPassQuery(RenderPassType type) const
+{
+	return 2 * uint32_t(type);
+}
+
+uint32_t GpuProfiler::getCascadeQuery(uint32_t cascadeIndex) const
+{
+	return 2 * uint32_t(PASS_TYPES.size() + cascadeIndex);
+}
+
+uint32_t GpuProfiler::getTimestampCount() const
+{
+	return 2 * uint32_t(PASS_TYPES.size() + cascadeCount);
+}
+
+void GpuProfiler::createQueryPools(uint32_t frameCount)
+{
+	frames.resize(frameCount);
+
+	for (auto &frame : frames)
+	{
+		VkQueryPoolCreateInfo createInfo{
+			VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+			nullptr,
+			0,
+			VK_QUERY_TYPE_TIMESTAMP,
+			getTimestampCount(),
+			0
+		};
+
+		VkResult result = vkCreateQueryPool(device->get(), &createInfo, nullptr, &frame.timestampPool);
+		assert(result == VK_SUCCESS);
+
+		if (pipelineStatistics)
+		{
+			createInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+			createInfo.queryCount = uint32_t(PASS_TYPES.size());
+			createInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT
+				| VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+			result = vkCreateQueryPool(device->get(), &createInfo, nullptr, &frame.statisticsPool);
+			assert(result == VK_SUCCESS);
+		}
+	}
+}
+
+void GpuProfiler::writeTrace(const FrameResults &frameResults)
+{
+	if (!trace.is_open())
+	{
+		return;
+	}
+
+	trace << frameResults.frameNumber;
+	for (auto type : PASS_TYPES)
+	{
+		trace << "," << frameResults.passTimes.at(type);
+	}
+	for (auto time : frameResults.cascadeTimes)
+	{
+		trace << "," << time;
+	}
+	for (const auto &[type, statistics] : frameResults.statistics)
+	{
+		trace << "," << statistics.vertexInvocations << "," << statistics.fragmentInvocations;
+	}
+	trace << std::endl;
+}
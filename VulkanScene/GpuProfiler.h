@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <map>
+#include <string>
+#include <fstream>
+#include "Device.h"
+#include "RenderPass.h"
+
+// measures GPU time of each render pass (and each cascade of depth pass) with timestamp queries
+// and optionally counts shader invocations with pipeline statistics queries,
+// each frame in flight has its own query pools, their results are read after frame fence is signaled
+class GpuProfiler
+{
+public:
+	struct PassStatistics
+	{
+		uint64_t vertexInvocations;
+		uint64_t fragmentInvocations;
+	};
+
+	struct FrameResults
+	{
+		uint64_t frameNumber;
+
+		// milliseconds
+		std::map<RenderPassType, double> passTimes;
+		std::vector<double> cascadeTimes;
+
+		// empty if pipeline statistics aren't collected
+		std::map<RenderPassType, PassStatistics> statistics;
+	};
+
+	// results are also written into trace file (csv) if its path isn't empty
+	GpuProfiler(
+		Device *device,
+		uint32_t frameCount,
+		uint32_t cascadeCount,
+		bool pipelineStatistics,
+		const std::string &tracePath);
+
+	~GpuProfiler();
+
+	// false if device doesn't support pipeline statistics queries
+	bool isPipelineStatisticsEnabled() const;
+
+	// resets queries of pass and writes its begin timestamp
+	void recordPassBegin(VkCommandBuffer commandBuffer, RenderPassType type, uint32_t frameIndex) const;
+
+	void recordPassEnd(VkCommandBuffer commandBuffer, RenderPassType type, uint32_t frameIndex) const;
+
+	void recordCascadeBegin(VkCommandBuffer commandBuffer, uint32_t cascadeIndex, uint32_t frameIndex) const;
+
+	void recordCascadeEnd(VkCommandBuffer commandBuffer, uint32_t cascadeIndex, uint32_t frameIndex) const;
+
+	// queries of frame with this index will be written by frame with such number
+	void markSubmitted(uint32_t frameIndex, uint64_t frameNumber);
+
+	// reads results of submitted frame, must be called after its fence is signaled
+	void collect(uint32_t frameIndex);
+
+	// returns collected results and removes them from profiler
+	std::vector<FrameResults> takeResults();
+
+	static std::string getPassName(RenderPassType type);
+
+private:
+	const std::vector<RenderPassType> PASS_TYPES{ DEPTH, GEOMETRY, SSAO, SSAO_BLUR, LIGHTING, FINAL };
+
+	struct FrameQueries
+	{
+		VkQueryPool timestampPool;
+		VkQueryPool statisticsPool = VK_NULL_HANDLE;
+		bool pending = false;
+		uint64_t frameNumber = 0;
+	};
+
+	Device *device;
+
+	uint32_t cascadeCount;
+
+	bool pipelineStatistics;
+
+	// nanoseconds in one timestamp tick
+	float timestampPeriod;
+
+	std::vector<FrameQueries> frames;
+
+	std::vector<FrameResults> results;
+
+	std::ofstream trace;
+
+	// begin and end timestamps of passes, then of cascades
+	uint32_t getPassQuery(RenderPassType type) const;
+
+	uint32_t getCascadeQuery(uint32_t cascadeIndex) const;
+
+	uint32_t getTimestampCount() const;
+
+	void createQueryPools(uint32_t frameCount);
+
+	void writeTrace(const FrameResults &frameResults);
+};
+
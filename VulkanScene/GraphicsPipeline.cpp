@@ -12,7 +12,8 @@ GraphicsPipeline::GraphicsPipeline(
 	const std::vector<std::shared_ptr<ShaderModule>> &shaderModules,
 	const std::vector<VkVertexInputBindingDescription> &bindingDescriptions,
 	const std::vector<VkVertexInputAttributeDescription> &attributeDescriptions,
-    VkBool32 blendEnable)
+    VkBool32 blendEnable,
+	VkBool32 depthClampEnable)
 {
 	this->device = device;
 	this->renderPass = renderPass;
@@ -20,6 +21,7 @@ GraphicsPipeline::GraphicsPipeline(
 	this->bindingDescriptions = bindingDescriptions;
 	this->attributeDescriptions = attributeDescriptions;
 	this->blendEnable = blendEnable;
+	this->depthClampEnable = depthClampEnable;
 
 	createLayout(descriptorSetLayouts, pushConstantRanges);
 
@@ -42,12 +44,6 @@ VkPipelineLayout GraphicsPipeline::getLayout() const
 	return layout;
 }
 
-void GraphicsPipeline::recreate()
-{
-	vkDestroyPipeline(device->get(), pipeline, nullptr);
-	createPipeline();
-}
-
 // private:
 
 void GraphicsPipeline::createLayout(
@@ -110,32 +106,16 @@ void GraphicsPipeline::createPipeline()
 		false,													
 	};
 
-	// view area:
-
-	VkExtent2D viewportExtent = renderPass->getExtent();
-
-	VkViewport viewport{
-		0,
-		0,
-		float(viewportExtent.width),
-		float(viewportExtent.height),
-		0,
-		1
-	};
-
-	VkRect2D scissor{
-		{ 0, 0 },
-		viewportExtent
-	};
+	// view area (set when render pass begins, so pipeline doesn't depend on extent):
 
 	VkPipelineViewportStateCreateInfo viewportState{
 		VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
 		nullptr,												
 		0,														
 		1,														
-		&viewport,												
+		nullptr,												
 		1,														
-		&scissor												
+		nullptr												
 	};
 
 	// rasterization (converts primitives into fragments):
@@ -144,7 +124,7 @@ void GraphicsPipeline::createPipeline()
 		VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
 		nullptr,					
 		0,							
-		false,					
+		depthClampEnable,					
 		false,					
 		VK_POLYGON_MODE_FILL,		
 		VK_CULL_MODE_NONE,			
@@ -219,6 +199,21 @@ void GraphicsPipeline::createPipeline()
 		{ 0, 0, 0, 0 }                
 	};
 
+	// dynamic state:
+
+	const std::vector<VkDynamicState> dynamicStates{
+		VK_DYNAMIC_STATE_VIEWPORT,
+		VK_DYNAMIC_STATE_SCISSOR
+	};
+
+	VkPipelineDynamicStateCreateInfo dynamicState{
+		VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+		nullptr,
+		0,
+		uint32_t(dynamicStates.size()),
+		dynamicStates.data()
+	};
+
 	// pipeline (contains all of the above)
 
 	VkGraphicsPipelineCreateInfo createInfo{
@@ -235,7 +230,7 @@ void GraphicsPipeline::createPipeline()
 		&multisampleState,	
 		&depthStencilState,	
 		&colorBlendState,	
-		nullptr,			
+		&dynamicState,		
 		layout,				
 		renderPass->get(),  
 		0,					
@@ -243,7 +238,7 @@ void GraphicsPipeline::createPipeline()
 		-1,					
 	};
 
-	const VkResult result = vkCreateGraphicsPipelines(device->get(), nullptr, 1, &createInfo, nullptr, &pipeline);
+	const VkResult result = vkCreateGraphicsPipelines(device->get(), device->getPipelineCache(), 1, &createInfo, nullptr, &pipeline);
 	assert(result == VK_SUCCESS);
 }
 
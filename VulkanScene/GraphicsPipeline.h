@@ -17,7 +17,8 @@ public:
 		const std::vector<std::shared_ptr<ShaderModule>> &shaderModules,
 		const std::vector<VkVertexInputBindingDescription> &bindingDescriptions,
 		const std::vector<VkVertexInputAttributeDescription> &attributeDescriptions,
-		VkBool32 blendEnable);
+		VkBool32 blendEnable,
+		VkBool32 depthClampEnable = false);
 
 	~GraphicsPipeline();
 
@@ -25,8 +26,6 @@ public:
 
 	VkPipelineLayout getLayout() const;
 
-	void recreate();
-
 private:
 	Device *device;
 
@@ -43,6 +42,8 @@ private:
 
 	VkBool32 blendEnable;
 
+	VkBool32 depthClampEnable;
+
 	void createLayout(
 		std::vector<VkDescriptorSetLayout> descriptorSetLayouts,
 		const std::vector<VkPushConstantRange> &pushConstantRanges);
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <utility>
 #include "StagingBuffer.h"
 
 #include "Image.h"
@@ -39,7 +40,7 @@ Image::~Image()
 {
 	vkDestroyImageView(device->get(), view, nullptr);
 	vkDestroyImage(device->get(), image, nullptr);
-	vkFreeMemory(device->get(), memory, nullptr);
+	device->getMemoryAllocator()->free(memory);
 }
 
 VkExtent3D Image::getExtent() const
@@ -68,7 +69,16 @@ void Image::transitLayout(
     VkImageSubresourceRange subresourceRange) const
 {
 	VkCommandBuffer commandBuffer = device->beginOneTimeCommands();
+	recordLayoutTransition(commandBuffer, oldLayout, newLayout, subresourceRange);
+	device->endOneTimeCommands(commandBuffer);
+}
 
+void Image::recordLayoutTransition(
+	VkCommandBuffer commandBuffer,
+	VkImageLayout oldLayout,
+	VkImageLayout newLayout,
+	VkImageSubresourceRange subresourceRange) const
+{
 	VkImageMemoryBarrier barrier{
 		VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
 		nullptr,								
@@ -145,8 +155,6 @@ void Image::transitLayout(
 		0, nullptr,
 		0, nullptr,
 		1, &barrier);
-
-	device->endOneTimeCommands(commandBuffer);
 }
 
 void Image::updateData(std::vector<const void*> data, uint32_t layersOffset, uint32_t pixelSize) const
@@ -166,10 +174,10 @@ void Image::updateData(std::vector<const void*> data, uint32_t layersOffset, uin
 	};
 	const VkDeviceSize layerSize = extent.width * extent.height * pixelSize;
 
-	StagingBuffer stagingBuffer(device, layerSize * updatedLayers);
+	StagingBuffer *stagingBuffer = new StagingBuffer(device, layerSize * updatedLayers);
 	for (uint32_t i = 0; i < updatedLayers; i++)
 	{
-		stagingBuffer.updateData(data[i], layerSize, i * layerSize);
+		stagingBuffer->updateData(data[i], layerSize, i * layerSize);
 	}
 
 	std::vector<VkBufferImageCopy> regions(updatedLayers);
@@ -196,7 +204,9 @@ void Image::updateData(std::vector<const void*> data, uint32_t layersOffset, uin
 		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 		subresourceRange);
 
-	stagingBuffer.copyToImage(image, regions);
+	stagingBuffer->copyToImage(image, regions);
+
+	device->releaseStagingBuffer(stagingBuffer);
 }
 
 void Image::copyImage(Device *device, Image &srcImage, Image &dstImage, VkExtent3D extent, VkImageSubresourceLayers subresourceLayers)
@@ -225,6 +235,20 @@ void Image::copyImage(Device *device, Image &srcImage, Image &dstImage, VkExtent
 
 // protected:
 
+void Image::swapImage(Image &other)
+{
+	assert(device == other.device);
+
+	std::swap(image, other.image);
+	std::swap(view, other.view);
+	std::swap(format, other.format);
+	std::swap(extent, other.extent);
+	std::swap(sampleCount, other.sampleCount);
+	std::swap(mipLevels, other.mipLevels);
+	std::swap(arrayLayers, other.arrayLayers);
+	std::swap(memory, other.memory);
+}
+
 void Image::createThisImage(
 	Device *device,
 	VkExtent3D extent,
@@ -287,9 +311,7 @@ void Image::createThisImage(
 	const VkResult result = vkCreateImage(device->get(), &imageInfo, nullptr, &image);
 	assert(result == VK_SUCCESS);
 
-	allocateMemory(device, properties);
-
-	vkBindImageMemory(device->get(), image, memory, 0);
+	memory = device->getMemoryAllocator()->allocate(image, tiling, properties);
 
 	const VkImageSubresourceRange subresourceRange{
 		aspectFlags,
@@ -300,25 +322,3 @@ void Image::createThisImage(
 	};
 	view = createImageView(subresourceRange, viewType);
 }
-
-// private:
-
-void Image::allocateMemory(Device *device, VkMemoryPropertyFlags properties)
-{
-	VkMemoryRequirements memRequirements;
-	vkGetImageMemoryRequirements(device->get(), image, &memRequirements);
-
-    const uint32_t memoryTypeIndex = device->findMemoryTypeIndex(
-		memRequirements.memoryTypeBits,
-		properties);
-
-	VkMemoryAllocateInfo allocInfo{
-		VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-		nullptr,			
-		memRequirements.size,	
-		memoryTypeIndex,		
-	};
-
-    const VkResult result = vkAllocateMemory(device->get(), &allocInfo, nullptr, &memory);
-	assert(result == VK_SUCCESS);
-}
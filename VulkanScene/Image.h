@@ -22,7 +22,7 @@ public:
 		VkMemoryPropertyFlags properties,
 		VkImageAspectFlags aspectFlags);
 
-	~Image();
+	virtual ~Image();
 
 	VkExtent3D getExtent() const;
 
@@ -34,6 +34,13 @@ public:
 
 	void transitLayout(VkImageLayout oldLayout, VkImageLayout newLayout, VkImageSubresourceRange subresourceRange) const;
 
+	// records layout transition barrier into command buffer instead of one time commands
+	void recordLayoutTransition(
+		VkCommandBuffer commandBuffer,
+		VkImageLayout oldLayout,
+		VkImageLayout newLayout,
+		VkImageSubresourceRange subresourceRange) const;
+
 	void updateData(std::vector<const void*>, uint32_t layersOffset, uint32_t pixelSize) const;
 
 	static void copyImage(
@@ -69,9 +76,10 @@ protected:
 		VkMemoryPropertyFlags properties,
 		VkImageAspectFlags aspectFlags);
 
-private:
-	VkDeviceMemory memory;
+	// exchanges images, views and memory of both objects (e.g. to replace image which is referenced by pointer)
+	void swapImage(Image &other);
 
-	void allocateMemory(Device *device, VkMemoryPropertyFlags properties);
+private:
+	MemoryAllocation memory;
 };
 
@@ -0,0 +1,187 @@
+#include <algorithm>
+
+#include "JobPool.h"
+
+// public:
+
+JobPool::JobPool(uint32_t threadCount)
+{
+	if (threadCount == 0)
+	{
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	for (uint32_t i = 0; i < threadCount; i++)
+	{
+		queues.push_back(new Queue());
+	}
+
+	for (uint32_t i = 0; i < threadCount; i++)
+	{
+		threads.emplace_back(&JobPool::workerLoop, this, i);
+	}
+}
+
+JobPool::~JobPool()
+{
+	wait();
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	sleepCondition.notify_all();
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	for (auto queue : queues)
+	{
+		delete queue;
+	}
+}
+
+uint32_t JobPool::getThreadCount() const
+{
+	return uint32_t(threads.size());
+}
+
+void JobPool::submit(Job job)
+{
+	const uint32_t queueIndex = workerPool == this
+		? workerQueue
+		: nextQueue.fetch_add(1, std::memory_order_relaxed) % uint32_t(queues.size());
+
+	pendingJobCount++;
+
+	// counted before push, so taken job never makes count negative
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		queuedJobCount++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(queues[queueIndex]->mutex);
+		queues[queueIndex]->jobs.push_back(std::move(job));
+	}
+	sleepCondition.notify_one();
+}
+
+void JobPool::parallelFor(uint32_t count, const std::function<void(uint32_t)> &function)
+{
+	std::atomic<uint32_t> remainingCount{ count };
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		submit([&function, &remainingCount, i]()
+		{
+			function(i);
+			remainingCount--;
+		});
+	}
+
+	const uint32_t queueIndex = workerPool == this ? workerQueue : 0;
+
+	Job job;
+	while (remainingCount > 0)
+	{
+		if (takeJob(queueIndex, job))
+		{
+			execute(job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobPool::wait()
+{
+	const uint32_t queueIndex = workerPool == this ? workerQueue : 0;
+
+	Job job;
+	while (pendingJobCount > 0)
+	{
+		if (takeJob(queueIndex, job))
+		{
+			execute(job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+// private:
+
+thread_local JobPool *JobPool::workerPool = nullptr;
+
+thread_local uint32_t JobPool::workerQueue = 0;
+
+void JobPool::workerLoop(uint32_t queueIndex)
+{
+	workerPool = this;
+	workerQueue = queueIndex;
+
+	Job job;
+	while (true)
+	{
+		if (takeJob(queueIndex, job))
+		{
+			execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleepCondition.wait(lock, [this]() { return stopping || queuedJobCount > 0; });
+
+		if (stopping && queuedJobCount == 0)
+		{
+			return;
+		}
+	}
+}
+
+bool JobPool::takeJob(uint32_t queueIndex, Job &job)
+{
+	for (uint32_t i = 0; i < queues.size(); i++)
+	{
+		Queue *queue = queues[(queueIndex + i) % queues.size()];
+
+		std::lock_guard<std::mutex> lock(queue->mutex);
+
+		if (!queue->jobs.empty())
+		{
+			// own queue is used as stack (nested jobs are hot), other queues are robbed from front
+			if (i == 0)
+			{
+				job = std::move(queue->jobs.back());
+				queue->jobs.pop_back();
+			}
+			else
+			{
+				job = std::move(queue->jobs.front());
+				queue->jobs.pop_front();
+			}
+
+			std::lock_guard<std::mutex> sleepLock(sleepMutex);
+			queuedJobCount--;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobPool::execute(Job &job)
+{
+	job();
+	job = nullptr;
+
+	pendingJobCount--;
+}
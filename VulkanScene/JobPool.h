@@ -0,0 +1,78 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// pool of worker threads, each worker has its own job queue
+// and steals jobs from other queues when its queue is empty
+class JobPool
+{
+public:
+	typedef std::function<void()> Job;
+
+	// zero thread count means hardware concurrency
+	JobPool(uint32_t threadCount);
+
+	// waits until all submitted jobs are done
+	~JobPool();
+
+	JobPool(const JobPool&) = delete;
+
+	JobPool& operator=(const JobPool&) = delete;
+
+	uint32_t getThreadCount() const;
+
+	// job submitted by worker is pushed into its own queue (jobs can submit nested jobs),
+	// jobs submitted by other threads are distributed between queues
+	void submit(Job job);
+
+	// calls function for each index by separate jobs,
+	// calling thread executes jobs until all calls are done
+	void parallelFor(uint32_t count, const std::function<void(uint32_t)> &function);
+
+	// calling thread executes jobs until all submitted jobs are done
+	void wait();
+
+private:
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	std::vector<std::thread> threads;
+
+	std::vector<Queue*> queues;
+
+	std::atomic<uint32_t> nextQueue{ 0 };
+
+	// jobs which are submitted but not finished
+	std::atomic<uint32_t> pendingJobCount{ 0 };
+
+	// jobs which are waiting in queues, workers sleep while it's zero
+	uint32_t queuedJobCount = 0;
+
+	std::mutex sleepMutex;
+
+	std::condition_variable sleepCondition;
+
+	bool stopping = false;
+
+	// pool and queue of worker which runs on this thread
+	static thread_local JobPool *workerPool;
+
+	static thread_local uint32_t workerQueue;
+
+	void workerLoop(uint32_t queueIndex);
+
+	// pops newest job of own queue or steals oldest job of other queue
+	bool takeJob(uint32_t queueIndex, Job &job);
+
+	void execute(Job &job);
+};
+
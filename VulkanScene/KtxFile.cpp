@@ -0,0 +1,254 @@
+#include <fstream>
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include "File.h"
+
+#include "KtxFile.h"
+
+// public:
+
+KtxFile::KtxFile(const std::string &path)
+{
+	file = new MappedFile(path);
+	valid = file->isOpen() && checkLayout();
+}
+
+KtxFile::~KtxFile()
+{
+	delete file;
+}
+
+bool KtxFile::isValid() const
+{
+	return valid;
+}
+
+VkFormat KtxFile::getFormat() const
+{
+	return VkFormat(getHeader()->vkFormat);
+}
+
+VkExtent2D KtxFile::getExtent() const
+{
+	return { getHeader()->pixelWidth, getHeader()->pixelHeight };
+}
+
+uint32_t KtxFile::getLevelCount() const
+{
+	return getHeader()->levelCount;
+}
+
+KtxFile::Level KtxFile::getLevel(uint32_t index) const
+{
+	assert(valid && index < getLevelCount());
+
+	const LevelIndex &levelIndex = getLevelIndices()[index];
+
+	return {
+		reinterpret_cast<const uint8_t*>(file->getData()) + levelIndex.byteOffset,
+		levelIndex.byteLength,
+		getLevelExtent(getExtent(), index)
+	};
+}
+
+bool KtxFile::save(
+	const std::string &path,
+	VkFormat format,
+	VkExtent2D extent,
+	const std::vector<std::vector<uint8_t>> &levels)
+{
+	const std::vector<uint32_t> dataFormatDescriptor = getDataFormatDescriptor(format);
+	const uint32_t blockSize = getBlockSize(format);
+
+	Header header{};
+	std::copy_n(IDENTIFIER, sizeof(IDENTIFIER), header.identifier);
+	header.vkFormat = uint32_t(format);
+	header.typeSize = 1;
+	header.pixelWidth = extent.width;
+	header.pixelHeight = extent.height;
+	header.faceCount = 1;
+	header.levelCount = uint32_t(levels.size());
+	header.dfdByteOffset = uint32_t(sizeof(Header) + levels.size() * sizeof(LevelIndex));
+	header.dfdByteLength = uint32_t(dataFormatDescriptor.size() * sizeof(uint32_t));
+
+	// levels are stored from the smallest one, each is aligned by block size
+	std::vector<LevelIndex> levelIndices(levels.size());
+	uint64_t offset = header.dfdByteOffset + header.dfdByteLength;
+	for (size_t i = levels.size(); i-- > 0;)
+	{
+		assert(levels[i].size() == getLevelSize(format, getLevelExtent(extent, uint32_t(i))));
+
+		offset = (offset + blockSize - 1) / blockSize * blockSize;
+		levelIndices[i] = { offset, levels[i].size(), levels[i].size() };
+		offset += levels[i].size();
+	}
+
+	std::ofstream stream(File::getAbsolute(path), std::ios::binary | std::ios::trunc);
+	if (!stream.is_open())
+	{
+		return false;
+	}
+
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	stream.write(reinterpret_cast<const char*>(levelIndices.data()), levelIndices.size() * sizeof(LevelIndex));
+	stream.write(reinterpret_cast<const char*>(dataFormatDescriptor.data()), header.dfdByteLength);
+
+	for (size_t i = levels.size(); i-- > 0;)
+	{
+		const std::vector<char> padding(size_t(levelIndices[i].byteOffset - uint64_t(stream.tellp())), 0);
+		stream.write(padding.data(), padding.size());
+		stream.write(reinterpret_cast<const char*>(levels[i].data()), levels[i].size());
+	}
+
+	return stream.good();
+}
+
+uint32_t KtxFile::getBlockSize(VkFormat format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+	case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+	case VK_FORMAT_BC4_UNORM_BLOCK:
+	case VK_FORMAT_BC4_SNORM_BLOCK:
+		return 8;
+	case VK_FORMAT_BC2_UNORM_BLOCK:
+	case VK_FORMAT_BC2_SRGB_BLOCK:
+	case VK_FORMAT_BC3_UNORM_BLOCK:
+	case VK_FORMAT_BC3_SRGB_BLOCK:
+	case VK_FORMAT_BC5_UNORM_BLOCK:
+	case VK_FORMAT_BC5_SNORM_BLOCK:
+	case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+	case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+	case VK_FORMAT_BC7_UNORM_BLOCK:
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		return 16;
+	default:
+		return 0;
+	}
+}
+
+VkDeviceSize KtxFile::getLevelSize(VkFormat format, VkExtent2D extent)
+{
+	const VkDeviceSize blocksX = (extent.width + 3) / 4;
+	const VkDeviceSize blocksY = (extent.height + 3) / 4;
+
+	return blocksX * blocksY * getBlockSize(format);
+}
+
+// private:
+
+const uint8_t KtxFile::IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+const KtxFile::Header* KtxFile::getHeader() const
+{
+	return reinterpret_cast<const Header*>(file->getData());
+}
+
+const KtxFile::LevelIndex* KtxFile::getLevelIndices() const
+{
+	return reinterpret_cast<const LevelIndex*>(reinterpret_cast<const uint8_t*>(file->getData()) + sizeof(Header));
+}
+
+bool KtxFile::checkLayout() const
+{
+	const uint64_t size = file->getSize();
+	if (size < sizeof(Header))
+	{
+		return false;
+	}
+
+	const Header *header = getHeader();
+	if (!std::equal(IDENTIFIER, IDENTIFIER + sizeof(IDENTIFIER), header->identifier))
+	{
+		return false;
+	}
+
+	// only single 2D image with mip chain stored in file is supported
+	if (getBlockSize(VkFormat(header->vkFormat)) == 0
+		|| header->supercompressionScheme != 0
+		|| header->pixelWidth == 0
+		|| header->pixelHeight == 0
+		|| header->pixelDepth != 0
+		|| header->layerCount > 1
+		|| header->faceCount != 1
+		|| header->levelCount == 0
+		|| sizeof(Header) + header->levelCount * sizeof(LevelIndex) > size)
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < header->levelCount; i++)
+	{
+		const LevelIndex &levelIndex = getLevelIndices()[i];
+		const VkDeviceSize levelSize = getLevelSize(VkFormat(header->vkFormat), getLevelExtent(getExtent(), i));
+
+		if (levelIndex.byteLength != levelSize || levelIndex.byteOffset + levelIndex.byteLength > size)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+VkExtent2D KtxFile::getLevelExtent(VkExtent2D extent, uint32_t level)
+{
+	return { std::max(extent.width >> level, 1u), std::max(extent.height >> level, 1u) };
+}
+
+std::vector<uint32_t> KtxFile::getDataFormatDescriptor(VkFormat format)
+{
+	// color models and channels of Khronos data format specification
+	const uint32_t KHR_DF_MODEL_BC1A = 128;
+	const uint32_t KHR_DF_MODEL_BC4 = 131;
+	const uint32_t KHR_DF_MODEL_BC5 = 132;
+	const uint32_t KHR_DF_PRIMARIES_BT709 = 1;
+	const uint32_t KHR_DF_TRANSFER_LINEAR = 1;
+
+	uint32_t model;
+	uint32_t sampleCount;
+	switch (format)
+	{
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+		model = KHR_DF_MODEL_BC1A;
+		sampleCount = 1;
+		break;
+	case VK_FORMAT_BC4_UNORM_BLOCK:
+		model = KHR_DF_MODEL_BC4;
+		sampleCount = 1;
+		break;
+	case VK_FORMAT_BC5_UNORM_BLOCK:
+		model = KHR_DF_MODEL_BC5;
+		sampleCount = 2;
+		break;
+	default:
+		throw std::invalid_argument("Unsupported format of KTX2 file");
+	}
+
+	const uint32_t blockByteSize = 24 + 16 * sampleCount;
+
+	std::vector<uint32_t> descriptor{
+		4 + blockByteSize,
+		0,
+		2 | blockByteSize << 16,
+		model | KHR_DF_PRIMARIES_BT709 << 8 | KHR_DF_TRANSFER_LINEAR << 16,
+		3 | 3 << 8,
+		getBlockSize(format),
+		0
+	};
+
+	// each sample is 64 bits of one channel
+	for (uint32_t i = 0; i < sampleCount; i++)
+	{
+		descriptor.push_back(i * 64 | 63 << 16 | i << 24);
+		descriptor.push_back(0);
+		descriptor.push_back(0);
+		descriptor.push_back(UINT32_MAX);
+	}
+
+	return descriptor;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+// KTX2 file with mip chain of one 2D image of block compressed format which is mapped into memory,
+// supercompressed files aren't supported
+class KtxFile
+{
+public:
+	struct Level
+	{
+		const void *data;
+		VkDeviceSize size;
+		VkExtent2D extent;
+	};
+
+	// file is invalid if it can't be opened or its content isn't supported
+	KtxFile(const std::string &path);
+
+	~KtxFile();
+
+	KtxFile(const KtxFile&) = delete;
+
+	KtxFile& operator=(const KtxFile&) = delete;
+
+	bool isValid() const;
+
+	VkFormat getFormat() const;
+
+	VkExtent2D getExtent() const;
+
+	uint32_t getLevelCount() const;
+
+	// level 0 is the largest one
+	Level getLevel(uint32_t index) const;
+
+	// writes file of BC1, BC4 or BC5 format, returns false if file can't be written
+	static bool save(
+		const std::string &path,
+		VkFormat format,
+		VkExtent2D extent,
+		const std::vector<std::vector<uint8_t>> &levels);
+
+	// returns size of 4x4 block or zero if format isn't block compressed
+	static uint32_t getBlockSize(VkFormat format);
+
+	static VkDeviceSize getLevelSize(VkFormat format, VkExtent2D extent);
+
+private:
+	static const uint8_t IDENTIFIER[12];
+
+	struct Header
+	{
+		uint8_t identifier[12];
+		uint32_t vkFormat;
+		uint32_t typeSize;
+		uint32_t pixelWidth;
+		uint32_t pixelHeight;
+		uint32_t pixelDepth;
+		uint32_t layerCount;
+		uint32_t faceCount;
+		uint32_t levelCount;
+		uint32_t supercompressionScheme;
+		uint32_t dfdByteOffset;
+		uint32_t dfdByteLength;
+		uint32_t kvdByteOffset;
+		uint32_t kvdByteLength;
+		uint64_t sgdByteOffset;
+		uint64_t sgdByteLength;
+	};
+
+	struct LevelIndex
+	{
+		uint64_t byteOffset;
+		uint64_t byteLength;
+		uint64_t uncompressedByteLength;
+	};
+
+	MappedFile *file = nullptr;
+
+	bool valid = false;
+
+	const Header* getHeader() const;
+
+	const LevelIndex* getLevelIndices() const;
+
+	bool checkLayout() const;
+
+	static VkExtent2D getLevelExtent(VkExtent2D extent, uint32_t level);
+
+	// basic data format descriptor of format
+	static std::vector<uint32_t> getDataFormatDescriptor(VkFormat format);
+};
+
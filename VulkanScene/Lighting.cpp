@@ -3,9 +3,9 @@
 
 #include "Lighting.h"
 
-Lighting::Lighting(Device *device, Attributes attributes) : attributes(attributes)
+Lighting::Lighting(Device *device, Attributes attributes, uint32_t frameCount) : attributes(attributes)
 {
-	attributesBuffer = new Buffer(device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof attributes);
+	attributesBuffer = new UniformRing(device, sizeof attributes, frameCount);
 	attributesBuffer->updateData(&attributes, sizeof attributes, 0);
 }
 
@@ -19,13 +19,17 @@ glm::vec3 Lighting::getDirection() const
 	return attributes.direction;
 }
 
-Buffer* Lighting::getAttributesBuffer() const
+UniformRing* Lighting::getAttributesBuffer() const
 {
 	return attributesBuffer;
 }
 
-void Lighting::update(glm::vec3 cameraPos)
+void Lighting::update(glm::vec3 cameraPos, uint32_t frameIndex)
 {
 	attributes.cameraPos = cameraPos;
-	attributesBuffer->updateData(&attributes.cameraPos, sizeof attributes.cameraPos, offsetof(Attributes, cameraPos));
+	attributesBuffer->updateFrameData(
+		&attributes.cameraPos,
+		sizeof attributes.cameraPos,
+		offsetof(Attributes, cameraPos),
+		frameIndex);
 }
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
-#include "Buffer.h"
+#include "UniformRing.h"
 
 class Lighting
 {
@@ -21,17 +21,18 @@ public:
 		float specularPower;
 	};
 
-	Lighting(Device *device, Attributes attributes);
+	Lighting(Device *device, Attributes attributes, uint32_t frameCount);
 	~Lighting();
 
 	glm::vec3 getDirection() const;
 
-	Buffer* getAttributesBuffer() const;
+	UniformRing* getAttributesBuffer() const;
 
-	void update(glm::vec3 cameraPos);
+	// writes camera position into slice of this frame
+	void update(glm::vec3 cameraPos, uint32_t frameIndex);
 
 private:
 	Attributes attributes;
 
-	Buffer *attributesBuffer;
+	UniformRing *attributesBuffer;
 };
@@ -4,10 +4,10 @@
 
 // public:
 
-LightingRenderPass::LightingRenderPass(Device *device, SwapChain *swapChain)
-    : RenderPass(device, swapChain->getExtent(), device->getSampleCount())
+LightingRenderPass::LightingRenderPass(Device *device, RenderTarget *renderTarget)
+    : RenderPass(device, renderTarget->getExtent(), device->getSampleCount())
 {
-	colorAttachmentFormat = swapChain->getImageFormat();
+	colorAttachmentFormat = renderTarget->getImageFormat();
 }
 
 std::shared_ptr<Image> LightingRenderPass::getColorImage() const
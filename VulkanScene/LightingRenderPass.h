@@ -1,12 +1,12 @@
 #pragma once
 
 #include "RenderPass.h"
-#include "SwapChain.h"
+#include "RenderTarget.h"
 
 class LightingRenderPass : public RenderPass
 {
 public:
-	LightingRenderPass(Device *device, SwapChain *swapChain);
+	LightingRenderPass(Device *device, RenderTarget *renderTarget);
 
 	std::shared_ptr<Image> getColorImage() const;
 
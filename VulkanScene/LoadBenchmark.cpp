@@ -0,0 +1,129 @@
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+#include "File.h"
+#include "Engine.h"
+
+#include "LoadBenchmark.h"
+
+// public:
+
+LoadBenchmark::LoadBenchmark(Settings settings, const std::string &modelPath, uint32_t modelCount)
+	: settings(settings), baseScenePath(settings.scenePath), modelPath(modelPath), modelCount(modelCount)
+{
+	this->settings.scenePath = SCENE_PATH;
+}
+
+void LoadBenchmark::run(const std::string &reportPath)
+{
+	saveScene();
+
+	// first load cooks mesh cache, so it also measures import by assimp
+	const double cookTime = loadModels(0);
+
+	nlohmann::json report;
+	report["modelPath"] = modelPath;
+	report["modelCount"] = modelCount;
+	report["hardwareConcurrency"] = std::thread::hardware_concurrency();
+	report["cookTime"] = cookTime;
+	report["textureMemory"] = lastStartupStatistics.textureMemory;
+	report["memory"] = {
+		{ "blockCount", lastStartupStatistics.memory.blockCount },
+		{ "reservedBytes", lastStartupStatistics.memory.blockBytes },
+		{ "usedBytes", lastStartupStatistics.memory.usedBytes },
+		{ "staticBufferBytes", lastStartupStatistics.staticBufferSize }
+	};
+	report["runs"] = nlohmann::json::array();
+
+	double singleThreadTime = 0;
+	for (auto threadCount : getThreadCounts())
+	{
+		std::vector<double> times;
+		for (uint32_t i = 0; i < RUN_COUNT; i++)
+		{
+			times.push_back(loadModels(threadCount));
+		}
+
+		const double bestTime = *std::min_element(times.begin(), times.end());
+		if (threadCount == 1)
+		{
+			singleThreadTime = bestTime;
+		}
+
+		report["runs"].push_back({
+			{ "threadCount", threadCount },
+			{ "times", times },
+			{ "bestTime", bestTime },
+			{ "speedup", singleThreadTime / bestTime }
+		});
+	}
+
+	std::ofstream stream(File::getAbsolute(reportPath));
+	stream << report.dump(4);
+
+	std::cout << "Load benchmark: " << report["runs"].dump(4) << std::endl;
+}
+
+// private:
+
+void LoadBenchmark::saveScene() const
+{
+	std::ifstream stream(File::getAbsolute(baseScenePath));
+	nlohmann::json scene;
+	stream >> scene;
+
+	// models are placed in square grid
+	const auto gridSize = uint32_t(std::ceil(std::sqrt(float(modelCount))));
+
+	scene["models"] = nlohmann::json::object();
+	for (uint32_t i = 0; i < modelCount; i++)
+	{
+		nlohmann::json move;
+		move["type"] = "MOVE";
+		move["distance"]["x"] = float(i % gridSize) * MODEL_SPACING;
+		move["distance"]["y"] = 0.0f;
+		move["distance"]["z"] = float(i / gridSize) * MODEL_SPACING;
+
+		nlohmann::json model;
+		model["path"] = modelPath;
+		model["transformations"] = nlohmann::json::array({ move });
+
+		scene["models"]["model" + std::to_string(i)] = model;
+	}
+
+	const std::string sceneString = scene.dump(4);
+	if (!File::writeBytes(SCENE_PATH, std::vector<char>(sceneString.begin(), sceneString.end())))
+	{
+		throw std::runtime_error("Failed to write benchmark scene: " + SCENE_PATH);
+	}
+}
+
+double LoadBenchmark::loadModels(uint32_t threadCount)
+{
+	Settings runSettings = settings;
+	runSettings.loadingThreadCount = threadCount;
+
+	const Engine engine({ 640, 360 }, 1, runSettings);
+	lastStartupStatistics = engine.getStartupStatistics();
+
+	return engine.getModelsLoadingTime();
+}
+
+std::vector<uint32_t> LoadBenchmark::getThreadCounts()
+{
+	const uint32_t hardwareConcurrency = std::max(std::thread::hardware_concurrency(), 1u);
+
+	std::vector<uint32_t> threadCounts;
+	for (uint32_t threadCount = 1; threadCount < hardwareConcurrency; threadCount *= 2)
+	{
+		threadCounts.push_back(threadCount);
+	}
+	threadCounts.push_back(hardwareConcurrency);
+
+	return threadCounts;
+}
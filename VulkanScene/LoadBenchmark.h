@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include "Engine.h"
+#include "Settings.h"
+
+// loads synthetic scene with many models (copies of one source model) by offscreen engine
+// with different counts of loading threads and reports models loading times
+class LoadBenchmark
+{
+public:
+	LoadBenchmark(Settings settings, const std::string &modelPath, uint32_t modelCount);
+
+	// writes json report
+	void run(const std::string &reportPath);
+
+private:
+	const std::string SCENE_PATH = "Cache/LoadBenchmarkScene.json";
+
+	// best of runs is reported for each thread count
+	const uint32_t RUN_COUNT = 3;
+
+	// distance between models in grid
+	const float MODEL_SPACING = 10.0f;
+
+	Settings settings;
+
+	// lighting, camera, skybox and terrain are taken from this scene
+	std::string baseScenePath;
+
+	std::string modelPath;
+
+	uint32_t modelCount;
+
+	// texture memory is less if textures are cooked
+	Engine::StartupStatistics lastStartupStatistics{};
+
+	// copy of settings scene where models are replaced by copies of benchmark model
+	void saveScene() const;
+
+	// milliseconds
+	double loadModels(uint32_t threadCount);
+
+	// powers of two and hardware concurrency
+	static std::vector<uint32_t> getThreadCounts();
+};
+
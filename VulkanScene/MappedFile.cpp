@@ -0,0 +1,109 @@
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "File.h"
+
+#include "MappedFile.h"
+
+// public:
+
+MappedFile::MappedFile(const std::string &path)
+{
+#ifdef _WIN32
+	const HANDLE fileHandle = CreateFile(
+		File::getAbsolute(path).c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+		nullptr);
+
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+	file = fileHandle;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		return;
+	}
+
+	mapping = CreateFileMapping(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		return;
+	}
+
+	data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data)
+	{
+		size = size_t(fileSize.QuadPart);
+	}
+#else
+	const int descriptor = open(File::getAbsolute(path).c_str(), O_RDONLY);
+	if (descriptor == -1)
+	{
+		return;
+	}
+
+	// mapping stays valid after descriptor is closed
+	struct stat fileStat;
+	if (fstat(descriptor, &fileStat) == 0 && fileStat.st_size > 0)
+	{
+		void *mappedData = mmap(nullptr, size_t(fileStat.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if (mappedData != MAP_FAILED)
+		{
+			data = mappedData;
+			size = size_t(fileStat.st_size);
+		}
+	}
+
+	close(descriptor);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	if (data)
+	{
+		UnmapViewOfFile(data);
+	}
+	if (mapping)
+	{
+		CloseHandle(mapping);
+	}
+	if (file)
+	{
+		CloseHandle(file);
+	}
+#else
+	if (data)
+	{
+		munmap(const_cast<void*>(data), size);
+	}
+#endif
+}
+
+bool MappedFile::isOpen() const
+{
+	return data != nullptr;
+}
+
+const void* MappedFile::getData() const
+{
+	return data;
+}
+
+size_t MappedFile::getSize() const
+{
+	return size;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+
+// read only mapping of whole file into memory
+class MappedFile
+{
+public:
+	// path is relative to base directory, mapping is empty if file can't be opened
+	MappedFile(const std::string &path);
+
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool isOpen() const;
+
+	const void* getData() const;
+
+	size_t getSize() const;
+
+private:
+	// handles are used only on Windows, descriptor is closed right after mapping elsewhere
+	void *file = nullptr;
+
+	void *mapping = nullptr;
+
+	const void *data = nullptr;
+
+	size_t size = 0;
+};
+
@@ -93,30 +93,47 @@ bool Material::solid() const
 	return colors.opacity == 1.0f; // && textures.at(aiTextureType_OPACITY) == defaultTextures.at(aiTextureType_OPACITY);
 }
 
+bool Material::alphaTested() const
+{
+	return !solid() || textures.at(aiTextureType_OPACITY) != defaultTextures.at(aiTextureType_OPACITY);
+}
+
 void Material::addTexture(aiTextureType type, TextureImage *texture)
 {
 	textures.at(type) = texture;
 }
 
-void Material::initDescriptorSet(DescriptorPool *descriptorPool)
+void Material::initDescriptorSets(DescriptorPool *descriptorPool, uint32_t frameCount)
 {
+	this->descriptorPool = descriptorPool;
+
     const std::vector<VkShaderStageFlags> texturesShaderStages(textures.size(), VK_SHADER_STAGE_FRAGMENT_BIT);
 
     if (dsLayout == nullptr)
     {
-		dsLayout = descriptorPool->createDescriptorSetLayout({ VK_SHADER_STAGE_FRAGMENT_BIT }, texturesShaderStages);
+		dsLayout = descriptorPool->createDescriptorSetLayout({ VK_SHADER_STAGE_FRAGMENT_BIT }, {}, texturesShaderStages);
     }
 
-	descriptorSet = descriptorPool->getDescriptorSet(dsLayout);
+	descriptorSets.resize(frameCount);
+	for (uint32_t i = 0; i < frameCount; i++)
+	{
+		descriptorSets[i] = descriptorPool->getDescriptorSet(dsLayout);
+		updateDescriptorSet(i);
+	}
+}
+
+void Material::updateDescriptorSet(uint32_t frameIndex)
+{
 	descriptorPool->updateDescriptorSet(
-		descriptorSet,
+		descriptorSets[frameIndex],
 		{ colorsBuffer },
+		{},
 		getTextures());
 }
 
-VkDescriptorSet Material::getDescriptorSet() const
+VkDescriptorSet Material::getDescriptorSet(uint32_t frameIndex) const
 {
-	return descriptorSet;
+	return descriptorSets[frameIndex];
 }
 
 VkDescriptorSetLayout Material::getDsLayout()
@@ -35,11 +35,19 @@ public:
 
 	bool solid() const;
 
+	// fragments with low opacity are discarded by alpha test (in depth pass too)
+	bool alphaTested() const;
+
 	void addTexture(aiTextureType type, TextureImage *texture);
 
-	void initDescriptorSet(DescriptorPool *descriptorPool);
+	// each frame in flight has its own descriptor set, so images of streamed textures
+	// can be replaced in descriptor set of one frame while other frames are rendered
+	void initDescriptorSets(DescriptorPool *descriptorPool, uint32_t frameCount);
+
+	// writes current images of textures into descriptor set of this frame
+	void updateDescriptorSet(uint32_t frameIndex);
 
-	VkDescriptorSet getDescriptorSet() const;
+	VkDescriptorSet getDescriptorSet(uint32_t frameIndex) const;
 
 	static VkDescriptorSetLayout getDsLayout();
 
@@ -56,7 +64,9 @@ private:
 
 	std::unordered_map<aiTextureType, TextureImage*> textures;
 
-	VkDescriptorSet descriptorSet;
+	DescriptorPool *descriptorPool;
+
+	std::vector<VkDescriptorSet> descriptorSets;
 
 	static uint32_t objectCount;
 
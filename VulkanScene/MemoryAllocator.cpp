@@ -0,0 +1,312 @@
+#include <cassert>
+#include <algorithm>
+#include "Device.h"
+
+#include "MemoryAllocator.h"
+
+// public:
+
+MemoryAllocator::MemoryAllocator(Device *device) : device(device)
+{
+	memoryProperties = device->getMemoryProperties();
+}
+
+MemoryAllocator::~MemoryAllocator()
+{
+	for (auto &pool : pools)
+	{
+		for (auto &block : pool.blocks)
+		{
+			destroyBlock(block);
+		}
+	}
+}
+
+MemoryAllocation MemoryAllocator::allocate(VkBuffer buffer, VkMemoryPropertyFlags properties, Strategy strategy)
+{
+	VkMemoryRequirements requirements;
+	vkGetBufferMemoryRequirements(device->get(), buffer, &requirements);
+
+	MemoryAllocation allocation = allocate(requirements, properties, false, strategy);
+
+	const VkResult result = vkBindBufferMemory(device->get(), buffer, allocation.memory, allocation.offset);
+	assert(result == VK_SUCCESS);
+
+	return allocation;
+}
+
+MemoryAllocation MemoryAllocator::allocate(VkImage image, VkImageTiling tiling, VkMemoryPropertyFlags properties)
+{
+	VkMemoryRequirements requirements;
+	vkGetImageMemoryRequirements(device->get(), image, &requirements);
+
+	MemoryAllocation allocation = allocate(requirements, properties, tiling == VK_IMAGE_TILING_OPTIMAL, FREE_LIST);
+
+	const VkResult result = vkBindImageMemory(device->get(), image, allocation.memory, allocation.offset);
+	assert(result == VK_SUCCESS);
+
+	return allocation;
+}
+
+void MemoryAllocator::free(const MemoryAllocation &allocation)
+{
+	Pool &pool = pools[allocation.poolIndex];
+
+	const auto it = std::find_if(
+		pool.blocks.begin(),
+		pool.blocks.end(),
+		[&allocation](const Block &block) { return block.memory == allocation.memory; });
+	assert(it != pool.blocks.end());
+
+	freeInBlock(*it, pool.strategy, allocation.offset, allocation.size);
+
+	// empty blocks are released, but one block of pool is kept to avoid reallocation
+	if (it->allocationCount == 0 && pool.blocks.size() > 1)
+	{
+		destroyBlock(*it);
+		pool.blocks.erase(it);
+	}
+}
+
+void MemoryAllocator::releaseEmptyBlocks()
+{
+	for (auto &pool : pools)
+	{
+		for (auto &block : pool.blocks)
+		{
+			if (block.allocationCount == 0)
+			{
+				destroyBlock(block);
+			}
+		}
+
+		pool.blocks.erase(
+			std::remove_if(
+				pool.blocks.begin(),
+				pool.blocks.end(),
+				[](const Block &block) { return block.allocationCount == 0; }),
+			pool.blocks.end());
+	}
+}
+
+MemoryStats MemoryAllocator::getStats() const
+{
+	MemoryStats stats{};
+
+	for (const auto &pool : pools)
+	{
+		for (const auto &block : pool.blocks)
+		{
+			stats.blockCount++;
+			stats.allocationCount += block.allocationCount;
+			stats.blockBytes += block.size;
+
+			if (pool.strategy == LINEAR)
+			{
+				stats.usedBytes += block.linearOffset;
+			}
+			else
+			{
+				VkDeviceSize freeBytes = 0;
+				for (const auto &[offset, size] : block.freeRanges)
+				{
+					freeBytes += size;
+				}
+				stats.usedBytes += block.size - freeBytes;
+			}
+		}
+	}
+
+	return stats;
+}
+
+// private:
+
+MemoryAllocation MemoryAllocator::allocate(
+	VkMemoryRequirements requirements,
+	VkMemoryPropertyFlags properties,
+	bool optimalImage,
+	Strategy strategy)
+{
+	const uint32_t memoryTypeIndex = device->findMemoryTypeIndex(requirements.memoryTypeBits, properties);
+	const uint32_t poolIndex = getPoolIndex(memoryTypeIndex, optimalImage, strategy);
+	Pool &pool = pools[poolIndex];
+
+	VkDeviceSize offset = 0;
+	Block *block = nullptr;
+
+	for (auto &poolBlock : pool.blocks)
+	{
+		if (allocateInBlock(poolBlock, strategy, requirements, offset))
+		{
+			block = &poolBlock;
+			break;
+		}
+	}
+
+	if (block == nullptr)
+	{
+		// resources larger than block size get their own block
+		pool.blocks.push_back(createBlock(memoryTypeIndex, std::max(BLOCK_SIZE, requirements.size)));
+		block = &pool.blocks.back();
+
+		const bool allocated = allocateInBlock(*block, strategy, requirements, offset);
+		assert(allocated);
+	}
+
+	void *mappedData = nullptr;
+	if (block->mappedData != nullptr)
+	{
+		mappedData = reinterpret_cast<uint8_t*>(block->mappedData) + offset;
+	}
+
+	return MemoryAllocation{
+		block->memory,
+		offset,
+		requirements.size,
+		mappedData,
+		poolIndex
+	};
+}
+
+uint32_t MemoryAllocator::getPoolIndex(uint32_t memoryTypeIndex, bool optimalImages, Strategy strategy)
+{
+	for (uint32_t i = 0; i < pools.size(); i++)
+	{
+		if (pools[i].memoryTypeIndex == memoryTypeIndex
+			&& pools[i].optimalImages == optimalImages
+			&& pools[i].strategy == strategy)
+		{
+			return i;
+		}
+	}
+
+	pools.push_back({ memoryTypeIndex, optimalImages, strategy, {} });
+
+	return uint32_t(pools.size() - 1);
+}
+
+MemoryAllocator::Block MemoryAllocator::createBlock(uint32_t memoryTypeIndex, VkDeviceSize size) const
+{
+	Block block{};
+	block.size = size;
+	block.freeRanges.insert({ 0, size });
+
+	VkMemoryAllocateInfo allocInfo{
+		VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+		nullptr,
+		size,
+		memoryTypeIndex,
+	};
+
+	VkResult result = vkAllocateMemory(device->get(), &allocInfo, nullptr, &block.memory);
+	assert(result == VK_SUCCESS);
+
+	// host visible blocks are mapped for whole lifetime,
+	// because the same memory object can't be mapped twice
+	const VkMemoryPropertyFlags flags = memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+	if (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+	{
+		result = vkMapMemory(device->get(), block.memory, 0, VK_WHOLE_SIZE, 0, &block.mappedData);
+		assert(result == VK_SUCCESS);
+	}
+
+	return block;
+}
+
+void MemoryAllocator::destroyBlock(Block &block) const
+{
+	if (block.mappedData != nullptr)
+	{
+		vkUnmapMemory(device->get(), block.memory);
+	}
+	vkFreeMemory(device->get(), block.memory, nullptr);
+}
+
+bool MemoryAllocator::allocateInBlock(Block &block, Strategy strategy, VkMemoryRequirements requirements, VkDeviceSize &offset)
+{
+	if (strategy == LINEAR)
+	{
+		const VkDeviceSize alignedOffset = alignOffset(block.linearOffset, requirements.alignment);
+		if (alignedOffset + requirements.size > block.size)
+		{
+			return false;
+		}
+
+		offset = alignedOffset;
+		block.linearOffset = alignedOffset + requirements.size;
+		block.allocationCount++;
+
+		return true;
+	}
+
+	// first fit
+	for (const auto [rangeOffset, rangeSize] : block.freeRanges)
+	{
+		const VkDeviceSize alignedOffset = alignOffset(rangeOffset, requirements.alignment);
+		const VkDeviceSize rangeEnd = rangeOffset + rangeSize;
+
+		if (alignedOffset + requirements.size <= rangeEnd)
+		{
+			block.freeRanges.erase(rangeOffset);
+
+			// alignment padding stays free
+			if (alignedOffset > rangeOffset)
+			{
+				block.freeRanges.insert({ rangeOffset, alignedOffset - rangeOffset });
+			}
+			if (alignedOffset + requirements.size < rangeEnd)
+			{
+				block.freeRanges.insert({ alignedOffset + requirements.size, rangeEnd - alignedOffset - requirements.size });
+			}
+
+			offset = alignedOffset;
+			block.allocationCount++;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void MemoryAllocator::freeInBlock(Block &block, Strategy strategy, VkDeviceSize offset, VkDeviceSize size)
+{
+	assert(block.allocationCount > 0);
+	block.allocationCount--;
+
+	if (strategy == LINEAR)
+	{
+		if (block.allocationCount == 0)
+		{
+			block.linearOffset = 0;
+		}
+		return;
+	}
+
+	auto it = block.freeRanges.insert({ offset, size }).first;
+
+	// merge with next range
+	const auto next = std::next(it);
+	if (next != block.freeRanges.end() && it->first + it->second == next->first)
+	{
+		it->second += next->second;
+		block.freeRanges.erase(next);
+	}
+
+	// merge with previous range
+	if (it != block.freeRanges.begin())
+	{
+		const auto previous = std::prev(it);
+		if (previous->first + previous->second == it->first)
+		{
+			previous->second += it->second;
+			block.freeRanges.erase(it);
+		}
+	}
+}
+
+VkDeviceSize MemoryAllocator::alignOffset(VkDeviceSize offset, VkDeviceSize alignment)
+{
+	return (offset + alignment - 1) / alignment * alignment;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <map>
+
+class Device;
+
+// part of device memory block bound to buffer or image
+struct MemoryAllocation
+{
+	VkDeviceMemory memory;
+
+	VkDeviceSize offset;
+
+	VkDeviceSize size;
+
+	// pointer to allocation data if memory is host visible (otherwise nullptr)
+	void *mappedData;
+
+	uint32_t poolIndex;
+};
+
+struct MemoryStats
+{
+	// count of vkAllocateMemory calls that are alive
+	uint32_t blockCount;
+
+	uint32_t allocationCount;
+
+	VkDeviceSize blockBytes;
+
+	VkDeviceSize usedBytes;
+};
+
+// allocates big blocks of device memory and divides them between buffers and images,
+// linear resources (buffers, linear images) and optimal images are kept in separate pools,
+// so neighbouring resources never conflict because of bufferImageGranularity
+class MemoryAllocator
+{
+public:
+	enum Strategy
+	{
+		// allocations can be freed in any order, free space is reused
+		FREE_LIST,
+
+		// allocations are placed one after another,
+		// block space is reused only when all its allocations are freed
+		LINEAR
+	};
+
+	const VkDeviceSize BLOCK_SIZE = 64 * 1024 * 1024;
+
+	MemoryAllocator(Device *device);
+
+	~MemoryAllocator();
+
+	// allocates memory for buffer and binds it
+	MemoryAllocation allocate(VkBuffer buffer, VkMemoryPropertyFlags properties, Strategy strategy = FREE_LIST);
+
+	// allocates memory for image and binds it
+	MemoryAllocation allocate(VkImage image, VkImageTiling tiling, VkMemoryPropertyFlags properties);
+
+	void free(const MemoryAllocation &allocation);
+
+	// releases blocks without allocations (including transient upload arena after loading)
+	void releaseEmptyBlocks();
+
+	MemoryStats getStats() const;
+
+private:
+	struct Block
+	{
+		VkDeviceMemory memory;
+
+		VkDeviceSize size;
+
+		void *mappedData;
+
+		uint32_t allocationCount;
+
+		// free ranges of free list block (offset -> size)
+		std::map<VkDeviceSize, VkDeviceSize> freeRanges;
+
+		// end of last allocation of linear block
+		VkDeviceSize linearOffset;
+	};
+
+	struct Pool
+	{
+		uint32_t memoryTypeIndex;
+
+		bool optimalImages;
+
+		Strategy strategy;
+
+		std::vector<Block> blocks;
+	};
+
+	Device *device;
+
+	VkPhysicalDeviceMemoryProperties memoryProperties;
+
+	std::vector<Pool> pools;
+
+	MemoryAllocation allocate(
+		VkMemoryRequirements requirements,
+		VkMemoryPropertyFlags properties,
+		bool optimalImage,
+		Strategy strategy);
+
+	uint32_t getPoolIndex(uint32_t memoryTypeIndex, bool optimalImages, Strategy strategy);
+
+	Block createBlock(uint32_t memoryTypeIndex, VkDeviceSize size) const;
+
+	void destroyBlock(Block &block) const;
+
+	// returns false if block doesn't have enough space
+	static bool allocateInBlock(Block &block, Strategy strategy, VkMemoryRequirements requirements, VkDeviceSize &offset);
+
+	static void freeInBlock(Block &block, Strategy strategy, VkDeviceSize offset, VkDeviceSize size);
+
+	static VkDeviceSize alignOffset(VkDeviceSize offset, VkDeviceSize alignment);
+};
+
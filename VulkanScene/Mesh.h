@@ -2,8 +2,8 @@
 
 #include "Vertex.h"
 #include <vector>
+#include <limits>
 #include "Material.h"
-#include "Buffer.h"
 #include <vulkan/vulkan.h>
 #include "MeshBase.h"
 
@@ -11,7 +11,7 @@ template <class T>
 class Mesh : public MeshBase
 {
 public:
-    Mesh(Device *device, const std::vector<T> &vertices, const std::vector<uint32_t> &indices, Material *material);
+    Mesh(GeometryArena *geometryArena, const std::vector<T> &vertices, const std::vector<uint32_t> &indices, Material *material);
 
 	~Mesh() = default;
 
@@ -22,14 +22,20 @@ private:
 };
 
 template <class T>
-Mesh<T>::Mesh(Device *device, const std::vector<T> &vertices, const std::vector<uint32_t> &indices, Material *material)
-    : MeshBase(device, indices, material)
+Mesh<T>::Mesh(GeometryArena *geometryArena, const std::vector<T> &vertices, const std::vector<uint32_t> &indices, Material *material)
+    : MeshBase(geometryArena, { vertices.data() }, uint32_t(vertices.size()), indices.data(), uint32_t(indices.size()), material)
 {
     this->vertices = vertices;
-
-    const VkDeviceSize size = vertices.size() * sizeof T;
-	vertexBuffer = new Buffer(device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, size);
-	vertexBuffer->updateData(vertices.data(), vertices.size() * sizeof(vertices[0]), 0);
+	this->indices = indices;
+
+	glm::vec3 minPos(std::numeric_limits<float>::max());
+	glm::vec3 maxPos(-std::numeric_limits<float>::max());
+	for (const auto &vertex : vertices)
+	{
+		minPos = glm::min(minPos, vertex.pos);
+		maxPos = glm::max(maxPos, vertex.pos);
+	}
+	bounds = BoundingVolume(minPos, maxPos);
 }
 
 template <class T>
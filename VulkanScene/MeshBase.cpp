@@ -1,27 +1,33 @@
 #include "MeshBase.h"
 
-MeshBase::~MeshBase()
+Material * MeshBase::getMaterial() const
 {
-	delete vertexBuffer;
-	delete indexBuffer;
+	return material;
 }
 
-Material * MeshBase::getMaterial() const
+BoundingVolume MeshBase::getBounds() const
 {
-	return material;
+	return bounds;
 }
 
-void MeshBase::render(VkCommandBuffer commandBuffer, uint32_t instanceCount) const
+uint32_t MeshBase::getIndexCount() const
 {
-	VkDeviceSize offset = 0;
+	return indexCount;
+}
 
-	const VkBuffer vertexBuffer = this->vertexBuffer->get();
-	vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+uint32_t MeshBase::getFirstIndex() const
+{
+	return range.firstIndex;
+}
 
-    const VkBuffer indexBuffer = this->indexBuffer->get();
-	vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+int32_t MeshBase::getVertexOffset() const
+{
+	return range.vertexOffset;
+}
 
-	vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, 0, 0, 0);
+void MeshBase::render(VkCommandBuffer commandBuffer, uint32_t instanceCount, uint32_t firstInstance) const
+{
+	vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, range.firstIndex, range.vertexOffset, firstInstance);
 }
 
 void MeshBase::clearHostIndices()
@@ -29,14 +35,16 @@ void MeshBase::clearHostIndices()
 	indices.clear();
 }
 
-MeshBase::MeshBase(Device *device, const std::vector<uint32_t> &indices, Material *material)
+MeshBase::MeshBase(
+	GeometryArena *geometryArena,
+	const std::vector<const void*> &streams,
+	uint32_t vertexCount,
+	const uint32_t *indices,
+	uint32_t indexCount,
+	Material *material)
 {
-	this->indices = indices;
 	this->material = material;
+	this->indexCount = indexCount;
 
-	indexCount = uint32_t(indices.size());
-
-    const VkDeviceSize size = indexCount * sizeof uint32_t;
-	indexBuffer = new Buffer(device, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, size);
-	indexBuffer->updateData(indices.data(), indices.size() * sizeof(indices[0]), 0);
+	range = geometryArena->add(streams, vertexCount, indices, indexCount);
 }
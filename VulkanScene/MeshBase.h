@@ -1,34 +1,54 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
-#include "Buffer.h"
+#include <vector>
+#include "GeometryArena.h"
 #include "Material.h"
+#include "BoundingVolume.h"
 
 class MeshBase
 {
 public:
-	virtual ~MeshBase();
+	virtual ~MeshBase() = default;
 
 	Material* getMaterial() const;
 
-	void render(VkCommandBuffer commandBuffer, uint32_t instanceCount) const;
+	// bounds of vertices in model space
+	BoundingVolume getBounds() const;
+
+	uint32_t getIndexCount() const;
+
+	uint32_t getFirstIndex() const;
+
+	int32_t getVertexOffset() const;
+
+	// buffers of geometry arena must be bound
+	void render(VkCommandBuffer commandBuffer, uint32_t instanceCount, uint32_t firstInstance) const;
 
 	void clearHostIndices();
 
 	virtual void clearHostVertices() = 0;
 
 protected:
-	MeshBase(Device *device, const std::vector<uint32_t> &indices, Material *material);
+	// vertex streams (one pointer for each stream of arena) and indices are copied into geometry arena,
+	// indices aren't copied to host vector
+	MeshBase(
+		GeometryArena *geometryArena,
+		const std::vector<const void*> &streams,
+		uint32_t vertexCount,
+		const uint32_t *indices,
+		uint32_t indexCount,
+		Material *material);
 
 	Material *material;
 
-	Buffer *vertexBuffer;
-
-	Buffer *indexBuffer;
-
 	std::vector<uint32_t> indices;
 
 	uint32_t indexCount;
 
+	// place of vertices and indices in geometry arena
+	GeometryArena::Range range;
+
+	BoundingVolume bounds;
 };
 
@@ -0,0 +1,118 @@
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include "File.h"
+#include "Benchmark.h"
+#include "GpuProfiler.h"
+
+#include "MeshBenchmark.h"
+
+// public:
+
+MeshBenchmark::MeshBenchmark(Settings settings, VkExtent2D extent, const std::string &cameraPathFile)
+	: settings(settings), extent(extent), cameraPathFile(cameraPathFile)
+{
+}
+
+void MeshBenchmark::run(const std::string &reportPath)
+{
+	const bool enabled = MeshOptimizer::isEnabled();
+
+	const nlohmann::json unoptimizedSummary = runBenchmark(false, reportPath);
+
+	// optimizer and quantizer collect statistics of meshes while they are cooked
+	MeshOptimizer::resetStatistics();
+	VertexQuantizer::resetStatistics();
+	const nlohmann::json optimizedSummary = runBenchmark(true, reportPath);
+
+	MeshOptimizer::setEnabled(enabled);
+
+	nlohmann::json report;
+	report["cacheSize"] = MeshOptimizer::CACHE_SIZE;
+	report["vertexCache"] = {
+		{ "before", getStatisticsReport(MeshOptimizer::getInputStatistics()) },
+		{ "after", getStatisticsReport(MeshOptimizer::getOutputStatistics()) }
+	};
+	report["vertexQuantization"] = getQuantizationReport(VertexQuantizer::getStatistics());
+	report["gpuTime"] = {
+		{ GpuProfiler::getPassName(DEPTH), getPassReport(unoptimizedSummary, optimizedSummary, DEPTH) },
+		{ GpuProfiler::getPassName(GEOMETRY), getPassReport(unoptimizedSummary, optimizedSummary, GEOMETRY) }
+	};
+
+	std::ofstream stream(File::getAbsolute(reportPath));
+	stream << report.dump(4);
+
+	std::cout << "Mesh benchmark: " << report.dump(4) << std::endl;
+}
+
+// private:
+
+nlohmann::json MeshBenchmark::runBenchmark(bool optimized, const std::string &reportPath) const
+{
+	MeshOptimizer::setEnabled(optimized);
+
+	std::filesystem::path path(reportPath);
+	path.replace_extension(optimized ? ".optimized.json" : ".unoptimized.json");
+
+	Benchmark benchmark(settings, extent, cameraPathFile);
+	benchmark.run(path.string());
+
+	return benchmark.getSummary();
+}
+
+nlohmann::json MeshBenchmark::getStatisticsReport(const MeshOptimizer::Statistics &statistics)
+{
+	return {
+		{ "vertexCount", statistics.vertexCount },
+		{ "triangleCount", statistics.triangleCount },
+		{ "transformedVertexCount", statistics.transformedVertexCount },
+		{ "acmr", statistics.getAcmr() },
+		{ "atvr", statistics.getAtvr() }
+	};
+}
+
+nlohmann::json MeshBenchmark::getQuantizationReport(const VertexQuantizer::Statistics &statistics)
+{
+	const uint64_t unpackedSize = statistics.getUnpackedSize();
+	const uint64_t packedSize = statistics.getPackedSize();
+
+	// vertex fetch bandwidth is proportional to vertex stride (depth pass fetches only positions)
+	return {
+		{ "vertexCount", statistics.vertexCount },
+		{ "unpackedStride", sizeof(Vertex) },
+		{ "packedStride", sizeof(PackedVertex) },
+		{ "positionStride", sizeof(PackedVertex::Position) },
+		{ "unpackedSize", unpackedSize },
+		{ "packedSize", packedSize },
+		{ "savedSize", unpackedSize - packedSize },
+		{ "positionError", statistics.positionError },
+		{ "uvError", statistics.uvError },
+		{ "normalError", statistics.normalError },
+		{ "tangentError", statistics.tangentError },
+		{ "bitangentSignError", statistics.bitangentSignError },
+		{ "accurate", statistics.isAccurate() }
+	};
+}
+
+nlohmann::json MeshBenchmark::getPassReport(
+	const nlohmann::json &unoptimizedSummary,
+	const nlohmann::json &optimizedSummary,
+	RenderPassType type)
+{
+	const std::string key = "gpu" + GpuProfiler::getPassName(type);
+
+	// GPU profiler can be unsupported by device
+	if (!unoptimizedSummary.contains(key) || !optimizedSummary.contains(key))
+	{
+		return nullptr;
+	}
+
+	const double before = unoptimizedSummary[key]["p50"];
+	const double after = optimizedSummary[key]["p50"];
+
+	return {
+		{ "before", before },
+		{ "after", after },
+		{ "change", before > 0 ? (after - before) / before * 100.0 : 0.0 }
+	};
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <nlohmann/json.hpp>
+#include "MeshOptimizer.h"
+#include "VertexQuantizer.h"
+#include "RenderPass.h"
+#include "Settings.h"
+
+// runs benchmark along camera path with meshes cooked without and with mesh optimizer
+// and reports vertex cache statistics and GPU times of depth and geometry passes of both runs,
+// meshes are cooked again for each run (optimization flag of mesh caches doesn't match),
+// so quantization errors and vertex memory of all meshes are reported too
+class MeshBenchmark
+{
+public:
+	MeshBenchmark(Settings settings, VkExtent2D extent, const std::string &cameraPathFile);
+
+	// writes json report, reports of benchmark runs are written next to it
+	void run(const std::string &reportPath);
+
+private:
+	Settings settings;
+
+	VkExtent2D extent;
+
+	std::string cameraPathFile;
+
+	// returns summary of benchmark
+	nlohmann::json runBenchmark(bool optimized, const std::string &reportPath) const;
+
+	static nlohmann::json getStatisticsReport(const MeshOptimizer::Statistics &statistics);
+
+	static nlohmann::json getQuantizationReport(const VertexQuantizer::Statistics &statistics);
+
+	// p50 of pass in both runs and its change in percents
+	static nlohmann::json getPassReport(
+		const nlohmann::json &unoptimizedSummary,
+		const nlohmann::json &optimizedSummary,
+		RenderPassType type);
+};
+
@@ -0,0 +1,318 @@
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <cassert>
+#include <sstream>
+#include <thread>
+#include "File.h"
+#include "CpuProfiler.h"
+
+#include "MeshCache.h"
+
+// public:
+
+MeshCache::MeshCache(const std::string &sourcePath, bool optimized)
+{
+	const CpuProfiler::Scope profilerScope("MeshCache::MeshCache");
+
+	if (!File::exists(sourcePath) || !File::exists(getCachePath(sourcePath)))
+	{
+		return;
+	}
+
+	file = new MappedFile(getCachePath(sourcePath));
+
+	if (!file->isOpen() || !checkLayout())
+	{
+		return;
+	}
+
+	const Header *header = getHeader();
+
+	// caches cooked before mesh optimizer have zero flag, so they are valid only without optimization
+	if (header->optimized != uint32_t(optimized))
+	{
+		return;
+	}
+
+	const uint64_t sourceSize = std::filesystem::file_size(File::getAbsolute(sourcePath));
+	if (header->sourceSize != sourceSize)
+	{
+		return;
+	}
+
+	// source can be touched or copied without changes, so hash is checked only if time differs
+	valid = header->sourceTime == getSourceTime(sourcePath) || header->sourceHash == getSourceHash(sourcePath);
+}
+
+MeshCache::~MeshCache()
+{
+	delete file;
+}
+
+bool MeshCache::isValid() const
+{
+	return valid;
+}
+
+std::vector<MeshCache::MaterialData> MeshCache::getMaterials() const
+{
+	assert(valid);
+
+	const Header *header = getHeader();
+	const auto data = reinterpret_cast<const uint8_t*>(file->getData());
+
+	std::vector<MaterialData> materials;
+	materials.reserve(header->materialCount);
+
+	uint64_t offset = sizeof(Header);
+	for (uint32_t i = 0; i < header->materialCount; i++)
+	{
+		const auto record = reinterpret_cast<const MaterialRecord*>(data + offset);
+		offset += sizeof(MaterialRecord);
+
+		MaterialData material{ record->index, record->colors, {} };
+		for (uint32_t j = 0; j < record->textureCount; j++)
+		{
+			const auto texture = reinterpret_cast<const TextureRecord*>(data + offset);
+			offset += sizeof(TextureRecord);
+
+			material.textures.emplace_back(aiTextureType(texture->type), std::string(texture->path, strnlen(texture->path, MAX_PATH_LENGTH)));
+		}
+
+		materials.push_back(material);
+	}
+
+	return materials;
+}
+
+std::vector<MeshCache::MeshData> MeshCache::getMeshes() const
+{
+	assert(valid);
+
+	const Header *header = getHeader();
+	const auto data = reinterpret_cast<const uint8_t*>(file->getData());
+	const auto records = reinterpret_cast<const MeshRecord*>(data + header->meshTableOffset);
+
+	std::vector<MeshData> meshes;
+	meshes.reserve(header->meshCount);
+
+	for (uint32_t i = 0; i < header->meshCount; i++)
+	{
+		const MeshRecord &record = records[i];
+
+		meshes.push_back({
+			record.materialIndex,
+			reinterpret_cast<const PackedVertex::Position*>(data + record.positionOffset),
+			reinterpret_cast<const PackedVertex::Attributes*>(data + record.attributesOffset),
+			record.vertexCount,
+			reinterpret_cast<const uint32_t*>(data + record.indexOffset),
+			record.indexCount,
+			BoundingVolume(record.minPos, record.maxPos)
+		});
+	}
+
+	return meshes;
+}
+
+bool MeshCache::save(
+	const std::string &sourcePath,
+	bool optimized,
+	const std::vector<MaterialData> &materials,
+	const std::vector<MeshData> &meshes)
+{
+	const CpuProfiler::Scope profilerScope("MeshCache::save");
+
+	for (const auto &material : materials)
+	{
+		for (const auto &[type, path] : material.textures)
+		{
+			if (path.size() >= MAX_PATH_LENGTH)
+			{
+				return false;
+			}
+		}
+	}
+
+	// several models can cook the same source in parallel, so each writes its own temporary file
+	// which replaces cache when it's complete
+	std::ostringstream temporaryPath;
+	temporaryPath << File::getAbsolute(getCachePath(sourcePath)) << "." << std::this_thread::get_id() << ".tmp";
+
+	std::ofstream stream(temporaryPath.str(), std::ios::binary | std::ios::trunc);
+	if (!stream.is_open())
+	{
+		return false;
+	}
+
+	Header header{};
+	header.vertexSize = sizeof(PackedVertex);
+	header.materialCount = uint32_t(materials.size());
+	header.meshCount = uint32_t(meshes.size());
+	header.optimized = uint32_t(optimized);
+	header.sourceSize = std::filesystem::file_size(File::getAbsolute(sourcePath));
+	header.sourceTime = getSourceTime(sourcePath);
+	header.sourceHash = getSourceHash(sourcePath);
+
+	// header is written last, so file interrupted while writing is never valid
+	const Header emptyHeader{};
+	stream.write(reinterpret_cast<const char*>(&emptyHeader), sizeof(Header));
+
+	for (const auto &material : materials)
+	{
+		const MaterialRecord record{ material.index, uint32_t(material.textures.size()), material.colors };
+		stream.write(reinterpret_cast<const char*>(&record), sizeof(MaterialRecord));
+
+		for (const auto &[type, path] : material.textures)
+		{
+			TextureRecord textureRecord{};
+			textureRecord.type = uint32_t(type);
+			std::memcpy(textureRecord.path, path.c_str(), path.size());
+
+			stream.write(reinterpret_cast<const char*>(&textureRecord), sizeof(TextureRecord));
+		}
+	}
+
+	header.meshTableOffset = align(uint64_t(stream.tellp()));
+
+	std::vector<MeshRecord> records;
+	uint64_t offset = align(header.meshTableOffset + meshes.size() * sizeof(MeshRecord));
+	for (const auto &mesh : meshes)
+	{
+		MeshRecord record{};
+		record.materialIndex = mesh.materialIndex;
+		record.vertexCount = mesh.vertexCount;
+		record.indexCount = mesh.indexCount;
+		record.positionOffset = offset;
+		record.attributesOffset = align(record.positionOffset + mesh.vertexCount * sizeof(PackedVertex::Position));
+		record.indexOffset = align(record.attributesOffset + mesh.vertexCount * sizeof(PackedVertex::Attributes));
+		record.minPos = mesh.bounds.getMin();
+		record.maxPos = mesh.bounds.getMax();
+
+		offset = align(record.indexOffset + mesh.indexCount * sizeof(uint32_t));
+
+		records.push_back(record);
+	}
+
+	const auto writeAt = [&stream](uint64_t offset, const void *data, uint64_t size)
+	{
+		// padding between blocks is filled with zeros
+		const std::vector<char> padding(size_t(offset - uint64_t(stream.tellp())), 0);
+		stream.write(padding.data(), padding.size());
+		stream.write(reinterpret_cast<const char*>(data), size);
+	};
+
+	writeAt(header.meshTableOffset, records.data(), records.size() * sizeof(MeshRecord));
+
+	for (size_t i = 0; i < meshes.size(); i++)
+	{
+		writeAt(records[i].positionOffset, meshes[i].positions, meshes[i].vertexCount * sizeof(PackedVertex::Position));
+		writeAt(records[i].attributesOffset, meshes[i].attributes, meshes[i].vertexCount * sizeof(PackedVertex::Attributes));
+		writeAt(records[i].indexOffset, meshes[i].indices, meshes[i].indexCount * sizeof(uint32_t));
+	}
+
+	header.magic = MAGIC;
+	header.version = VERSION;
+	stream.seekp(0);
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	stream.close();
+
+	// replacing fails if cache is mapped by other model at the moment
+	std::error_code errorCode;
+	if (stream.good())
+	{
+		std::filesystem::rename(temporaryPath.str(), File::getAbsolute(getCachePath(sourcePath)), errorCode);
+	}
+	const bool saved = stream.good() && !errorCode;
+
+	std::filesystem::remove(temporaryPath.str(), errorCode);
+
+	return saved;
+}
+
+// private:
+
+std::string MeshCache::getCachePath(const std::string &sourcePath)
+{
+	return sourcePath + ".cooked";
+}
+
+int64_t MeshCache::getSourceTime(const std::string &sourcePath)
+{
+	return int64_t(std::filesystem::last_write_time(File::getAbsolute(sourcePath)).time_since_epoch().count());
+}
+
+uint64_t MeshCache::getSourceHash(const std::string &sourcePath)
+{
+	const CpuProfiler::Scope profilerScope("MeshCache::getSourceHash");
+
+	const MappedFile source(sourcePath);
+	const auto data = reinterpret_cast<const uint8_t*>(source.getData());
+
+	uint64_t hash = 0xCBF29CE484222325;
+	for (size_t i = 0; i < source.getSize(); i++)
+	{
+		hash ^= data[i];
+		hash *= 0x100000001B3;
+	}
+
+	return hash;
+}
+
+uint64_t MeshCache::align(uint64_t offset)
+{
+	return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+const MeshCache::Header* MeshCache::getHeader() const
+{
+	return reinterpret_cast<const Header*>(file->getData());
+}
+
+bool MeshCache::checkLayout() const
+{
+	const uint64_t size = file->getSize();
+	if (size < sizeof(Header))
+	{
+		return false;
+	}
+
+	const Header *header = getHeader();
+	if (header->magic != MAGIC || header->version != VERSION || header->vertexSize != sizeof(PackedVertex))
+	{
+		return false;
+	}
+
+	const auto data = reinterpret_cast<const uint8_t*>(file->getData());
+
+	uint64_t offset = sizeof(Header);
+	for (uint32_t i = 0; i < header->materialCount; i++)
+	{
+		if (offset + sizeof(MaterialRecord) > size)
+		{
+			return false;
+		}
+
+		const auto record = reinterpret_cast<const MaterialRecord*>(data + offset);
+		offset += sizeof(MaterialRecord) + uint64_t(record->textureCount) * sizeof(TextureRecord);
+	}
+
+	if (offset > header->meshTableOffset || header->meshTableOffset + header->meshCount * sizeof(MeshRecord) > size)
+	{
+		return false;
+	}
+
+	const auto records = reinterpret_cast<const MeshRecord*>(data + header->meshTableOffset);
+	for (uint32_t i = 0; i < header->meshCount; i++)
+	{
+		const MeshRecord &record = records[i];
+		if (record.positionOffset + uint64_t(record.vertexCount) * sizeof(PackedVertex::Position) > size ||
+			record.attributesOffset + uint64_t(record.vertexCount) * sizeof(PackedVertex::Attributes) > size ||
+			record.indexOffset + uint64_t(record.indexCount) * sizeof(uint32_t) > size)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <assimp/scene.h>
+#include "PackedVertex.h"
+#include "Material.h"
+#include "BoundingVolume.h"
+#include "MappedFile.h"
+
+// binary file with meshes cooked from model source file (next to source with suffix ".cooked"),
+// file is mapped into memory and meshes are uploaded directly from mapping without parsing
+class MeshCache
+{
+public:
+	struct MaterialData
+	{
+		// material index in source file
+		uint32_t index;
+
+		Material::Colors colors;
+
+		// texture types of material and texture paths relative to model directory
+		std::vector<std::pair<aiTextureType, std::string>> textures;
+	};
+
+	// vertex streams and indices point into mapped file or into cooked mesh
+	struct MeshData
+	{
+		uint32_t materialIndex;
+
+		const PackedVertex::Position *positions;
+
+		const PackedVertex::Attributes *attributes;
+
+		uint32_t vertexCount;
+
+		const uint32_t *indices;
+
+		uint32_t indexCount;
+
+		BoundingVolume bounds;
+	};
+
+	// maps cache of source file if it exists, cache is valid if source has the same write time
+	// or the same hash as when it was cooked and meshes were optimized when it's required
+	MeshCache(const std::string &sourcePath, bool optimized);
+
+	~MeshCache();
+
+	bool isValid() const;
+
+	std::vector<MaterialData> getMaterials() const;
+
+	// returned data is valid while cache exists
+	std::vector<MeshData> getMeshes() const;
+
+	// writes cache of source file, returns false if file can't be written
+	static bool save(
+		const std::string &sourcePath,
+		bool optimized,
+		const std::vector<MaterialData> &materials,
+		const std::vector<MeshData> &meshes);
+
+private:
+	// increased when file layout or vertex layout changes
+	static const uint32_t VERSION = 3;
+
+	static const uint32_t MAGIC = 0x4B4D5356; // "VSMK"
+
+	static const uint32_t MAX_PATH_LENGTH = 260;
+
+	// data blocks are aligned by this size
+	static const uint64_t ALIGNMENT = 16;
+
+	// layout: header, materials (each followed by its textures), mesh table,
+	// position stream, attribute stream and indices of each mesh
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t vertexSize;
+		uint32_t materialCount;
+		uint32_t meshCount;
+		uint32_t optimized;
+		uint64_t meshTableOffset;
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		uint64_t sourceHash;
+	};
+
+	struct MaterialRecord
+	{
+		uint32_t index;
+		uint32_t textureCount;
+		Material::Colors colors;
+	};
+
+	struct TextureRecord
+	{
+		uint32_t type;
+		char path[MAX_PATH_LENGTH];
+	};
+
+	struct MeshRecord
+	{
+		uint32_t materialIndex;
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		uint32_t padding;
+		uint64_t positionOffset;
+		uint64_t attributesOffset;
+		uint64_t indexOffset;
+		glm::vec3 minPos;
+		glm::vec3 maxPos;
+	};
+
+	MappedFile *file = nullptr;
+
+	bool valid = false;
+
+	static std::string getCachePath(const std::string &sourcePath);
+
+	static int64_t getSourceTime(const std::string &sourcePath);
+
+	// FNV-1a hash of source file bytes
+	static uint64_t getSourceHash(const std::string &sourcePath);
+
+	static uint64_t align(uint64_t offset);
+
+	const Header* getHeader() const;
+
+	// checks header and that all records and data blocks are inside of file
+	bool checkLayout() const;
+};
+
@@ -0,0 +1,413 @@
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+#include <cassert>
+#include "CpuProfiler.h"
+
+#include "MeshOptimizer.h"
+
+// public:
+
+float MeshOptimizer::Statistics::getAcmr() const
+{
+	return triangleCount > 0 ? float(transformedVertexCount) / float(triangleCount) : 0.0f;
+}
+
+float MeshOptimizer::Statistics::getAtvr() const
+{
+	return vertexCount > 0 ? float(transformedVertexCount) / float(vertexCount) : 0.0f;
+}
+
+MeshOptimizer::Statistics& MeshOptimizer::Statistics::operator+=(const Statistics &other)
+{
+	vertexCount += other.vertexCount;
+	triangleCount += other.triangleCount;
+	transformedVertexCount += other.transformedVertexCount;
+
+	return *this;
+}
+
+void MeshOptimizer::optimize(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices)
+{
+	const CpuProfiler::Scope profilerScope("MeshOptimizer::optimize");
+
+	assert(indices.size() % 3 == 0);
+
+	const Statistics input = analyzeVertexCache(indices, uint32_t(vertices.size()));
+
+	if (!indices.empty())
+	{
+		weldVertices(vertices, indices);
+		const std::vector<uint32_t> hardBoundaries = reorderForVertexCache(indices, uint32_t(vertices.size()));
+		reorderForOverdraw(vertices, indices, hardBoundaries);
+		remapForFetch(vertices, indices);
+	}
+
+	const Statistics output = analyzeVertexCache(indices, uint32_t(vertices.size()));
+
+	std::lock_guard<std::mutex> lock(statisticsMutex);
+	inputStatistics += input;
+	outputStatistics += output;
+}
+
+MeshOptimizer::Statistics MeshOptimizer::analyzeVertexCache(const std::vector<uint32_t> &indices, uint32_t vertexCount)
+{
+	Statistics statistics{ vertexCount, indices.size() / 3, 0 };
+
+	// vertex is in cache if less than cache size vertices were added after it
+	std::vector<uint32_t> cacheTimes(vertexCount, 0);
+	uint32_t time = CACHE_SIZE + 1;
+
+	for (auto index : indices)
+	{
+		if (time - cacheTimes[index] > CACHE_SIZE)
+		{
+			cacheTimes[index] = time++;
+			statistics.transformedVertexCount++;
+		}
+	}
+
+	return statistics;
+}
+
+void MeshOptimizer::setEnabled(bool enabled)
+{
+	MeshOptimizer::enabled.store(enabled);
+}
+
+bool MeshOptimizer::isEnabled()
+{
+	return enabled.load();
+}
+
+MeshOptimizer::Statistics MeshOptimizer::getInputStatistics()
+{
+	std::lock_guard<std::mutex> lock(statisticsMutex);
+	return inputStatistics;
+}
+
+MeshOptimizer::Statistics MeshOptimizer::getOutputStatistics()
+{
+	std::lock_guard<std::mutex> lock(statisticsMutex);
+	return outputStatistics;
+}
+
+void MeshOptimizer::resetStatistics()
+{
+	std::lock_guard<std::mutex> lock(statisticsMutex);
+	inputStatistics = {};
+	outputStatistics = {};
+}
+
+// private:
+
+std::atomic<bool> MeshOptimizer::enabled{ true };
+
+std::mutex MeshOptimizer::statisticsMutex;
+
+MeshOptimizer::Statistics MeshOptimizer::inputStatistics{};
+
+MeshOptimizer::Statistics MeshOptimizer::outputStatistics{};
+
+void MeshOptimizer::weldVertices(const std::vector<Vertex> &vertices, std::vector<uint32_t> &indices)
+{
+	static_assert(sizeof(Vertex) == 12 * sizeof(float), "vertices are compared by bytes, so they can't contain padding");
+
+	const auto less = [&vertices](uint32_t a, uint32_t b)
+	{
+		return std::memcmp(&vertices[a], &vertices[b], sizeof(Vertex)) < 0;
+	};
+
+	std::vector<uint32_t> order(vertices.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), less);
+
+	// stable order keeps the first of identical vertices at the beginning of their range
+	std::vector<uint32_t> remap(vertices.size());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		const bool duplicate = i > 0 && !less(order[i - 1], order[i]);
+		remap[order[i]] = duplicate ? remap[order[i - 1]] : order[i];
+	}
+
+	for (auto &index : indices)
+	{
+		index = remap[index];
+	}
+}
+
+std::vector<uint32_t> MeshOptimizer::reorderForVertexCache(std::vector<uint32_t> &indices, uint32_t vertexCount)
+{
+	const uint32_t triangleCount = uint32_t(indices.size() / 3);
+
+	// triangles which aren't emitted yet
+	std::vector<uint32_t> liveCounts(vertexCount, 0);
+	for (auto index : indices)
+	{
+		liveCounts[index]++;
+	}
+
+	// triangles adjacent to vertex are stored from its offset
+	std::vector<uint32_t> offsets(vertexCount + 1, 0);
+	for (uint32_t i = 0; i < vertexCount; i++)
+	{
+		offsets[i + 1] = offsets[i] + liveCounts[i];
+	}
+
+	std::vector<uint32_t> adjacency(indices.size());
+	std::vector<uint32_t> fillOffsets(offsets.begin(), offsets.end() - 1);
+	for (uint32_t i = 0; i < indices.size(); i++)
+	{
+		adjacency[fillOffsets[indices[i]]++] = i / 3;
+	}
+
+	std::vector<uint32_t> cacheTimes(vertexCount, 0);
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<uint32_t> deadEnds;
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> hardBoundaries;
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+
+	uint32_t time = CACHE_SIZE + 1;
+	uint32_t cursor = 0;
+
+	// recently used vertices are checked first, then vertices in input order
+	const auto skipDeadEnd = [&]() -> int64_t
+	{
+		while (!deadEnds.empty())
+		{
+			const uint32_t vertex = deadEnds.back();
+			deadEnds.pop_back();
+
+			if (liveCounts[vertex] > 0)
+			{
+				return vertex;
+			}
+		}
+
+		for (; cursor < vertexCount; cursor++)
+		{
+			if (liveCounts[cursor] > 0)
+			{
+				return cursor;
+			}
+		}
+
+		return -1;
+	};
+
+	int64_t fanningVertex = skipDeadEnd();
+	while (fanningVertex >= 0)
+	{
+		const auto vertex = uint32_t(fanningVertex);
+
+		candidates.clear();
+		for (uint32_t i = offsets[vertex]; i < offsets[vertex + 1]; i++)
+		{
+			const uint32_t triangle = adjacency[i];
+			if (emitted[triangle])
+			{
+				continue;
+			}
+
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				const uint32_t index = indices[3 * triangle + j];
+
+				result.push_back(index);
+				deadEnds.push_back(index);
+				candidates.push_back(index);
+				liveCounts[index]--;
+
+				if (time - cacheTimes[index] > CACHE_SIZE)
+				{
+					cacheTimes[index] = time++;
+				}
+			}
+
+			emitted[triangle] = true;
+		}
+
+		// candidate which stays in cache while all its triangles are emitted is preferred,
+		// the oldest of such candidates is chosen
+		fanningVertex = -1;
+		int64_t bestPriority = -1;
+		for (auto candidate : candidates)
+		{
+			if (liveCounts[candidate] == 0)
+			{
+				continue;
+			}
+
+			int64_t priority = 0;
+			if (time - cacheTimes[candidate] + 2 * liveCounts[candidate] <= CACHE_SIZE)
+			{
+				priority = time - cacheTimes[candidate];
+			}
+
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				fanningVertex = candidate;
+			}
+		}
+
+		if (fanningVertex < 0)
+		{
+			fanningVertex = skipDeadEnd();
+			if (fanningVertex >= 0)
+			{
+				hardBoundaries.push_back(uint32_t(result.size() / 3));
+			}
+		}
+	}
+
+	indices = std::move(result);
+
+	return hardBoundaries;
+}
+
+void MeshOptimizer::reorderForOverdraw(
+	const std::vector<Vertex> &vertices,
+	std::vector<uint32_t> &indices,
+	const std::vector<uint32_t> &hardBoundaries)
+{
+	const uint32_t triangleCount = uint32_t(indices.size() / 3);
+	const float threshold = analyzeVertexCache(indices, uint32_t(vertices.size())).getAcmr() * OVERDRAW_THRESHOLD;
+
+	// hard clusters are split where ACMR of cluster is low enough (soft boundaries),
+	// cluster can be drawn after any other one, so cache is flushed at its start
+	std::vector<uint32_t> clusterStarts;
+	std::vector<uint32_t> cacheTimes(vertices.size(), 0);
+	uint32_t time = CACHE_SIZE + 1;
+	uint32_t clusterMissCount = 0;
+	uint32_t clusterTriangleCount = 0;
+	size_t hardBoundary = 0;
+
+	for (uint32_t i = 0; i < triangleCount; i++)
+	{
+		const bool hard = hardBoundary < hardBoundaries.size() && hardBoundaries[hardBoundary] == i;
+		if (hard)
+		{
+			hardBoundary++;
+		}
+
+		const bool soft = clusterTriangleCount > 0 && float(clusterMissCount) <= threshold * float(clusterTriangleCount);
+		if (i == 0 || hard || soft)
+		{
+			clusterStarts.push_back(i);
+			time += CACHE_SIZE + 1;
+			clusterMissCount = 0;
+			clusterTriangleCount = 0;
+		}
+
+		for (uint32_t j = 0; j < 3; j++)
+		{
+			const uint32_t index = indices[3 * i + j];
+			if (time - cacheTimes[index] > CACHE_SIZE)
+			{
+				cacheTimes[index] = time++;
+				clusterMissCount++;
+			}
+		}
+		clusterTriangleCount++;
+	}
+
+	clusterStarts.push_back(triangleCount);
+
+	struct Cluster
+	{
+		uint32_t start;
+		uint32_t end;
+		glm::vec3 centroid;
+		glm::vec3 normal;
+		float sortKey;
+	};
+
+	// centroids and normals are weighted by triangle areas
+	std::vector<Cluster> clusters;
+	glm::vec3 meshCentroid(0.0f);
+	float meshArea = 0.0f;
+
+	for (size_t i = 0; i + 1 < clusterStarts.size(); i++)
+	{
+		Cluster cluster{ clusterStarts[i], clusterStarts[i + 1], glm::vec3(0.0f), glm::vec3(0.0f), 0.0f };
+
+		float area = 0.0f;
+		glm::vec3 averagePos(0.0f);
+		for (uint32_t j = cluster.start; j < cluster.end; j++)
+		{
+			const glm::vec3 &pos0 = vertices[indices[3 * j]].pos;
+			const glm::vec3 &pos1 = vertices[indices[3 * j + 1]].pos;
+			const glm::vec3 &pos2 = vertices[indices[3 * j + 2]].pos;
+
+			const glm::vec3 normal = glm::cross(pos1 - pos0, pos2 - pos0);
+			const float triangleArea = glm::length(normal);
+			const glm::vec3 triangleCentroid = (pos0 + pos1 + pos2) / 3.0f;
+
+			cluster.centroid += triangleCentroid * triangleArea;
+			cluster.normal += normal;
+			averagePos += triangleCentroid;
+			area += triangleArea;
+		}
+
+		meshCentroid += cluster.centroid;
+		meshArea += area;
+
+		// cluster of degenerate triangles has no area
+		cluster.centroid = area > 0.0f ? cluster.centroid / area : averagePos / float(cluster.end - cluster.start);
+
+		const float normalLength = glm::length(cluster.normal);
+		cluster.normal = normalLength > 0.0f ? cluster.normal / normalLength : glm::vec3(0.0f);
+
+		clusters.push_back(cluster);
+	}
+
+	if (meshArea > 0.0f)
+	{
+		meshCentroid /= meshArea;
+	}
+
+	for (auto &cluster : clusters)
+	{
+		cluster.sortKey = glm::dot(cluster.centroid - meshCentroid, cluster.normal);
+	}
+
+	std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster &a, const Cluster &b)
+	{
+		return a.sortKey > b.sortKey;
+	});
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	for (const auto &cluster : clusters)
+	{
+		result.insert(result.end(), indices.begin() + 3 * cluster.start, indices.begin() + 3 * cluster.end);
+	}
+
+	indices = std::move(result);
+}
+
+void MeshOptimizer::remapForFetch(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices)
+{
+	const uint32_t unused = ~0u;
+
+	std::vector<uint32_t> remap(vertices.size(), unused);
+	std::vector<Vertex> result;
+	result.reserve(vertices.size());
+
+	for (auto &index : indices)
+	{
+		if (remap[index] == unused)
+		{
+			remap[index] = uint32_t(result.size());
+			result.push_back(vertices[index]);
+		}
+
+		index = remap[index];
+	}
+
+	vertices = std::move(result);
+}
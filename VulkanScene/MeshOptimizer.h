@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include "Vertex.h"
+
+// optimizes vertices and indices of imported meshes when they are cooked:
+// identical vertices are welded, triangles are reordered for post-transform vertex cache (Tipsify)
+// and then clusters of triangles are reordered to reduce overdraw, finally vertices are sorted
+// in order of their first use (vertex fetch) and unused vertices are removed
+class MeshOptimizer
+{
+public:
+	struct Statistics
+	{
+		uint64_t vertexCount;
+
+		uint64_t triangleCount;
+
+		// vertices transformed by simulated FIFO cache
+		uint64_t transformedVertexCount;
+
+		// average cache miss ratio (transformed vertices per triangle, from 0.5 to 3)
+		float getAcmr() const;
+
+		// average transform to vertex ratio (1 is optimal)
+		float getAtvr() const;
+
+		Statistics& operator+=(const Statistics &other);
+	};
+
+	// size of simulated FIFO cache
+	static const uint32_t CACHE_SIZE = 16;
+
+	// optimizes mesh and adds its statistics before and after optimization to totals
+	static void optimize(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices);
+
+	static Statistics analyzeVertexCache(const std::vector<uint32_t> &indices, uint32_t vertexCount);
+
+	// cooked meshes aren't optimized if optimizer is disabled
+	static void setEnabled(bool enabled);
+
+	static bool isEnabled();
+
+	// totals of meshes optimized since last reset (meshes can be optimized by several threads)
+	static Statistics getInputStatistics();
+
+	static Statistics getOutputStatistics();
+
+	static void resetStatistics();
+
+private:
+	// cluster is split when its own ACMR is less than ACMR of mesh multiplied by this value,
+	// larger value gives more clusters (less overdraw) at the cost of vertex cache efficiency
+	static constexpr float OVERDRAW_THRESHOLD = 1.05f;
+
+	static std::atomic<bool> enabled;
+
+	static std::mutex statisticsMutex;
+
+	static Statistics inputStatistics;
+
+	static Statistics outputStatistics;
+
+	// indices of identical vertices are replaced with index of the first of them
+	static void weldVertices(const std::vector<Vertex> &vertices, std::vector<uint32_t> &indices);
+
+	// returns triangles where vertex cache optimization met dead end (hard cluster boundaries)
+	static std::vector<uint32_t> reorderForVertexCache(std::vector<uint32_t> &indices, uint32_t vertexCount);
+
+	// clusters facing away from mesh center are drawn first, so they occlude the others
+	static void reorderForOverdraw(
+		const std::vector<Vertex> &vertices,
+		std::vector<uint32_t> &indices,
+		const std::vector<uint32_t> &hardBoundaries);
+
+	static void remapForFetch(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices);
+};
+
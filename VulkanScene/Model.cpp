@@ -1,5 +1,9 @@
 #include "Model.h"
 #include <stdexcept>
+#include <cassert>
+#include <algorithm>
+#include <limits>
+#include "DrawList.h"
 
 // public:
 
@@ -20,22 +24,28 @@ Model::~Model()
 		delete mesh;
 	}
 
+	delete geometryArena;
 	delete transformationsBuffer;
+	delete visibleInstancesBuffer;
+	delete boundsBuffer;
+	delete meshDrawsBuffer;
+	delete drawCommandsBuffer;
+	delete drawCountsBuffer;
 }
 
-uint32_t Model::getBufferCount() const 
+uint32_t Model::getBufferCount(uint32_t frameCount) const 
 {
-	return uint32_t(1 + materials.size());
+	return uint32_t(1 + materials.size() * frameCount);
 }
 
-uint32_t Model::getTextureCount() const
+uint32_t Model::getTextureCount(uint32_t frameCount) const
 {
-	return uint32_t(Material::TEXTURES_ORDER.size() * materials.size());
+	return uint32_t(Material::TEXTURES_ORDER.size() * materials.size() * frameCount);
 }
 
-uint32_t Model::getDescriptorSetCount() const
+uint32_t Model::getDescriptorSetCount(uint32_t frameCount) const
 {
-	return uint32_t(1 + materials.size());
+	return uint32_t(1 + materials.size() * frameCount);
 }
 
 uint32_t Model::getMeshCount() const
@@ -52,18 +62,60 @@ void Model::setTransformation(Transformation transformation, uint32_t index)
 {
 	transformations[index] = transformation.getMatrix();
 	transformationsBuffer->updateData(&transformations[index], sizeof glm::mat4, index * sizeof glm::mat4);
+
+	boundsOutdated = true;
+
+	// commands of GPU culling are recorded once, so bounds are uploaded right away
+	if (boundsBuffer != nullptr)
+	{
+		updateBounds();
+	}
+}
+
+GraphicsPipeline* Model::getPipeline(RenderPassType type, bool alphaTest) const
+{
+	return alphaTest ? alphaTestPipelines.at(type) : pipelines.at(type);
 }
 
-GraphicsPipeline* Model::getPipeline(RenderPassType type) const
+void Model::initDescriptorSets(DescriptorPool *descriptorPool, uint32_t frameCount)
 {
-	return pipelines.at(type);
+	for (auto material : materials)
+	{
+		material.second->initDescriptorSets(descriptorPool, frameCount);
+	}
 }
 
-void Model::initDescriptorSets(DescriptorPool *descriptorPool)
+void Model::updateDescriptorSets(uint32_t frameIndex)
 {
 	for (auto material : materials)
 	{
-		material.second->initDescriptorSet(descriptorPool);
+		material.second->updateDescriptorSet(frameIndex);
+	}
+}
+
+void Model::requestTextures(TextureStreamer *textureStreamer, glm::vec3 cameraPos, float projectionScale)
+{
+	if (boundsOutdated)
+	{
+		updateBounds();
+	}
+
+	const std::vector<MeshBase*> meshes = getMeshes();
+
+	for (uint32_t i = 0; i < meshes.size(); i++)
+	{
+		float screenSize = 0.0f;
+		for (const auto &bounds : meshInstanceBounds[i])
+		{
+			// camera inside bounds gets the largest size
+			const float distance = std::max(glm::distance(cameraPos, bounds.getCenter()) - bounds.getRadius(), 0.001f);
+			screenSize = std::max(screenSize, 2.0f * bounds.getRadius() * projectionScale / distance);
+		}
+
+		for (auto texture : meshes[i]->getMaterial()->getTextures())
+		{
+			textureStreamer->request(texture, screenSize);
+		}
 	}
 }
 
@@ -72,16 +124,48 @@ GraphicsPipeline * Model::createPipeline(
     RenderPass *renderPass,
     const std::vector<VkDescriptorSetLayout> &layouts,
 	const std::vector<VkPushConstantRange> &pushConstantRanges,
-    const std::vector<std::shared_ptr<ShaderModule>> &shaderModules)
+    const std::vector<std::shared_ptr<ShaderModule>> &shaderModules,
+	bool alphaTest)
 {
-	const std::vector<VkVertexInputBindingDescription> bindingDescriptions = {
-		getVertexBindingDescription(0),
-		getTransformationBindingDescription(1)
-	};
+	if (alphaTest && type != DEPTH)
+	{
+		throw std::invalid_argument("Only depth pass has alpha test pipeline");
+	}
 
-	std::vector<VkVertexInputAttributeDescription> attributeDescriptions = getVertexAttributeDescriptions(0, 0);
+	// depth pass doesn't need normals and tangents, uv is needed only for alpha test
+	uint32_t attributeCount = PackedVertex::ATTRIBUTE_COUNT;
+	if (type == DEPTH)
+	{
+		attributeCount = alphaTest ? 2 : 1;
+	}
+
+	std::vector<VkVertexInputBindingDescription> bindingDescriptions = getVertexBindingDescriptions(attributeCount);
+	bindingDescriptions.push_back(getTransformationBindingDescription(TRANSFORMATION_BINDING));
+
+	// mesh selection is pushed for each draw,
+	// layout can't have two ranges of one stage, so range of pass is extended to include it
+	const VkPushConstantRange selectionRange{ VK_SHADER_STAGE_VERTEX_BIT, MESH_SELECTION_OFFSET, sizeof(MeshSelection) };
+	std::vector<VkPushConstantRange> ranges = pushConstantRanges;
+	const auto sameStageRange = std::find_if(ranges.begin(), ranges.end(), [&selectionRange](const VkPushConstantRange &range)
+	{
+		return range.stageFlags == selectionRange.stageFlags;
+	});
+	if (sameStageRange != ranges.end())
+	{
+		const uint32_t offset = std::min(sameStageRange->offset, selectionRange.offset);
+		const uint32_t end = std::max(
+			sameStageRange->offset + sameStageRange->size,
+			selectionRange.offset + selectionRange.size);
+		*sameStageRange = { sameStageRange->stageFlags, offset, end - offset };
+	}
+	else
+	{
+		ranges.push_back(selectionRange);
+	}
+
+	std::vector<VkVertexInputAttributeDescription> attributeDescriptions = getVertexAttributeDescriptions(attributeCount);
 	std::vector<VkVertexInputAttributeDescription> transformationAttributeDescriptions =
-        getTransformationAttributeDescriptions(1, uint32_t(attributeDescriptions.size()));
+        getTransformationAttributeDescriptions(TRANSFORMATION_BINDING, uint32_t(attributeDescriptions.size()));
 	attributeDescriptions.insert(
         attributeDescriptions.end(),
         transformationAttributeDescriptions.begin(),
@@ -93,15 +177,16 @@ GraphicsPipeline * Model::createPipeline(
 		return createDepthPipeline(
             renderPass,
             layouts,
-            pushConstantRanges,
+            ranges,
             shaderModules,
             bindingDescriptions,
-            attributeDescriptions);
+            attributeDescriptions,
+            alphaTest);
     case GEOMETRY:
 		return createGeometryPipeline(
             renderPass,
             layouts,
-            pushConstantRanges,
+            ranges,
             shaderModules,
             bindingDescriptions,
             attributeDescriptions);
@@ -109,7 +194,7 @@ GraphicsPipeline * Model::createPipeline(
 		return createFinalPipeline(
             renderPass,
             layouts,
-            pushConstantRanges,
+            ranges,
             shaderModules,
             bindingDescriptions,
             attributeDescriptions);
@@ -118,9 +203,16 @@ GraphicsPipeline * Model::createPipeline(
     }
 }
 
-void Model::setPipeline(RenderPassType type, GraphicsPipeline *pipeline)
+void Model::setPipeline(RenderPassType type, GraphicsPipeline *pipeline, bool alphaTest)
 {
-	pipelines.insert({ type, pipeline });
+	if (alphaTest)
+	{
+		alphaTestPipelines.insert({ type, pipeline });
+	}
+	else
+	{
+		pipelines.insert({ type, pipeline });
+	}
 }
 
 void Model::setStaticPipeline(RenderPassType type, GraphicsPipeline *pipeline)
@@ -128,33 +220,395 @@ void Model::setStaticPipeline(RenderPassType type, GraphicsPipeline *pipeline)
 	staticPipelines.insert({ type, pipeline });
 }
 
-void Model::renderDepth(VkCommandBuffer commandBuffer, const std::vector<VkDescriptorSet> &descriptorSets, uint32_t renderIndex) const
+void Model::initCulling(uint32_t frameCount, uint32_t viewCount, bool gpuCulling)
 {
-    const std::vector<VkPushConstantRange> pushConstantRanges{
-		{ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(uint32_t) }
+	const std::vector<MeshBase*> meshes = getMeshes();
+	const uint32_t meshCount = uint32_t(meshes.size());
+	const uint32_t instanceCount = uint32_t(transformations.size());
+	const uint32_t drawCount = frameCount * viewCount * meshCount;
+
+	this->viewCount = viewCount;
+	this->gpuCulling = gpuCulling;
+
+	// each mesh has place for all instances in each view of each frame
+	const VkDeviceSize visibleInstancesSize = drawCount * instanceCount * sizeof glm::mat4;
+
+	if (!gpuCulling)
+	{
+		visibleInstancesBuffer = new Buffer(device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, visibleInstancesSize, Buffer::DYNAMIC);
+		visibleRanges.resize(drawCount, { 0, 0 });
+		return;
+	}
+
+	visibleInstancesBuffer = new Buffer(
+		device,
+		VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		visibleInstancesSize);
+
+	initDrawGroups();
+
+	std::vector<GpuMeshDraw> meshDraws(meshCount);
+	for (uint32_t i = 0; i < drawGroups.size(); i++)
+	{
+		for (auto meshIndex : drawGroups[i].meshIndices)
+		{
+			const MeshBase *mesh = meshes[meshIndex];
+			meshDraws[meshIndex] = {
+				mesh->getIndexCount(),
+				mesh->getFirstIndex(),
+				mesh->getVertexOffset(),
+				i,
+				drawGroups[i].firstCommand
+			};
+		}
+	}
+
+	const VkDeviceSize meshDrawsSize = meshCount * sizeof(GpuMeshDraw);
+	meshDrawsBuffer = new Buffer(device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, meshDrawsSize);
+	meshDrawsBuffer->updateData(meshDraws.data(), meshDrawsSize, 0);
+
+	// each view has place for commands of all meshes and count for each draw group
+	drawCommandsBuffer = new Buffer(
+		device,
+		VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		drawCount * sizeof(VkDrawIndexedIndirectCommand));
+	drawCountsBuffer = new Buffer(
+		device,
+		VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		frameCount * viewCount * drawGroups.size() * sizeof(uint32_t));
+
+	boundsBuffer = new Buffer(
+		device,
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		meshCount * instanceCount * sizeof(GpuBounds),
+		Buffer::DYNAMIC);
+	updateBounds();
+}
+
+std::vector<uint32_t> Model::cull(const std::vector<Frustum> &frustums, uint32_t frameIndex)
+{
+	assert(visibleInstancesBuffer != nullptr && !gpuCulling);
+	assert(frustums.size() == viewCount);
+
+	if (boundsOutdated)
+	{
+		updateBounds();
+	}
+
+	const uint32_t meshCount = uint32_t(meshInstanceBounds.size());
+	const uint32_t instanceCount = uint32_t(transformations.size());
+
+	std::vector<uint32_t> culledCounts(viewCount, 0);
+
+	std::vector<uint32_t> candidates;
+	std::vector<glm::mat4> visibleTransformations;
+	visibleTransformations.reserve(instanceCount);
+
+	for (uint32_t view = 0; view < viewCount; view++)
+	{
+		// instances outside frustum are skipped for all meshes
+		candidates.clear();
+		for (uint32_t i = 0; i < instanceCount; i++)
+		{
+			if (frustums[view].intersects(instanceBounds[i]))
+			{
+				candidates.push_back(i);
+			}
+		}
+
+		for (uint32_t i = 0; i < meshCount; i++)
+		{
+			visibleTransformations.clear();
+			for (auto instance : candidates)
+			{
+				if (frustums[view].intersects(meshInstanceBounds[i][instance]))
+				{
+					visibleTransformations.push_back(transformations[instance]);
+				}
+			}
+
+			const uint32_t rangeIndex = (frameIndex * viewCount + view) * meshCount + i;
+			InstanceRange &range = visibleRanges[rangeIndex];
+			range.first = rangeIndex * instanceCount;
+			range.count = uint32_t(visibleTransformations.size());
+
+			visibleInstancesBuffer->updateData(
+				visibleTransformations.data(),
+				range.count * sizeof glm::mat4,
+				range.first * sizeof glm::mat4);
+
+			culledCounts[view] += instanceCount - range.count;
+		}
+	}
+
+	return culledCounts;
+}
+
+void Model::initCullingDescriptorSet(
+	DescriptorPool *descriptorPool,
+	VkDescriptorSetLayout layout,
+	UniformRing *frustumsBuffer)
+{
+	assert(gpuCulling);
+
+	cullingDescriptorSet = descriptorPool->getDescriptorSet(layout);
+
+	descriptorPool->updateDescriptorSet(
+		cullingDescriptorSet,
+		{},
+		{ frustumsBuffer },
+		{},
+		{ transformationsBuffer, boundsBuffer, meshDrawsBuffer, drawCommandsBuffer, drawCountsBuffer, visibleInstancesBuffer });
+}
+
+void Model::recordCullingReset(VkCommandBuffer commandBuffer, uint32_t frameIndex) const
+{
+	const uint32_t meshCount = uint32_t(solidMeshes.size() + transparentMeshes.size());
+	const uint32_t frameDrawCount = viewCount * meshCount;
+	const uint32_t frameGroupCount = viewCount * uint32_t(drawGroups.size());
+
+	vkCmdFillBuffer(
+		commandBuffer,
+		drawCountsBuffer->get(),
+		frameIndex * frameGroupCount * sizeof(uint32_t),
+		frameGroupCount * sizeof(uint32_t),
+		0);
+
+	// without draw count all commands of group are read, commands of culled meshes stay empty
+	if (!device->getDrawIndexedIndirectCount())
+	{
+		vkCmdFillBuffer(
+			commandBuffer,
+			drawCommandsBuffer->get(),
+			frameIndex * frameDrawCount * sizeof(VkDrawIndexedIndirectCommand),
+			frameDrawCount * sizeof(VkDrawIndexedIndirectCommand),
+			0);
+	}
+}
+
+void Model::recordCulling(
+	VkCommandBuffer commandBuffer,
+	VkPipelineLayout layout,
+	const std::vector<uint32_t> &dynamicOffsets,
+	uint32_t frameIndex) const
+{
+	const uint32_t meshCount = uint32_t(solidMeshes.size() + transparentMeshes.size());
+	const uint32_t instanceCount = uint32_t(transformations.size());
+
+	vkCmdBindDescriptorSets(
+		commandBuffer,
+		VK_PIPELINE_BIND_POINT_COMPUTE,
+		layout,
+		0,
+		1,
+		&cullingDescriptorSet,
+		uint32_t(dynamicOffsets.size()),
+		dynamicOffsets.data());
+
+	const std::vector<uint32_t> pushConstantData{ frameIndex, viewCount, meshCount, instanceCount, uint32_t(drawGroups.size()) };
+	vkCmdPushConstants(
+		commandBuffer,
+		layout,
+		VK_SHADER_STAGE_COMPUTE_BIT,
+		0,
+		uint32_t(pushConstantData.size() * sizeof(uint32_t)),
+		pushConstantData.data());
+
+	// one work group for each mesh in each view, it writes command of mesh after all its instances are culled
+	vkCmdDispatch(commandBuffer, meshCount, viewCount, 1);
+}
+
+void Model::addDraws(
+	DrawList *drawList,
+	RenderPassType type,
+	uint32_t renderIndex,
+	uint32_t frameIndex,
+	glm::vec3 cameraPos)
+{
+	const auto solidMeshCount = uint32_t(solidMeshes.size());
+
+	uint32_t viewIndex = CAMERA_VIEW;
+	uint32_t firstMeshIndex = 0;
+	uint32_t endMeshIndex = solidMeshCount + uint32_t(transparentMeshes.size());
+
+	switch (type)
+	{
+	case DEPTH:
+		viewIndex = CAMERA_VIEW + 1 + renderIndex;
+		break;
+	case GEOMETRY:
+		endMeshIndex = solidMeshCount;
+		break;
+	case FINAL:
+		firstMeshIndex = solidMeshCount;
+		break;
+	default:
+		throw std::invalid_argument("Model isn't rendered by this render pass type");
+	}
+
+	const bool ordered = type == GEOMETRY || type == FINAL;
+	if (ordered && boundsOutdated)
+	{
+		updateBounds();
+	}
+
+	// distance from camera to the nearest instance of mesh
+	const auto getDistance = [this, cameraPos](uint32_t meshIndex)
+	{
+		float distance = std::numeric_limits<float>::max();
+		for (const auto &bounds : meshInstanceBounds[meshIndex])
+		{
+			distance = std::min(distance, std::max(glm::distance(cameraPos, bounds.getCenter()) - bounds.getRadius(), 0.0f));
+		}
+
+		return distance;
 	};
-    const std::vector<const void *> pushConstantData{
-		&renderIndex
+
+	// depth of meshes without alpha test is written by pipeline which fetches only positions
+	const auto addDraw = [&](Material *material, uint32_t drawIndex, float distance)
+	{
+		drawList->add({
+			getPipeline(type, type == DEPTH && material->alphaTested()),
+			material->getDescriptorSet(frameIndex),
+			this,
+			drawIndex,
+			viewIndex,
+			distance
+		});
 	};
 
-	renderMeshes(commandBuffer, DEPTH, descriptorSets, pushConstantRanges, pushConstantData, solidMeshes);
-	renderMeshes(commandBuffer, DEPTH, descriptorSets, pushConstantRanges, pushConstantData, transparentMeshes);
+	if (gpuCulling)
+	{
+		for (uint32_t i = 0; i < drawGroups.size(); i++)
+		{
+			const DrawGroup &group = drawGroups[i];
+			if (group.meshIndices.front() < firstMeshIndex || group.meshIndices.front() >= endMeshIndex)
+			{
+				continue;
+			}
+
+			float distance = 0.0f;
+			if (ordered)
+			{
+				distance = std::numeric_limits<float>::max();
+				for (auto meshIndex : group.meshIndices)
+				{
+					distance = std::min(distance, getDistance(meshIndex));
+				}
+			}
+
+			addDraw(group.material, i, distance);
+		}
+
+		return;
+	}
+
+	for (uint32_t i = firstMeshIndex; i < endMeshIndex; i++)
+	{
+		if (getVisibleRange(getRangeIndex(i, viewIndex, frameIndex)).count == 0)
+		{
+			continue;
+		}
+
+		addDraw(getMesh(i)->getMaterial(), i, ordered ? getDistance(i) : 0.0f);
+	}
 }
 
-void Model::renderGeometry(VkCommandBuffer commandBuffer, const std::vector<VkDescriptorSet> &descriptorSets) const
+void Model::bindGeometry(VkCommandBuffer commandBuffer) const
 {
-	renderMeshes(commandBuffer, GEOMETRY, descriptorSets, {}, {}, solidMeshes);
+	geometryArena->bind(commandBuffer);
+
+	VkBuffer buffer = visibleInstancesBuffer != nullptr ? visibleInstancesBuffer->get() : transformationsBuffer->get();
+	VkDeviceSize offset = 0;
+	vkCmdBindVertexBuffers(commandBuffer, TRANSFORMATION_BINDING, 1, &buffer, &offset);
+}
+
+void Model::renderDraw(
+	VkCommandBuffer commandBuffer,
+	VkPipelineLayout layout,
+	uint32_t drawIndex,
+	uint32_t viewIndex,
+	uint32_t frameIndex) const
+{
+	const auto meshCount = uint32_t(solidMeshes.size() + transparentMeshes.size());
+	const auto instanceCount = uint32_t(transformations.size());
+
+	// without culling all instances start from zero, so mesh is selected directly
+	MeshSelection selection{ firstDequantization, meshCount, std::max(instanceCount, 1u) };
+	if (visibleInstancesBuffer == nullptr)
+	{
+		selection = { firstDequantization + drawIndex, 1, 1 };
+	}
+
+	vkCmdPushConstants(
+		commandBuffer,
+		layout,
+		VK_SHADER_STAGE_VERTEX_BIT,
+		MESH_SELECTION_OFFSET,
+		sizeof(MeshSelection),
+		&selection);
+
+	if (!gpuCulling)
+	{
+		const InstanceRange range = getVisibleRange(getRangeIndex(drawIndex, viewIndex, frameIndex));
+		getMesh(drawIndex)->render(commandBuffer, range.count, range.first);
+		return;
+	}
+
+	const DrawGroup &group = drawGroups[drawIndex];
+	const auto groupSize = uint32_t(group.meshIndices.size());
+	const uint32_t viewDrawIndex = frameIndex * viewCount + viewIndex;
+
+	const VkDeviceSize drawOffset = (viewDrawIndex * meshCount + group.firstCommand) * sizeof(VkDrawIndexedIndirectCommand);
+	const VkDeviceSize countOffset = (viewDrawIndex * uint32_t(drawGroups.size()) + drawIndex) * sizeof(uint32_t);
+	const PFN_vkCmdDrawIndexedIndirectCountKHR drawIndexedIndirectCount = device->getDrawIndexedIndirectCount();
+
+	if (drawIndexedIndirectCount)
+	{
+		// only commands of visible meshes are read
+		drawIndexedIndirectCount(
+			commandBuffer,
+			drawCommandsBuffer->get(),
+			drawOffset,
+			drawCountsBuffer->get(),
+			countOffset,
+			groupSize,
+			sizeof(VkDrawIndexedIndirectCommand));
+	}
+	else if (device->isMultiDrawIndirectSupported())
+	{
+		// commands of culled meshes are empty, so they don't draw anything
+		vkCmdDrawIndexedIndirect(commandBuffer, drawCommandsBuffer->get(), drawOffset, groupSize, sizeof(VkDrawIndexedIndirectCommand));
+	}
+	else
+	{
+		for (uint32_t i = 0; i < groupSize; i++)
+		{
+			vkCmdDrawIndexedIndirect(
+				commandBuffer,
+				drawCommandsBuffer->get(),
+				drawOffset + i * sizeof(VkDrawIndexedIndirectCommand),
+				1,
+				sizeof(VkDrawIndexedIndirectCommand));
+		}
+	}
 }
 
-void Model::renderFinal(VkCommandBuffer commandBuffer, const std::vector<VkDescriptorSet> &descriptorSets) const
+void Model::addDequantizations(std::vector<PackedVertex::Dequantization> &dequantizations)
 {
-	renderMeshes(commandBuffer, FINAL, descriptorSets, {}, {}, transparentMeshes);
+	firstDequantization = uint32_t(dequantizations.size());
+
+	for (auto mesh : getMeshes())
+	{
+		dequantizations.push_back(PackedVertex::getDequantization(mesh->getBounds()));
+	}
 }
 
 void Model::renderFullscreenQuad(
     VkCommandBuffer commandBuffer,
     RenderPassType type,
-    const std::vector<VkDescriptorSet> &descriptorSets)
+    const std::vector<VkDescriptorSet> &descriptorSets,
+	const std::vector<uint32_t> &dynamicOffsets)
 {
 	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, staticPipelines.at(type)->get());
 
@@ -165,8 +619,8 @@ void Model::renderFullscreenQuad(
 		0,
 		uint32_t(descriptorSets.size()),
 		descriptorSets.data(),
-		0,
-		nullptr);
+		uint32_t(dynamicOffsets.size()),
+		dynamicOffsets.data());
 
 	vkCmdDraw(commandBuffer, 3, 1, 0, 0);
 }
@@ -192,7 +646,10 @@ Model::Model(Device *device, uint32_t count)
 {
 	this->device = device;
 
-	transformationsBuffer = new Buffer(device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, count * sizeof glm::mat4);
+	transformationsBuffer = new Buffer(
+		device,
+		VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		count * sizeof glm::mat4);
 	transformations.resize(count, glm::mat4(1.0f));
 	transformationsBuffer->updateData(transformations.data(), count * sizeof glm::mat4, 0);
 }
@@ -235,7 +692,8 @@ GraphicsPipeline* Model::createDepthPipeline(
 	const std::vector<VkPushConstantRange> &pushConstantRanges,
     const std::vector<std::shared_ptr<ShaderModule>> &shaderModules,
     const std::vector<VkVertexInputBindingDescription> &bindingDescriptions,
-    const std::vector<VkVertexInputAttributeDescription> &attributeDescriptions)
+    const std::vector<VkVertexInputAttributeDescription> &attributeDescriptions,
+	bool alphaTest)
 {
 	layouts.push_back(Material::getDsLayout());
 
@@ -247,9 +705,10 @@ GraphicsPipeline* Model::createDepthPipeline(
 	    shaderModules,
 		bindingDescriptions,
 		attributeDescriptions,
-        false);
+        false,
+		device->isDepthClampSupported());
 
-	setPipeline(DEPTH, pipeline);
+	setPipeline(DEPTH, pipeline, alphaTest);
 
 	return pipeline;
 }
@@ -304,57 +763,115 @@ GraphicsPipeline* Model::createFinalPipeline(
 	return pipeline;
 }
 
-void Model::renderMeshes(
-    VkCommandBuffer commandBuffer,
-    RenderPassType type,
-    const std::vector<VkDescriptorSet> &descriptorSets,
-    const std::vector<VkPushConstantRange> &pushConstantRanges,
-    const std::vector<const void *> &pushConstantData,
-    std::vector<MeshBase*> meshes) const
+std::vector<MeshBase*> Model::getMeshes() const
 {
-	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.at(type)->get());
+	std::vector<MeshBase*> meshes = solidMeshes;
+	meshes.insert(meshes.end(), transparentMeshes.begin(), transparentMeshes.end());
 
+	return meshes;
+}
 
-    for (uint32_t i = 0; i < pushConstantRanges.size(); i++)
-    {
-		vkCmdPushConstants(
-            commandBuffer,
-            pipelines.at(type)->getLayout(),
-            pushConstantRanges[i].stageFlags,
-            pushConstantRanges[i].offset,
-            pushConstantRanges[i].size,
-            pushConstantData[i]);
-    }
+MeshBase* Model::getMesh(uint32_t index) const
+{
+	const auto solidMeshCount = uint32_t(solidMeshes.size());
 
-	vkCmdBindDescriptorSets(
-        commandBuffer,
-        VK_PIPELINE_BIND_POINT_GRAPHICS,
-        pipelines.at(type)->getLayout(),
-        0,
-        uint32_t(descriptorSets.size()),
-        descriptorSets.data(),
-        0,
-        nullptr);
-
-	VkBuffer buffer = transformationsBuffer->get();
-	VkDeviceSize offset = 0;
-	vkCmdBindVertexBuffers(commandBuffer, 1, 1, &buffer, &offset);
+	return index < solidMeshCount ? solidMeshes[index] : transparentMeshes[index - solidMeshCount];
+}
 
-	for (auto &mesh : meshes)
+void Model::updateBounds()
+{
+	const std::vector<MeshBase*> meshes = getMeshes();
+	const uint32_t instanceCount = uint32_t(transformations.size());
+
+	meshInstanceBounds.resize(meshes.size());
+	instanceBounds = std::vector<BoundingVolume>(instanceCount);
+
+	for (uint32_t i = 0; i < meshes.size(); i++)
 	{
-		VkDescriptorSet materialDescriptorSet = mesh->getMaterial()->getDescriptorSet();
-		vkCmdBindDescriptorSets(
-            commandBuffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            pipelines.at(type)->getLayout(),
-            uint32_t(descriptorSets.size()),
-            1,
-            &materialDescriptorSet,
-            0,
-            nullptr);
+		meshInstanceBounds[i].resize(instanceCount);
+		for (uint32_t j = 0; j < instanceCount; j++)
+		{
+			meshInstanceBounds[i][j] = meshes[i]->getBounds().transform(transformations[j]);
+			instanceBounds[j] = instanceBounds[j].merge(meshInstanceBounds[i][j]);
+		}
+	}
+
+	boundsOutdated = false;
 
-		mesh->render(commandBuffer, uint32_t(transformations.size()));
+	if (boundsBuffer != nullptr)
+	{
+		std::vector<GpuBounds> gpuBounds;
+		for (const auto &meshBounds : meshInstanceBounds)
+		{
+			for (const auto &bounds : meshBounds)
+			{
+				gpuBounds.push_back({
+					glm::vec4(bounds.getCenter(), bounds.getRadius()),
+					glm::vec4(bounds.getMin(), 0.0f),
+					glm::vec4(bounds.getMax(), 0.0f)
+				});
+			}
+		}
+
+		boundsBuffer->updateData(gpuBounds.data(), gpuBounds.size() * sizeof(GpuBounds), 0);
+	}
+}
+
+void Model::initDrawGroups()
+{
+	const std::vector<MeshBase*> meshes = getMeshes();
+	const auto solidMeshCount = uint32_t(solidMeshes.size());
+
+	drawGroups.clear();
+
+	// groups of solid meshes go first, so groups of each pass follow each other
+	uint32_t firstPassGroup = 0;
+	for (uint32_t i = 0; i < meshes.size(); i++)
+	{
+		if (i == solidMeshCount)
+		{
+			firstPassGroup = uint32_t(drawGroups.size());
+		}
+
+		Material *material = meshes[i]->getMaterial();
+		const auto group = std::find_if(drawGroups.begin() + firstPassGroup, drawGroups.end(), [material](const DrawGroup &drawGroup)
+		{
+			return drawGroup.material == material;
+		});
+
+		if (group != drawGroups.end())
+		{
+			group->meshIndices.push_back(i);
+		}
+		else
+		{
+			drawGroups.push_back({ material, 0, { i } });
+		}
+	}
+
+	uint32_t firstCommand = 0;
+	for (auto &group : drawGroups)
+	{
+		group.firstCommand = firstCommand;
+		firstCommand += uint32_t(group.meshIndices.size());
 	}
 }
 
+uint32_t Model::getRangeIndex(uint32_t meshIndex, uint32_t viewIndex, uint32_t frameIndex) const
+{
+	const uint32_t meshCount = uint32_t(solidMeshes.size() + transparentMeshes.size());
+
+	return (frameIndex * viewCount + viewIndex) * meshCount + meshIndex;
+}
 
+Model::InstanceRange Model::getVisibleRange(uint32_t rangeIndex) const
+{
+	const bool culled = visibleInstancesBuffer != nullptr;
+
+	if (culled && !gpuCulling)
+	{
+		return visibleRanges[rangeIndex];
+	}
+
+	return { 0, uint32_t(transformations.size()) };
+}
@@ -9,19 +9,26 @@
 #include "GraphicsPipeline.h"
 #include "RenderPass.h"
 #include "MeshBase.h"
+#include "PackedVertex.h"
 #include <map>
 #include "Transformation.h"
+#include "Frustum.h"
+#include "TextureStreamer.h"
+
+class DrawList;
 
 class Model
 {
 public:
 	virtual ~Model();
 
-	uint32_t getBufferCount() const;
+	// materials have descriptor set for each frame in flight
+
+	uint32_t getBufferCount(uint32_t frameCount) const;
 
-	uint32_t getTextureCount() const;
+	uint32_t getTextureCount(uint32_t frameCount) const;
 
-	uint32_t getDescriptorSetCount() const;
+	uint32_t getDescriptorSetCount(uint32_t frameCount) const;
 
 	uint32_t getMeshCount() const;
 
@@ -29,31 +36,101 @@ public:
 
 	void setTransformation(Transformation transformation, uint32_t index);
 
-	GraphicsPipeline* getPipeline(RenderPassType type) const;
+	// depth pass has separate pipeline for alpha tested meshes
+	GraphicsPipeline* getPipeline(RenderPassType type, bool alphaTest = false) const;
+
+	void initDescriptorSets(DescriptorPool *descriptorPool, uint32_t frameCount);
 
-	void initDescriptorSets(DescriptorPool *descriptorPool);
+	void updateDescriptorSets(uint32_t frameIndex);
 
+	// requests resolution of streamed textures of each mesh by screen size of its nearest instance,
+	// projection scale is screen size in pixels of object with unit size at unit distance
+	void requestTextures(TextureStreamer *textureStreamer, glm::vec3 cameraPos, float projectionScale);
+
+	// depth pipeline fetches only positions, alpha test depth pipeline also fetches uv
 	GraphicsPipeline* createPipeline(
         RenderPassType type,
         RenderPass *renderPass,
         const std::vector<VkDescriptorSetLayout> &layouts,
 		const std::vector<VkPushConstantRange> &pushConstantRanges,
-        const std::vector<std::shared_ptr<ShaderModule>> &shaderModules);
+        const std::vector<std::shared_ptr<ShaderModule>> &shaderModules,
+		bool alphaTest = false);
 
-	void setPipeline(RenderPassType type, GraphicsPipeline *pipeline);
+	void setPipeline(RenderPassType type, GraphicsPipeline *pipeline, bool alphaTest = false);
 
 	static void setStaticPipeline(RenderPassType type, GraphicsPipeline *pipeline);
 
-	void renderDepth(VkCommandBuffer commandBuffer, const std::vector<VkDescriptorSet> &descriptorSets, uint32_t renderIndex) const;
-
-	void renderGeometry(VkCommandBuffer commandBuffer, const std::vector<VkDescriptorSet> &descriptorSets) const;
-
-	void renderFinal(VkCommandBuffer commandBuffer, const std::vector<VkDescriptorSet> &descriptorSets) const;
-
+	// geometry and final passes render instances visible in camera view,
+	// depth pass renders instances of view which follows camera view by its render index
+	static const uint32_t CAMERA_VIEW = 0;
+
+	// storage buffers bound in descriptor set of culling compute shader
+	static const uint32_t CULLING_STORAGE_BUFFER_COUNT = 6;
+
+	// local size of culling compute shader (one work group culls instances of one mesh in one view)
+	static const uint32_t CULLING_GROUP_SIZE = 64;
+
+	// vertex streams of meshes take bindings before transformations
+	static const uint32_t TRANSFORMATION_BINDING = 2;
+
+	// allocates buffer for instances visible in each view of each frame,
+	// after that meshes are rendered only with instances selected by cull,
+	// with GPU culling instances are selected by compute shader and meshes of each material
+	// are drawn by one indirect draw
+	void initCulling(uint32_t frameCount, uint32_t viewCount, bool gpuCulling);
+
+	// writes transformations of instances intersecting frustum of each view into slice of this frame,
+	// returns count of culled mesh instances (saved instanced draws) for each view
+	std::vector<uint32_t> cull(const std::vector<Frustum> &frustums, uint32_t frameIndex);
+
+	// frustums buffer contains planes of all views
+	void initCullingDescriptorSet(
+		DescriptorPool *descriptorPool,
+		VkDescriptorSetLayout layout,
+		UniformRing *frustumsBuffer);
+
+	// resets draw counts of this frame (and draw commands if device can't read draw count)
+	void recordCullingReset(VkCommandBuffer commandBuffer, uint32_t frameIndex) const;
+
+	// dispatches culling compute shader (its pipeline must be bound)
+	void recordCulling(
+		VkCommandBuffer commandBuffer,
+		VkPipelineLayout layout,
+		const std::vector<uint32_t> &dynamicOffsets,
+		uint32_t frameIndex) const;
+
+	// adds draw items of meshes rendered by pass (depth pass renders view which follows camera view
+	// by its render index), meshes without instances visible in view are skipped,
+	// with GPU culling item is added for each draw group as visible meshes aren't known,
+	// distance to camera is computed for geometry and final passes which order meshes by it
+	void addDraws(
+		DrawList *drawList,
+		RenderPassType type,
+		uint32_t renderIndex,
+		uint32_t frameIndex,
+		glm::vec3 cameraPos);
+
+	// binds vertex streams and indices of all meshes and buffer of their instances
+	void bindGeometry(VkCommandBuffer commandBuffer) const;
+
+	// draws instances of mesh (or meshes of draw group with GPU culling) visible in view,
+	// geometry must be bound
+	void renderDraw(
+		VkCommandBuffer commandBuffer,
+		VkPipelineLayout layout,
+		uint32_t drawIndex,
+		uint32_t viewIndex,
+		uint32_t frameIndex) const;
+
+	// appends dequantization of each mesh to storage buffer data of scene
+	void addDequantizations(std::vector<PackedVertex::Dequantization> &dequantizations);
+
+	// dynamic offsets select frame slices of uniform rings bound in descriptor sets
 	static void renderFullscreenQuad(
         VkCommandBuffer commandBuffer,
         RenderPassType type,
-        const std::vector<VkDescriptorSet> &descriptorSets);
+        const std::vector<VkDescriptorSet> &descriptorSets,
+		const std::vector<uint32_t> &dynamicOffsets);
 
 	void optimizeMemory();
 
@@ -68,19 +145,111 @@ protected:
 
 	std::map<uint32_t, Material*> materials;
 
-	virtual VkVertexInputBindingDescription getVertexBindingDescription(uint32_t binding) = 0;
+	// vertices and indices of all meshes (it's created by derived model before meshes)
+	GeometryArena *geometryArena = nullptr;
 
-	virtual std::vector<VkVertexInputAttributeDescription> getVertexAttributeDescriptions(
-        uint32_t binding,
-        uint32_t locationOffset) = 0;
+	// pipeline fetches first attributes of vertex (in order of shader locations),
+	// transformations take locations after them
+	virtual std::vector<VkVertexInputBindingDescription> getVertexBindingDescriptions(uint32_t attributeCount) = 0;
+
+	virtual std::vector<VkVertexInputAttributeDescription> getVertexAttributeDescriptions(uint32_t attributeCount) = 0;
 
 private:
+	// instances of one mesh which are placed one after another in instance buffer
+	struct InstanceRange
+	{
+		uint32_t first;
+		uint32_t count;
+	};
+
+	// bounds layout in culling compute shader
+	struct GpuBounds
+	{
+		glm::vec4 sphere;
+		glm::vec4 minPos;
+		glm::vec4 maxPos;
+	};
+
+	// indexed draw of mesh in culling compute shader, which writes it into commands of its draw group
+	struct GpuMeshDraw
+	{
+		uint32_t indexCount;
+		uint32_t firstIndex;
+		int32_t vertexOffset;
+		uint32_t drawGroup;
+		uint32_t firstCommand;
+	};
+
+	// meshes of one material drawn by one indirect draw, solid and transparent meshes
+	// are rendered by different passes, so they are never grouped together
+	struct DrawGroup
+	{
+		Material *material;
+
+		// commands of group follow each other in commands of view
+		uint32_t firstCommand;
+
+		// in order of getMeshes
+		std::vector<uint32_t> meshIndices;
+	};
+
+	// pushed for each draw, shaders select dequantization of mesh in storage buffer of scene
+	// as first mesh + (instance index / instance stride) % mesh count, because visible instances
+	// of each frame, view and mesh take range of instance stride
+	struct MeshSelection
+	{
+		uint32_t firstMesh;
+		uint32_t meshCount;
+		uint32_t instanceStride;
+	};
+
+	// push constants of pass can take first 16 bytes
+	static const uint32_t MESH_SELECTION_OFFSET = 16;
+
 	std::unordered_map<RenderPassType, GraphicsPipeline*> pipelines;
 
+	std::unordered_map<RenderPassType, GraphicsPipeline*> alphaTestPipelines;
+
 	std::vector<glm::mat4> transformations;
 
 	Buffer *transformationsBuffer;
 
+	// world space bounds of each mesh instance (solid meshes go first)
+	std::vector<std::vector<BoundingVolume>> meshInstanceBounds;
+
+	// world space bounds of all meshes of each instance
+	std::vector<BoundingVolume> instanceBounds;
+
+	bool boundsOutdated = true;
+
+	// culling is disabled while buffer is null
+	Buffer *visibleInstancesBuffer = nullptr;
+
+	uint32_t viewCount = 0;
+
+	// ranges of visible instances for each frame, view and mesh
+	std::vector<InstanceRange> visibleRanges;
+
+	bool gpuCulling = false;
+
+	// first dequantization of model in storage buffer of scene
+	uint32_t firstDequantization = 0;
+
+	// buffers used only by GPU culling:
+
+	Buffer *boundsBuffer = nullptr;
+
+	std::vector<DrawGroup> drawGroups;
+
+	Buffer *meshDrawsBuffer = nullptr;
+
+	// commands of visible meshes of each frame, view and draw group
+	Buffer *drawCommandsBuffer = nullptr;
+
+	Buffer *drawCountsBuffer = nullptr;
+
+	VkDescriptorSet cullingDescriptorSet = nullptr;
+
 	static std::unordered_map<RenderPassType, GraphicsPipeline*> staticPipelines;
 
 	static VkVertexInputBindingDescription getTransformationBindingDescription(uint32_t inputBinding);
@@ -95,7 +264,8 @@ private:
 		const std::vector<VkPushConstantRange> &pushConstantRanges,
         const std::vector<std::shared_ptr<ShaderModule>> &shaderModules,
         const std::vector<VkVertexInputBindingDescription> &bindingDescriptions,
-        const std::vector<VkVertexInputAttributeDescription> &attributeDescriptions);
+        const std::vector<VkVertexInputAttributeDescription> &attributeDescriptions,
+		bool alphaTest);
 
 	GraphicsPipeline* createGeometryPipeline(
         RenderPass *renderPass,
@@ -113,12 +283,19 @@ private:
         const std::vector<VkVertexInputBindingDescription> &bindingDescriptions,
         const std::vector<VkVertexInputAttributeDescription> &attributeDescriptions);
 
-	void renderMeshes(
-        VkCommandBuffer commandBuffer,
-        RenderPassType type,
-        const std::vector<VkDescriptorSet> &descriptorSets,
-		const std::vector<VkPushConstantRange> &pushConstantRanges,
-		const std::vector<const void *> &pushConstantData,
-        std::vector<MeshBase*> meshes) const;
+	// returns solid and transparent meshes in order of bounds and instance ranges
+	std::vector<MeshBase*> getMeshes() const;
+
+	// index in order of getMeshes
+	MeshBase* getMesh(uint32_t index) const;
+
+	void updateBounds();
+
+	void initDrawGroups();
+
+	uint32_t getRangeIndex(uint32_t meshIndex, uint32_t viewIndex, uint32_t frameIndex) const;
+
+	// all instances are visible if CPU culling isn't initialized
+	InstanceRange getVisibleRange(uint32_t rangeIndex) const;
 };
 
@@ -0,0 +1,98 @@
+#include <stdexcept>
+
+#include "OffscreenTarget.h"
+
+// public:
+
+OffscreenTarget::OffscreenTarget(Device *device, VkExtent2D extent, uint32_t imageCount)
+{
+	if (imageCount < 1)
+	{
+		throw std::invalid_argument("Offscreen target must contain at least one image");
+	}
+
+	this->device = device;
+	this->extent = extent;
+
+	createImages(imageCount);
+}
+
+std::vector<VkImageView> OffscreenTarget::getImageViews() const
+{
+	std::vector<VkImageView> imageViews;
+	for (const auto &image : images)
+	{
+		imageViews.push_back(image->getView());
+	}
+
+	return imageViews;
+}
+
+VkExtent2D OffscreenTarget::getExtent() const
+{
+	return extent;
+}
+
+uint32_t OffscreenTarget::getImageCount() const
+{
+	return uint32_t(images.size());
+}
+
+VkFormat OffscreenTarget::getImageFormat() const
+{
+	return IMAGE_FORMAT;
+}
+
+VkImageLayout OffscreenTarget::getFinalLayout() const
+{
+	// images are ready to be copied to host
+	return VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+}
+
+void OffscreenTarget::recreate(VkExtent2D newExtent)
+{
+	const uint32_t imageCount = getImageCount();
+
+	images.clear();
+	extent = newExtent;
+
+	createImages(imageCount);
+}
+
+VkImage OffscreenTarget::getImage(uint32_t index) const
+{
+	return images[index]->get();
+}
+
+uint32_t OffscreenTarget::getPixelSize() const
+{
+	return 4 * sizeof(uint8_t);
+}
+
+// private:
+
+void OffscreenTarget::createImages(uint32_t imageCount)
+{
+	const VkExtent3D imageExtent{
+		extent.width,
+		extent.height,
+		1
+	};
+
+	for (uint32_t i = 0; i < imageCount; i++)
+	{
+		images.push_back(std::make_shared<Image>(
+			device,
+			imageExtent,
+			0,
+			VK_SAMPLE_COUNT_1_BIT,
+			1,
+			IMAGE_FORMAT,
+			VK_IMAGE_TILING_OPTIMAL,
+			VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+			1,
+			false,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			VK_IMAGE_ASPECT_COLOR_BIT));
+	}
+}
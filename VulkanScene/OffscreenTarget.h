@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <memory>
+#include "Device.h"
+#include "Image.h"
+#include "RenderTarget.h"
+
+// device images that replace swapchain when engine renders without window,
+// frames are rendered into them in turn, after rendering they can be copied to host
+class OffscreenTarget : public RenderTarget
+{
+public:
+	OffscreenTarget(Device *device, VkExtent2D extent, uint32_t imageCount);
+
+	std::vector<VkImageView> getImageViews() const override;
+
+	VkExtent2D getExtent() const override;
+
+	uint32_t getImageCount() const override;
+
+	VkFormat getImageFormat() const override;
+
+	VkImageLayout getFinalLayout() const override;
+
+	void recreate(VkExtent2D newExtent) override;
+
+	VkImage getImage(uint32_t index) const;
+
+	// bytes of one pixel of target images
+	uint32_t getPixelSize() const;
+
+private:
+	const VkFormat IMAGE_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+
+	Device *device;
+
+	VkExtent2D extent;
+
+	std::vector<std::shared_ptr<Image>> images;
+
+	void createImages(uint32_t imageCount);
+};
+
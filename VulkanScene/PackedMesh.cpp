@@ -0,0 +1,22 @@
+#include "PackedMesh.h"
+
+// public:
+
+PackedMesh::PackedMesh(
+	GeometryArena *geometryArena,
+	const PackedVertex::Position *positions,
+	const PackedVertex::Attributes *attributes,
+	uint32_t vertexCount,
+	const uint32_t *indices,
+	uint32_t indexCount,
+	Material *material,
+	BoundingVolume bounds)
+	: MeshBase(geometryArena, { positions, attributes }, vertexCount, indices, indexCount, material)
+{
+	this->bounds = bounds;
+}
+
+void PackedMesh::clearHostVertices()
+{
+	// vertices are only uploaded to vertex buffer
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include "PackedVertex.h"
+#include "MeshBase.h"
+
+// mesh with packed vertices, geometry arena must have position stream and attribute stream
+class PackedMesh : public MeshBase
+{
+public:
+	// vertices and indices aren't copied to host vectors (they can point into mapped file),
+	// bounds are bounds which vertices were quantized in
+	PackedMesh(
+		GeometryArena *geometryArena,
+		const PackedVertex::Position *positions,
+		const PackedVertex::Attributes *attributes,
+		uint32_t vertexCount,
+		const uint32_t *indices,
+		uint32_t indexCount,
+		Material *material,
+		BoundingVolume bounds);
+
+	~PackedMesh() = default;
+
+	void clearHostVertices() override;
+};
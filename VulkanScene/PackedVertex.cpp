@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cassert>
+#include <glm/gtc/packing.hpp>
+
+#include "PackedVertex.h"
+
+// public:
+
+PackedVertex PackedVertex::pack(const Vertex &vertex, const BoundingVolume &bounds)
+{
+	static_assert(sizeof(Position) == 8 && sizeof(Attributes) == 12, "packed streams must match attribute descriptions");
+
+	PackedVertex packed{};
+
+	const glm::vec3 extent = bounds.getMax() - bounds.getMin();
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		// flat mesh has zero extent along some axis
+		const float position = extent[i] > 0.0f ? (vertex.pos[i] - bounds.getMin()[i]) / extent[i] : 0.0f;
+		packed.position.pos[i] = uint16_t(std::round(std::clamp(position, 0.0f, 1.0f) * 65535.0f));
+	}
+	packed.position.pos[3] = vertex.bitangentSign < 0.0f ? 0 : 65535;
+
+	packed.attributes.uv[0] = glm::packHalf1x16(vertex.uv.x);
+	packed.attributes.uv[1] = glm::packHalf1x16(vertex.uv.y);
+
+	const glm::vec2 normal = encodeOctahedron(vertex.normal);
+	packed.attributes.normal[0] = packSnorm(normal.x);
+	packed.attributes.normal[1] = packSnorm(normal.y);
+
+	const glm::vec2 tangent = encodeOctahedron(vertex.tangent);
+	packed.attributes.tangent[0] = packSnorm(tangent.x);
+	packed.attributes.tangent[1] = packSnorm(tangent.y);
+
+	return packed;
+}
+
+Vertex PackedVertex::unpack(const BoundingVolume &bounds) const
+{
+	const Dequantization dequantization = getDequantization(bounds);
+
+	Vertex vertex;
+	vertex.pos = glm::vec3(dequantization.offset) + glm::vec3(position.pos[0], position.pos[1], position.pos[2]) / 65535.0f * glm::vec3(dequantization.scale);
+	vertex.uv = glm::vec2(glm::unpackHalf1x16(attributes.uv[0]), glm::unpackHalf1x16(attributes.uv[1]));
+	vertex.normal = decodeOctahedron({ unpackSnorm(attributes.normal[0]), unpackSnorm(attributes.normal[1]) });
+	vertex.tangent = decodeOctahedron({ unpackSnorm(attributes.tangent[0]), unpackSnorm(attributes.tangent[1]) });
+	vertex.bitangentSign = position.pos[3] == 0 ? -1.0f : 1.0f;
+
+	return vertex;
+}
+
+PackedVertex::Streams PackedVertex::split(const std::vector<PackedVertex> &vertices)
+{
+	Streams streams;
+	streams.positions.reserve(vertices.size());
+	streams.attributes.reserve(vertices.size());
+
+	for (const auto &vertex : vertices)
+	{
+		streams.positions.push_back(vertex.position);
+		streams.attributes.push_back(vertex.attributes);
+	}
+
+	return streams;
+}
+
+std::vector<uint32_t> PackedVertex::getStreamStrides()
+{
+	return { sizeof(Position), sizeof(Attributes) };
+}
+
+PackedVertex::Dequantization PackedVertex::getDequantization(const BoundingVolume &bounds)
+{
+	return { glm::vec4(bounds.getMin(), 0.0f), glm::vec4(bounds.getMax() - bounds.getMin(), 0.0f) };
+}
+
+std::vector<VkVertexInputBindingDescription> PackedVertex::getBindingDescriptions(uint32_t attributeCount)
+{
+	std::vector<VkVertexInputBindingDescription> bindingDescriptions{
+		{ POSITION_BINDING, sizeof(Position), VK_VERTEX_INPUT_RATE_VERTEX }
+	};
+
+	if (attributeCount > 1)
+	{
+		bindingDescriptions.push_back({ ATTRIBUTES_BINDING, sizeof(Attributes), VK_VERTEX_INPUT_RATE_VERTEX });
+	}
+
+	return bindingDescriptions;
+}
+
+std::vector<VkVertexInputAttributeDescription> PackedVertex::getAttributeDescriptions(uint32_t attributeCount)
+{
+	const std::vector<VkVertexInputAttributeDescription> attributeDescriptions{
+		{ 0, POSITION_BINDING, VK_FORMAT_R16G16B16A16_UNORM, offsetof(Position, pos) },
+		{ 1, ATTRIBUTES_BINDING, VK_FORMAT_R16G16_SFLOAT, offsetof(Attributes, uv) },
+		{ 2, ATTRIBUTES_BINDING, VK_FORMAT_R16G16_SNORM, offsetof(Attributes, normal) },
+		{ 3, ATTRIBUTES_BINDING, VK_FORMAT_R16G16_SNORM, offsetof(Attributes, tangent) }
+	};
+
+	assert(attributeCount > 0 && attributeCount <= ATTRIBUTE_COUNT);
+
+	return { attributeDescriptions.begin(), attributeDescriptions.begin() + attributeCount };
+}
+
+// private:
+
+glm::vec2 PackedVertex::encodeOctahedron(glm::vec3 vector)
+{
+	const float sum = std::abs(vector.x) + std::abs(vector.y) + std::abs(vector.z);
+	if (!(sum > 0.0f))
+	{
+		return glm::vec2(0.0f);
+	}
+
+	glm::vec2 encoded = glm::vec2(vector.x, vector.y) / sum;
+
+	// lower hemisphere is folded over diagonals
+	if (vector.z < 0.0f)
+	{
+		encoded = glm::vec2(
+			(1.0f - std::abs(encoded.y)) * (encoded.x >= 0.0f ? 1.0f : -1.0f),
+			(1.0f - std::abs(encoded.x)) * (encoded.y >= 0.0f ? 1.0f : -1.0f));
+	}
+
+	return encoded;
+}
+
+glm::vec3 PackedVertex::decodeOctahedron(glm::vec2 encoded)
+{
+	glm::vec3 vector(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+
+	const float fold = std::max(-vector.z, 0.0f);
+	vector.x += vector.x >= 0.0f ? -fold : fold;
+	vector.y += vector.y >= 0.0f ? -fold : fold;
+
+	return glm::normalize(vector);
+}
+
+int16_t PackedVertex::packSnorm(float value)
+{
+	return int16_t(std::round(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+float PackedVertex::unpackSnorm(int16_t value)
+{
+	return std::max(float(value) / 32767.0f, -1.0f);
+}
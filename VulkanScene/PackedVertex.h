@@ -0,0 +1,82 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "Vertex.h"
+#include "BoundingVolume.h"
+
+// vertex layout of mesh buffers (20 bytes instead of 48 bytes of Vertex):
+// position is normalized in mesh bounds (16 bits for each axis), w of position is bitangent sign,
+// uv is half float, normal and tangent are octahedral encoded (16 bits for each component),
+// positions and other attributes are stored in separate streams, so depth pass fetches only positions
+struct PackedVertex
+{
+	// position stream (8 bytes)
+	struct Position
+	{
+		uint16_t pos[4];
+	};
+
+	// attribute stream (12 bytes)
+	struct Attributes
+	{
+		uint16_t uv[2];
+		int16_t normal[2];
+		int16_t tangent[2];
+	};
+
+	// de-interleaved vertices of mesh
+	struct Streams
+	{
+		std::vector<Position> positions;
+		std::vector<Attributes> attributes;
+	};
+
+	Position position;
+
+	Attributes attributes;
+
+	// stored for each mesh in storage buffer of scene, shaders restore position as offset + pos * scale
+	struct Dequantization
+	{
+		glm::vec4 offset;
+		glm::vec4 scale;
+	};
+
+	static const uint32_t POSITION_BINDING = 0;
+
+	static const uint32_t ATTRIBUTES_BINDING = 1;
+
+	// position, uv, normal and tangent (in order of shader locations)
+	static const uint32_t ATTRIBUTE_COUNT = 4;
+
+	static PackedVertex pack(const Vertex &vertex, const BoundingVolume &bounds);
+
+	static Streams split(const std::vector<PackedVertex> &vertices);
+
+	// strides of position stream and attribute stream
+	static std::vector<uint32_t> getStreamStrides();
+
+	Vertex unpack(const BoundingVolume &bounds) const;
+
+	static Dequantization getDequantization(const BoundingVolume &bounds);
+
+	// attribute stream is bound only if pipeline fetches more than positions
+	static std::vector<VkVertexInputBindingDescription> getBindingDescriptions(uint32_t attributeCount);
+
+	// pipeline fetches first attributes (depth pass fetches only positions or positions and uv for alpha test)
+	static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions(uint32_t attributeCount);
+
+private:
+	// zero vector is encoded as +z
+	static glm::vec2 encodeOctahedron(glm::vec3 vector);
+
+	static glm::vec3 decodeOctahedron(glm::vec2 encoded);
+
+	static int16_t packSnorm(float value);
+
+	static float unpackSnorm(int16_t value);
+};
@@ -1,20 +1,23 @@
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/gtc/matrix_transform.hpp>
+#include "CpuProfiler.h"
 
 #include "PssmKernel.h"
 
 // public:
 
-PssmKernel::PssmKernel(Device *device, Camera *camera, glm::vec3 lightingDirection)
+PssmKernel::PssmKernel(Device *device, Camera *camera, glm::vec3 lightingDirection, uint32_t frameCount)
     : camera(camera), lightingDirection(lightingDirection)
 {
 	cascadeSplits.resize(CASCADE_COUNT);
 	cascadeSpaces.resize(CASCADE_COUNT);
 
-	splitsBuffer = new Buffer(device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, CASCADE_COUNT * sizeof(float));
-	spacesBuffer = new Buffer(device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, CASCADE_COUNT * sizeof glm::mat4);
+	splitsBuffer = new UniformRing(device, CASCADE_COUNT * sizeof(float), frameCount);
+	spacesBuffer = new UniformRing(device, CASCADE_COUNT * sizeof glm::mat4, frameCount);
 
-	update();
+	calculateCascades();
+	splitsBuffer->updateData(cascadeSplits.data(), cascadeSplits.size() * sizeof(float), 0);
+	spacesBuffer->updateData(cascadeSpaces.data(), cascadeSpaces.size() * sizeof(glm::mat4), 0);
 }
 
 PssmKernel::~PssmKernel()
@@ -23,17 +26,34 @@ PssmKernel::~PssmKernel()
 	delete spacesBuffer;
 }
 
-Buffer* PssmKernel::getSplitsBuffer() const
+UniformRing* PssmKernel::getSplitsBuffer() const
 {
 	return splitsBuffer;
 }
 
-Buffer* PssmKernel::getSpacesBuffer() const
+UniformRing* PssmKernel::getSpacesBuffer() const
 {
 	return spacesBuffer;
 }
 
-void PssmKernel::update()
+std::vector<glm::mat4> PssmKernel::getCascadeSpaces() const
+{
+	return cascadeSpaces;
+}
+
+void PssmKernel::update(uint32_t frameIndex)
+{
+	const CpuProfiler::Scope profilerScope("PssmKernel::update");
+
+	calculateCascades();
+
+	splitsBuffer->updateFrameData(cascadeSplits.data(), cascadeSplits.size() * sizeof(float), 0, frameIndex);
+	spacesBuffer->updateFrameData(cascadeSpaces.data(), cascadeSpaces.size() * sizeof(glm::mat4), 0, frameIndex);
+}
+
+// private:
+
+void PssmKernel::calculateCascades()
 {
 	float nearPlane = camera->getNearPlane();
 	float farPlane = camera->getFarPlane();
@@ -125,7 +145,4 @@ void PssmKernel::update()
 
 		lastSplitDist = splits[i];
 	}
-
-	splitsBuffer->updateData(cascadeSplits.data(), cascadeSplits.size() * sizeof(float), 0);
-	spacesBuffer->updateData(cascadeSpaces.data(), cascadeSpaces.size() * sizeof(glm::mat4), 0);
 }
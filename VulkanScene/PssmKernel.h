@@ -2,7 +2,7 @@
 
 #include <glm/glm.hpp>
 #include <vector>
-#include "Buffer.h"
+#include "UniformRing.h"
 #include "Camera.h"
 
 class PssmKernel
@@ -14,14 +14,18 @@ public:
 
 	const float BIAS = 0.0005f;
 
-	PssmKernel(Device *device, Camera *camera, glm::vec3 lightingDirection);
+	PssmKernel(Device *device, Camera *camera, glm::vec3 lightingDirection, uint32_t frameCount);
 	~PssmKernel();
 
-	Buffer* getSplitsBuffer() const;
+	UniformRing* getSplitsBuffer() const;
 
-	Buffer* getSpacesBuffer() const;
+	UniformRing* getSpacesBuffer() const;
 
-	void update();
+	// returns light space view projection matrix of each cascade
+	std::vector<glm::mat4> getCascadeSpaces() const;
+
+	// writes cascade splits and spaces into slice of this frame
+	void update(uint32_t frameIndex);
 
 private:
 	std::vector<float> cascadeSplits;
@@ -32,8 +36,10 @@ private:
 
 	glm::vec3 lightingDirection;
 
-	Buffer *splitsBuffer;
+	UniformRing *splitsBuffer;
+
+	UniformRing *spacesBuffer;
 
-	Buffer *spacesBuffer;
+	void calculateCascades();
 };
 
@@ -20,18 +20,33 @@ QueueFamilyIndices::QueueFamilyIndices(VkPhysicalDevice device, VkSurfaceKHR sur
 			graphics = i;
 		}
 
+		const bool transferOnly = queueFamilies[i].queueFlags & VK_QUEUE_TRANSFER_BIT
+			&& !(queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT);
+		if (queueFamilies[i].queueCount > 0 && transferOnly && transfer < 0)
+		{
+			transfer = i;
+		}
+
 		VkBool32 presentSupport = false;
-		vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+		if (surface != VK_NULL_HANDLE)
+		{
+			vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+		}
 		if (queueFamilies[i].queueCount > 0 && presentSupport)
 		{
 			present = i;
 		}
 
-		if (completed())
+		if (completed() && hasDedicatedTransfer())
 		{
 			break;
 		}
 	}
+
+	if (surface == VK_NULL_HANDLE)
+	{
+		present = graphics;
+	}
 }
 
 uint32_t QueueFamilyIndices::getGraphics() const
@@ -54,6 +69,21 @@ uint32_t QueueFamilyIndices::getPresent() const
 	throw std::runtime_error("No required queue family");
 }
 
+uint32_t QueueFamilyIndices::getTransfer() const
+{
+	if (transfer >= 0)
+	{
+		return uint32_t(transfer);
+	}
+
+	return getGraphics();
+}
+
+bool QueueFamilyIndices::hasDedicatedTransfer() const
+{
+	return transfer >= 0;
+}
+
 bool QueueFamilyIndices::completed() const
 {
 	return graphics >= 0 && present >= 0;
@@ -7,13 +7,20 @@ class QueueFamilyIndices
 public:
 	QueueFamilyIndices() = default;
 
-    // try to find required queue families and save they indices
+    // try to find required queue families and save they indices,
+	// without surface graphics family is used as present family
 	QueueFamilyIndices(VkPhysicalDevice device, VkSurfaceKHR surface);
 
 	uint32_t getGraphics() const;
 
 	uint32_t getPresent() const;
 
+	// returns dedicated transfer queue family or graphics family if there is no such
+	uint32_t getTransfer() const;
+
+	// this device has queue family that supports transfer but not graphics
+	bool hasDedicatedTransfer() const;
+
 	// this device have all required queue families (for this surface)
 	bool completed() const;
 
@@ -21,5 +28,6 @@ private:
 	// queue family indices
 	int graphics = -1;
 	int present = -1;
+	int transfer = -1;
 };
 
@@ -5,7 +5,8 @@
 
 RenderPass::~RenderPass()
 {
-	cleanup();
+	cleanupFramebuffers();
+	vkDestroyRenderPass(device->get(), renderPass, nullptr);
 }
 
 VkRenderPass RenderPass::get() const
@@ -81,9 +82,10 @@ void RenderPass::create()
 
 void RenderPass::recreate(VkExtent2D newExtent)
 {
-	cleanup();
+	cleanupFramebuffers();
 	extent = newExtent;
-	create();
+	createAttachments();
+	createFramebuffers();
 }
 
 RenderPass::RenderPass(Device *device, VkExtent2D extent, VkSampleCountFlagBits sampleCount)
@@ -120,7 +122,7 @@ void RenderPass::addFramebuffer(std::vector<VkImageView> imageViews)
 	framebuffers.push_back(framebuffer);
 }
 
-void RenderPass::cleanup()
+void RenderPass::cleanupFramebuffers()
 {
 	attachments.clear();
 
@@ -129,7 +131,5 @@ void RenderPass::cleanup()
 		vkDestroyFramebuffer(device->get(), framebuffer, nullptr);
 	}
 	framebuffers.clear();
-
-	vkDestroyRenderPass(device->get(), renderPass, nullptr);
 }
 
@@ -28,6 +28,7 @@ public:
 
 	void create();
 
+	// recreates only attachments and framebuffers, render pass and pipelines that use it stay valid
 	void recreate(VkExtent2D newExtent);
 
 protected:
@@ -63,7 +64,7 @@ protected:
 	void addFramebuffer(std::vector<VkImageView> imageViews);
 
 private:
-	void cleanup();
+	void cleanupFramebuffers();
 };
 
 enum RenderPassType
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+
+// images which final render pass resolves frames into
+class RenderTarget
+{
+public:
+	virtual ~RenderTarget() = default;
+
+	virtual std::vector<VkImageView> getImageViews() const = 0;
+
+	virtual VkExtent2D getExtent() const = 0;
+
+	virtual uint32_t getImageCount() const = 0;
+
+	virtual VkFormat getImageFormat() const = 0;
+
+	// layout of images after final render pass
+	virtual VkImageLayout getFinalLayout() const = 0;
+
+	virtual void recreate(VkExtent2D newExtent) = 0;
+};
+
@@ -3,6 +3,10 @@
 #include "GeometryRenderPass.h"
 #include "Scene.h"
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "CpuProfiler.h"
 #include "DepthRenderPass.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
@@ -12,19 +16,52 @@
 
 // public:
 
-Scene::Scene(Device *device, VkExtent2D cameraExtent, const std::string &path)  : device(device)
+Scene::Scene(
+	Device *device,
+	VkExtent2D cameraExtent,
+	const std::string &path,
+	uint32_t frameCount,
+	bool gpuCulling,
+	uint32_t loadingThreadCount)
+	: device(device), frameCount(frameCount)
 {
+	this->gpuCulling = gpuCulling && device->isDrawIndirectFirstInstanceSupported();
+
 	sceneDao.open(path);
 
-	camera = new Camera(device, cameraExtent, sceneDao.getCameraAttributes());
-	lighting = new Lighting(device, sceneDao.getLightingAttributes());
+	camera = new Camera(device, cameraExtent, sceneDao.getCameraAttributes(), frameCount);
+	lighting = new Lighting(device, sceneDao.getLightingAttributes(), frameCount);
 	skybox = new SkyboxModel(device, sceneDao.getSkyboxInfo());
 	terrain = new TerrainModel(device, { 1.0f, 1.0f }, { 1000, 1000 }, sceneDao.getTerrainInfo());
 
 	ssaoKernel = new SsaoKernel(device);
-	pssmKernel = new PssmKernel(device, camera, lighting->getDirection());
+	pssmKernel = new PssmKernel(device, camera, lighting->getDirection(), frameCount);
+
+	initDynamicBuffers();
+
+	const auto loadingStartTime = std::chrono::steady_clock::now();
+	models = sceneDao.getModels(device, loadingThreadCount);
+	modelsLoadingTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadingStartTime).count();
 
-	models = sceneDao.getModels(device);
+	// skybox is always visible, so it isn't culled,
+	// terrain isn't rendered by depth pass, so it is culled only by camera
+	terrain->initCulling(frameCount, 1, this->gpuCulling);
+	for (const auto &[key, model] : models)
+	{
+		model->initCulling(frameCount, 1 + PssmKernel::CASCADE_COUNT, this->gpuCulling);
+	}
+
+	initDequantizations();
+
+	if (this->gpuCulling)
+	{
+		const VkDeviceSize frustumsSize = (1 + PssmKernel::CASCADE_COUNT) * Frustum::PLANE_COUNT * sizeof glm::vec4;
+		frustumsBuffer = new UniformRing(device, frustumsSize, frameCount);
+	}
+	else
+	{
+		savedCascadeDraws.resize(PssmKernel::CASCADE_COUNT, 0);
+	}
 }
 
 Scene::~Scene()
@@ -33,6 +70,7 @@ Scene::~Scene()
 	{
 		delete pipeline;
 	}
+	delete cullingPipeline;
 
 	delete skybox;
 	delete terrain;
@@ -45,6 +83,12 @@ Scene::~Scene()
     {
 		vkDestroyDescriptorSetLayout(device->get(), descriptorStruct.layout, nullptr);
     }
+	if (cullingDsLayout)
+	{
+		vkDestroyDescriptorSetLayout(device->get(), cullingDsLayout, nullptr);
+	}
+	delete frustumsBuffer;
+	delete dequantizationsBuffer;
 
 	delete lighting;
 	delete camera;
@@ -56,42 +100,78 @@ uint32_t Scene::getBufferCount() const
 {
 	uint32_t bufferCount = 10;
 
-	bufferCount += skybox->getBufferCount();
-	bufferCount += terrain->getBufferCount();
+	bufferCount += skybox->getBufferCount(frameCount);
+	bufferCount += terrain->getBufferCount(frameCount);
 
 	for (const auto&[key, model] : models)
 	{
-		bufferCount += model->getBufferCount();
+		bufferCount += model->getBufferCount(frameCount);
 	}
 
 	return bufferCount;
 }
 
+uint32_t Scene::getDynamicBufferCount() const
+{
+	uint32_t dynamicBufferCount = 0;
+
+	for (const auto &[type, buffers] : dynamicBuffers)
+	{
+		dynamicBufferCount += uint32_t(buffers.size());
+	}
+
+	// each culled model binds frustums buffer
+	if (gpuCulling)
+	{
+		dynamicBufferCount += uint32_t(getCulledModels().size());
+	}
+
+	return dynamicBufferCount;
+}
+
 uint32_t Scene::getTextureCount() const
 {
 	uint32_t textureCount = 10;
 
-	textureCount += skybox->getTextureCount();
-	textureCount += terrain->getTextureCount();
+	textureCount += skybox->getTextureCount(frameCount);
+	textureCount += terrain->getTextureCount(frameCount);
 
 	for (const auto&[key, model] : models)
 	{
-		textureCount += model->getTextureCount();
+		textureCount += model->getTextureCount(frameCount);
 	}
 	
 	return textureCount;
 }
 
+uint32_t Scene::getStorageBufferCount() const
+{
+	// dequantizations are bound in descriptor sets of depth, geometry and final passes
+	uint32_t storageBufferCount = 3;
+
+	if (gpuCulling)
+	{
+		storageBufferCount += uint32_t(getCulledModels().size()) * Model::CULLING_STORAGE_BUFFER_COUNT;
+	}
+
+	return storageBufferCount;
+}
+
 uint32_t Scene::getDescriptorSetCount() const
 {
 	uint32_t setCount = uint32_t(FINAL) + 1;
 
-	setCount += skybox->getDescriptorSetCount();
-	setCount += terrain->getDescriptorSetCount();
+	setCount += skybox->getDescriptorSetCount(frameCount);
+	setCount += terrain->getDescriptorSetCount(frameCount);
 
 	for (const auto&[key, model] : models)
 	{
-		setCount += model->getDescriptorSetCount();
+		setCount += model->getDescriptorSetCount(frameCount);
+	}
+
+	if (gpuCulling)
+	{
+		setCount += uint32_t(getCulledModels().size());
 	}
 
 	return setCount;
@@ -102,6 +182,27 @@ Camera* Scene::getCamera() const
 	return camera;
 }
 
+std::vector<uint32_t> Scene::getSavedCascadeDraws() const
+{
+	return savedCascadeDraws;
+}
+
+DrawList::Statistics Scene::getDrawStatistics() const
+{
+	DrawList::Statistics statistics{};
+	for (const auto &[type, passStatistics] : drawStatistics)
+	{
+		statistics += passStatistics;
+	}
+
+	return statistics;
+}
+
+double Scene::getModelsLoadingTime() const
+{
+	return modelsLoadingTime;
+}
+
 void Scene::prepareSceneRendering(DescriptorPool *descriptorPool, const RenderPassesMap &renderPasses)
 {
 	initDescriptorSets(descriptorPool, renderPasses);
@@ -109,66 +210,215 @@ void Scene::prepareSceneRendering(DescriptorPool *descriptorPool, const RenderPa
 	initStaticPipelines(renderPasses);
 }
 
-void Scene::updateScene()
+void Scene::updateScene(uint32_t frameIndex)
 {
+	const CpuProfiler::Scope profilerScope("Scene::updateScene");
+
 	const float deltaSec = frameTimer.getDeltaSec();
 
 	camera->move(deltaSec);
-	camera->updateSpace();
+	camera->updateSpace(frameIndex);
+
+	lighting->update(camera->getPos(), frameIndex);
+
+	pssmKernel->update(frameIndex);
+
+	std::vector<Frustum> frustums{ Frustum(camera->getProjectionMatrix() * camera->getViewMatrix()) };
+
+	// casters between light and cascade still cast shadows into it when depth pipelines clamp depth,
+	// otherwise rasterizer clips them by near plane, so culling keeps it too
+	const bool castersClamped = device->isDepthClampSupported();
+	for (const auto &cascadeSpace : pssmKernel->getCascadeSpaces())
+	{
+		frustums.emplace_back(cascadeSpace, !castersClamped);
+	}
+
+	if (gpuCulling)
+	{
+		std::vector<glm::vec4> planes;
+		for (const auto &frustum : frustums)
+		{
+			const std::vector<glm::vec4> frustumPlanes = frustum.getPlanes();
+			planes.insert(planes.end(), frustumPlanes.begin(), frustumPlanes.end());
+		}
+		frustumsBuffer->updateFrameData(planes.data(), planes.size() * sizeof glm::vec4, 0, frameIndex);
+
+		return;
+	}
+
+	terrain->cull({ frustums[Model::CAMERA_VIEW] }, frameIndex);
+
+	std::fill(savedCascadeDraws.begin(), savedCascadeDraws.end(), 0);
+	for (const auto &[key, model] : models)
+	{
+		const std::vector<uint32_t> culledCounts = model->cull(frustums, frameIndex);
+		for (uint32_t i = 0; i < PssmKernel::CASCADE_COUNT; i++)
+		{
+			savedCascadeDraws[i] += culledCounts[Model::CAMERA_VIEW + 1 + i];
+		}
+	}
+}
 
-	lighting->update(camera->getPos());
+void Scene::recordCulling(VkCommandBuffer commandBuffer, uint32_t frameIndex) const
+{
+	if (!gpuCulling)
+	{
+		return;
+	}
 
-	pssmKernel->update();
+	const std::vector<Model*> culledModels = getCulledModels();
 
-	skybox->setTransformation(translate(glm::mat4(1.0f), camera->getPos()), 0);
+	for (auto model : culledModels)
+	{
+		model->recordCullingReset(commandBuffer, frameIndex);
+	}
+
+	VkMemoryBarrier barrier{
+		VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+		nullptr,
+		VK_ACCESS_TRANSFER_WRITE_BIT,
+		VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+	};
+	vkCmdPipelineBarrier(
+		commandBuffer,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		0,
+		1, &barrier,
+		0, nullptr,
+		0, nullptr);
+
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullingPipeline->get());
+
+	const std::vector<uint32_t> dynamicOffsets{ frustumsBuffer->getDynamicOffset(frameIndex) };
+	for (auto model : culledModels)
+	{
+		model->recordCulling(commandBuffer, cullingPipeline->getLayout(), dynamicOffsets, frameIndex);
+	}
+
+	// draw commands and visible instances are read by render passes submitted after this one
+	barrier = {
+		VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+		nullptr,
+		VK_ACCESS_SHADER_WRITE_BIT,
+		VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+	};
+	vkCmdPipelineBarrier(
+		commandBuffer,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+		0,
+		1, &barrier,
+		0, nullptr,
+		0, nullptr);
 }
 
-void Scene::render(VkCommandBuffer commandBuffer, RenderPassType type, uint32_t renderIndex)
+void Scene::render(VkCommandBuffer commandBuffer, RenderPassType type, uint32_t renderIndex, uint32_t frameIndex)
 {
+	const std::vector<uint32_t> dynamicOffsets = getDynamicOffsets(type, frameIndex);
+	const glm::vec3 cameraPos = camera->getPos();
+
+	// statistics of pass include all its renders
+	if (renderIndex == 0)
+	{
+		drawList.resetStatistics();
+	}
+
     switch (type)
     {
     case DEPTH:
+	{
 		for (const auto&[key, model] : models)
 		{
-			model->renderDepth(commandBuffer, { descriptors.at(DEPTH).set }, renderIndex);
+			model->addDraws(&drawList, DEPTH, renderIndex, frameIndex, cameraPos);
 		}
+
+		// cascade index
+		const std::vector<VkPushConstantRange> pushConstantRanges{
+			{ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(uint32_t) }
+		};
+
+		drawList.sort(DrawList::STATE);
+		drawList.render(
+			commandBuffer,
+			{ descriptors.at(DEPTH).set },
+			dynamicOffsets,
+			pushConstantRanges,
+			{ &renderIndex },
+			frameIndex);
+		drawStatistics[DEPTH] = drawList.getStatistics();
         break;
+	}
     case GEOMETRY:
 		for (const auto&[key, model] : models)
 		{
-			model->renderGeometry(commandBuffer, { descriptors.at(GEOMETRY).set });
+			model->addDraws(&drawList, GEOMETRY, renderIndex, frameIndex, cameraPos);
 		}
-		terrain->renderGeometry(commandBuffer, { descriptors.at(GEOMETRY).set });
+		terrain->addDraws(&drawList, GEOMETRY, renderIndex, frameIndex, cameraPos);
+
+		drawList.sort(DrawList::FRONT_TO_BACK);
+		drawList.render(commandBuffer, { descriptors.at(GEOMETRY).set }, dynamicOffsets, {}, {}, frameIndex);
+		drawStatistics[GEOMETRY] = drawList.getStatistics();
         break;
     case SSAO:
-		Model::renderFullscreenQuad(commandBuffer, SSAO, { descriptors.at(SSAO).set });
+		Model::renderFullscreenQuad(commandBuffer, SSAO, { descriptors.at(SSAO).set }, dynamicOffsets);
         break;
 	case SSAO_BLUR:
-		Model::renderFullscreenQuad(commandBuffer, SSAO_BLUR, { descriptors.at(SSAO_BLUR).set });
+		Model::renderFullscreenQuad(commandBuffer, SSAO_BLUR, { descriptors.at(SSAO_BLUR).set }, dynamicOffsets);
 		break;
     case LIGHTING:
-		Model::renderFullscreenQuad(commandBuffer, LIGHTING, { descriptors.at(LIGHTING).set });
+		Model::renderFullscreenQuad(commandBuffer, LIGHTING, { descriptors.at(LIGHTING).set }, dynamicOffsets);
         break;
     case FINAL:
-		skybox->renderFinal(commandBuffer, { descriptors.at(FINAL).set });
+		// transparent meshes are blended over skybox, so it is rendered first
+		skybox->addDraws(&drawList, FINAL, renderIndex, frameIndex, cameraPos);
+		drawList.render(commandBuffer, { descriptors.at(FINAL).set }, dynamicOffsets, {}, {}, frameIndex);
+
 		for (const auto&[key, model] : models)
 		{
-			model->renderFinal(commandBuffer, { descriptors.at(FINAL).set });
+			model->addDraws(&drawList, FINAL, renderIndex, frameIndex, cameraPos);
 		}
-		terrain->renderFinal(commandBuffer, { descriptors.at(FINAL).set });
+		terrain->addDraws(&drawList, FINAL, renderIndex, frameIndex, cameraPos);
+
+		drawList.sort(DrawList::BACK_TO_FRONT);
+		drawList.render(commandBuffer, { descriptors.at(FINAL).set }, dynamicOffsets, {}, {}, frameIndex);
+		drawStatistics[FINAL] = drawList.getStatistics();
         break;
     default:
 		throw std::invalid_argument("Can't render scene for this type");
     }
 }
 
+bool Scene::dependsOnCulling(RenderPassType type) const
+{
+	// indirect draws read GPU culling results, so their commands are recorded once
+	return !gpuCulling && (type == DEPTH || type == GEOMETRY || type == FINAL);
+}
+
 void Scene::resizeExtent(VkExtent2D newExtent)
 {
 	camera->setExtent(newExtent);
+}
 
-	for (auto pipeline : pipelines)
+void Scene::requestTextures(TextureStreamer *textureStreamer)
+{
+	const CpuProfiler::Scope profilerScope("Scene::requestTextures");
+
+	// projection scales unit size at unit distance to half of screen height
+	const float projectionScale = std::abs(camera->getProjectionMatrix()[1][1]) * camera->getCenter().y;
+
+	// only textures of assimp models are streamed
+	for (const auto &[key, model] : models)
+	{
+		model->requestTextures(textureStreamer, camera->getPos(), projectionScale);
+	}
+}
+
+void Scene::updateMaterialDescriptorSets(uint32_t frameIndex)
+{
+	skybox->updateDescriptorSets(frameIndex);
+	terrain->updateDescriptorSets(frameIndex);
+	for (const auto &[key, model] : models)
 	{
-		pipeline->recreate();
+		model->updateDescriptorSets(frameIndex);
 	}
 }
 
@@ -184,7 +434,8 @@ void Scene::updateDescriptorSets(DescriptorPool *descriptorPool, RenderPassesMap
 	};
 	descriptorPool->updateDescriptorSet(
 		descriptors.at(SSAO).set,
-		{ ssaoKernel->getBuffer(), camera->getSpaceBuffer() },
+		{ ssaoKernel->getBuffer() },
+		dynamicBuffers.at(SSAO),
 		textures);
 
 	// Ssao blur:
@@ -192,6 +443,7 @@ void Scene::updateDescriptorSets(DescriptorPool *descriptorPool, RenderPassesMap
 	descriptorPool->updateDescriptorSet(
 		descriptors.at(SSAO_BLUR).set,
 		{},
+		{},
 		{ dynamic_cast<SsaoRenderPass*>(renderPasses.at(SSAO))->getSsaoTexture().get() });
 
 	// Lighting:
@@ -203,28 +455,53 @@ void Scene::updateDescriptorSets(DescriptorPool *descriptorPool, RenderPassesMap
 	textures.push_back(shadowsTexture);
 	descriptorPool->updateDescriptorSet(
 		descriptors.at(LIGHTING).set,
-		{ lighting->getAttributesBuffer(), camera->getSpaceBuffer(), pssmKernel->getSplitsBuffer(), pssmKernel->getSpacesBuffer() },
+		{},
+		dynamicBuffers.at(LIGHTING),
 		textures);
 }
 
 // private:
 
+void Scene::initDynamicBuffers()
+{
+	dynamicBuffers.insert({ DEPTH, { pssmKernel->getSpacesBuffer() } });
+	dynamicBuffers.insert({ GEOMETRY, { camera->getSpaceBuffer(), lighting->getAttributesBuffer() } });
+	dynamicBuffers.insert({ SSAO, { camera->getSpaceBuffer() } });
+	dynamicBuffers.insert({ SSAO_BLUR, {} });
+	dynamicBuffers.insert({
+		LIGHTING,
+		{ lighting->getAttributesBuffer(), camera->getSpaceBuffer(), pssmKernel->getSplitsBuffer(), pssmKernel->getSpacesBuffer() }
+	});
+	dynamicBuffers.insert({
+		FINAL,
+		{ camera->getSpaceBuffer(), lighting->getAttributesBuffer(), pssmKernel->getSplitsBuffer(), pssmKernel->getSpacesBuffer() }
+	});
+}
+
 void Scene::initDescriptorSets(DescriptorPool *descriptorPool, RenderPassesMap renderPasses)
 {
 	DescriptorStruct descriptorStruct{};
 
     // Depth:
 
-	descriptorStruct.layout = descriptorPool->createDescriptorSetLayout({ VK_SHADER_STAGE_VERTEX_BIT }, {});
+	descriptorStruct.layout = descriptorPool->createDescriptorSetLayout(
+		{},
+		{ VK_SHADER_STAGE_VERTEX_BIT },
+		{},
+		{ VK_SHADER_STAGE_VERTEX_BIT });
 	descriptorStruct.set = descriptorPool->getDescriptorSet(descriptorStruct.layout);
-	descriptorPool->updateDescriptorSet(descriptorStruct.set, { pssmKernel->getSpacesBuffer() }, {});
+	descriptorPool->updateDescriptorSet(descriptorStruct.set, {}, dynamicBuffers.at(DEPTH), {}, { dequantizationsBuffer });
 	descriptors.insert({ DEPTH, descriptorStruct });
 
     // Geometry:
 
-	descriptorStruct.layout = descriptorPool->createDescriptorSetLayout({ VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT }, {});
+	descriptorStruct.layout = descriptorPool->createDescriptorSetLayout(
+		{},
+		{ VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT },
+		{},
+		{ VK_SHADER_STAGE_VERTEX_BIT });
 	descriptorStruct.set = descriptorPool->getDescriptorSet(descriptorStruct.layout);
-	descriptorPool->updateDescriptorSet(descriptorStruct.set, { camera->getSpaceBuffer(), lighting->getAttributesBuffer() }, {});
+	descriptorPool->updateDescriptorSet(descriptorStruct.set, {}, dynamicBuffers.at(GEOMETRY), {}, { dequantizationsBuffer });
 	descriptors.insert({ GEOMETRY, descriptorStruct });
 
     // Ssao:
@@ -239,22 +516,25 @@ void Scene::initDescriptorSets(DescriptorPool *descriptorPool, RenderPassesMap r
 	std::vector<VkShaderStageFlags> texturesShaderStages(textures.size(), VK_SHADER_STAGE_FRAGMENT_BIT);
 
 	descriptorStruct.layout = descriptorPool->createDescriptorSetLayout(
-	    {VK_SHADER_STAGE_FRAGMENT_BIT, VK_SHADER_STAGE_FRAGMENT_BIT},
+	    { VK_SHADER_STAGE_FRAGMENT_BIT },
+		{ VK_SHADER_STAGE_FRAGMENT_BIT },
 	    texturesShaderStages);
 	descriptorStruct.set = descriptorPool->getDescriptorSet(descriptorStruct.layout);
 	descriptorPool->updateDescriptorSet(
 		descriptorStruct.set,
-		{ ssaoKernel->getBuffer(), camera->getSpaceBuffer() },
+		{ ssaoKernel->getBuffer() },
+		dynamicBuffers.at(SSAO),
 		textures);
 	descriptors.insert({ SSAO, descriptorStruct });
 
     // Ssao blur:
 
-	descriptorStruct.layout = descriptorPool->createDescriptorSetLayout({}, { VK_SHADER_STAGE_FRAGMENT_BIT });
+	descriptorStruct.layout = descriptorPool->createDescriptorSetLayout({}, {}, { VK_SHADER_STAGE_FRAGMENT_BIT });
 	descriptorStruct.set = descriptorPool->getDescriptorSet(descriptorStruct.layout);
 	descriptorPool->updateDescriptorSet(
 		descriptorStruct.set,
 		{},
+		{},
 		{ dynamic_cast<SsaoRenderPass*>(renderPasses.at(SSAO))->getSsaoTexture().get() });
 	descriptors.insert({ SSAO_BLUR, descriptorStruct });
 
@@ -268,38 +548,105 @@ void Scene::initDescriptorSets(DescriptorPool *descriptorPool, RenderPassesMap r
 	texturesShaderStages = std::vector<VkShaderStageFlags>(textures.size(), VK_SHADER_STAGE_FRAGMENT_BIT);
 
 	descriptorStruct.layout = descriptorPool->createDescriptorSetLayout(
+		{},
 		{ VK_SHADER_STAGE_FRAGMENT_BIT, VK_SHADER_STAGE_FRAGMENT_BIT, VK_SHADER_STAGE_FRAGMENT_BIT, VK_SHADER_STAGE_FRAGMENT_BIT },
 		texturesShaderStages);
 	descriptorStruct.set = descriptorPool->getDescriptorSet(descriptorStruct.layout);
 	descriptorPool->updateDescriptorSet(
 		descriptorStruct.set,
-		{ lighting->getAttributesBuffer(), camera->getSpaceBuffer(), pssmKernel->getSplitsBuffer(), pssmKernel->getSpacesBuffer() },
+		{},
+		dynamicBuffers.at(LIGHTING),
 		textures);
 	descriptors.insert({ LIGHTING, descriptorStruct });
 
     // Final:
 
 	descriptorStruct.layout = descriptorPool->createDescriptorSetLayout(
+		{},
 		{ VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT, VK_SHADER_STAGE_FRAGMENT_BIT, VK_SHADER_STAGE_FRAGMENT_BIT },
-		{ VK_SHADER_STAGE_FRAGMENT_BIT });
+		{ VK_SHADER_STAGE_FRAGMENT_BIT },
+		{ VK_SHADER_STAGE_VERTEX_BIT });
 	descriptorStruct.set = descriptorPool->getDescriptorSet(descriptorStruct.layout);
 	descriptorPool->updateDescriptorSet(
 		descriptorStruct.set,
-		{ camera->getSpaceBuffer(), lighting->getAttributesBuffer(), pssmKernel->getSplitsBuffer(), pssmKernel->getSpacesBuffer() },
-		{ shadowsTexture });
+		{},
+		dynamicBuffers.at(FINAL),
+		{ shadowsTexture },
+		{ dequantizationsBuffer });
 	descriptors.insert({ FINAL, descriptorStruct });
 
-	skybox->initDescriptorSets(descriptorPool);
-	terrain->initDescriptorSets(descriptorPool);
+	skybox->initDescriptorSets(descriptorPool, frameCount);
+	terrain->initDescriptorSets(descriptorPool, frameCount);
+	for (const auto &[key, model] : models)
+	{
+		model->initDescriptorSets(descriptorPool, frameCount);
+	}
+
+    // Culling:
+
+	if (gpuCulling)
+	{
+		cullingDsLayout = descriptorPool->createDescriptorSetLayout(
+			{},
+			{ VK_SHADER_STAGE_COMPUTE_BIT },
+			{},
+			std::vector<VkShaderStageFlags>(Model::CULLING_STORAGE_BUFFER_COUNT, VK_SHADER_STAGE_COMPUTE_BIT));
+
+		for (auto model : getCulledModels())
+		{
+			model->initCullingDescriptorSet(descriptorPool, cullingDsLayout, frustumsBuffer);
+		}
+	}
+}
+
+void Scene::initDequantizations()
+{
+	std::vector<PackedVertex::Dequantization> dequantizations;
+
+	skybox->addDequantizations(dequantizations);
+	terrain->addDequantizations(dequantizations);
 	for (const auto &[key, model] : models)
 	{
-		model->initDescriptorSets(descriptorPool);
+		model->addDequantizations(dequantizations);
+	}
+
+	const VkDeviceSize size = dequantizations.size() * sizeof(PackedVertex::Dequantization);
+	dequantizationsBuffer = new Buffer(device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, size);
+	dequantizationsBuffer->updateData(dequantizations.data(), size, 0);
+}
+
+std::vector<Model*> Scene::getCulledModels() const
+{
+	std::vector<Model*> culledModels{ terrain };
+	for (const auto &[key, model] : models)
+	{
+		culledModels.push_back(model);
+	}
+
+	return culledModels;
+}
+
+std::vector<uint32_t> Scene::getDynamicOffsets(RenderPassType type, uint32_t frameIndex) const
+{
+	std::vector<uint32_t> dynamicOffsets;
+
+	for (auto buffer : dynamicBuffers.at(type))
+	{
+		dynamicOffsets.push_back(buffer->getDynamicOffset(frameIndex));
 	}
+
+	return dynamicOffsets;
 }
 
 void Scene::initPipelines(RenderPassesMap renderPasses)
 {
 	const std::string skyboxShadersDir = "Shaders/Skybox/";
+	const std::string alphaTestShadersDir = "Shaders/DepthAlphaTest/";
+
+	// cascade index
+	const std::vector<VkPushConstantRange> depthPushConstantRanges{
+		{ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(uint32_t) }
+	};
 
     std::unordered_map<RenderPassType, std::string> shadersDirectories{
 		{ DEPTH, "Shaders/Depth" },
@@ -331,9 +678,7 @@ void Scene::initPipelines(RenderPassesMap renderPasses)
 
         if (type == DEPTH)
         {
-            pushConstantRanges = {
-                { VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(uint32_t) }
-			};
+			pushConstantRanges = depthPushConstantRanges;
         }
         if (type == FINAL)
         {
@@ -344,13 +689,17 @@ void Scene::initPipelines(RenderPassesMap renderPasses)
 			constantData = { &PssmKernel::CASCADE_COUNT, &pssmKernel->BIAS };
         }
 
-		shaderModules.push_back(
-			std::make_shared<ShaderModule>(
-				device,
-				File::getPath(directory, "Frag.spv"),
-				VK_SHADER_STAGE_FRAGMENT_BIT,
-				constantEntries,
-				constantData));
+		// depth of meshes without alpha test is written without fragment shader
+		if (type != DEPTH)
+		{
+			shaderModules.push_back(
+				std::make_shared<ShaderModule>(
+					device,
+					File::getPath(directory, "Frag.spv"),
+					VK_SHADER_STAGE_FRAGMENT_BIT,
+					constantEntries,
+					constantData));
+		}
 
 		pipelines.push_back(terrain->createPipeline(
             type,
@@ -364,6 +713,44 @@ void Scene::initPipelines(RenderPassesMap renderPasses)
         	model->setPipeline(type, terrain->getPipeline(type));
         }
     }
+
+	shaderModules = std::vector<std::shared_ptr<ShaderModule>>{
+		std::make_shared<ShaderModule>(device, File::getPath(alphaTestShadersDir, "Vert.spv"), VK_SHADER_STAGE_VERTEX_BIT),
+		std::make_shared<ShaderModule>(device, File::getPath(alphaTestShadersDir, "Frag.spv"), VK_SHADER_STAGE_FRAGMENT_BIT)
+	};
+
+	pipelines.push_back(terrain->createPipeline(
+		DEPTH,
+		renderPasses.at(DEPTH),
+		{ descriptors.at(DEPTH).layout },
+		depthPushConstantRanges,
+		shaderModules,
+		true));
+
+	for (const auto &[key, model] : models)
+	{
+		model->setPipeline(DEPTH, terrain->getPipeline(DEPTH, true), true);
+	}
+
+	if (gpuCulling)
+	{
+		const uint32_t maxViewCount = 1 + PssmKernel::CASCADE_COUNT;
+		const std::vector<VkSpecializationMapEntry> cullingConstantEntries{
+			{ 0, 0, sizeof(uint32_t) },
+			{ 1, sizeof(uint32_t), sizeof(uint32_t) }
+		};
+		const auto cullingShader = std::make_shared<ShaderModule>(
+			device,
+			"Shaders/Culling/Comp.spv",
+			VK_SHADER_STAGE_COMPUTE_BIT,
+			cullingConstantEntries,
+			std::vector<const void*>{ &maxViewCount, &Model::CULLING_GROUP_SIZE });
+
+		// frame index, view count, mesh count, instance count and draw group count
+		const VkPushConstantRange pushConstantRange{ VK_SHADER_STAGE_COMPUTE_BIT, 0, 5 * sizeof(uint32_t) };
+
+		cullingPipeline = new ComputePipeline(device, { cullingDsLayout }, { pushConstantRange }, cullingShader);
+	}
 }
 
 void Scene::initStaticPipelines(const RenderPassesMap &renderPasses)
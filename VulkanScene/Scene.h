@@ -10,32 +10,69 @@
 #include "SsaoKernel.h"
 #include "SceneDao.h"
 #include "PssmKernel.h"
+#include "ComputePipeline.h"
+#include "DrawList.h"
 
 class Scene
 {
 public:
-	Scene(Device *device, VkExtent2D cameraExtent, const std::string &path);
+	// GPU culling is used only if device supports indirect draws with first instance
+	Scene(
+		Device *device,
+		VkExtent2D cameraExtent,
+		const std::string &path,
+		uint32_t frameCount,
+		bool gpuCulling,
+		uint32_t loadingThreadCount);
 
 	~Scene();
 
 	uint32_t getBufferCount() const;
 
+	uint32_t getDynamicBufferCount() const;
+
 	uint32_t getTextureCount() const;
 
+	uint32_t getStorageBufferCount() const;
+
 	uint32_t getDescriptorSetCount() const;
 
 	Camera* getCamera() const;
 
+	// returns count of shadow caster instances culled in last update for each cascade,
+	// it's empty with GPU culling, because culled instances are counted only on GPU
+	std::vector<uint32_t> getSavedCascadeDraws() const;
+
+	// returns draws and binds in commands of all render passes of one frame
+	// (with GPU culling commands are recorded once, so statistics of their last recording are returned)
+	DrawList::Statistics getDrawStatistics() const;
+
+	// milliseconds spent on loading and uploading models
+	double getModelsLoadingTime() const;
+
 	void prepareSceneRendering(DescriptorPool *descriptorPool, const RenderPassesMap &renderPasses);
 
-	void updateScene();
+	// updates uniform data and visible instances in slices of this frame
+	void updateScene(uint32_t frameIndex);
+
+	// records GPU culling of all models, it must be recorded before render passes of this frame
+	void recordCulling(VkCommandBuffer commandBuffer, uint32_t frameIndex) const;
 
-	void render(VkCommandBuffer commandBuffer, RenderPassType type, uint32_t renderIndex);
+	void render(VkCommandBuffer commandBuffer, RenderPassType type, uint32_t renderIndex, uint32_t frameIndex);
+
+	// commands of such render pass must be recorded again after scene update
+	bool dependsOnCulling(RenderPassType type) const;
 
 	void resizeExtent(VkExtent2D newExtent);
 
 	void updateDescriptorSets(DescriptorPool *descriptorPool, RenderPassesMap renderPasses);
 
+	// requests levels of streamed textures by screen size of meshes in camera view
+	void requestTextures(TextureStreamer *textureStreamer);
+
+	// writes current images of streamed textures into material descriptor sets of this frame
+	void updateMaterialDescriptorSets(uint32_t frameIndex);
+
 private:
 	Device *device;
 
@@ -51,15 +88,50 @@ private:
 
 	Timer frameTimer;
 
+	std::vector<uint32_t> savedCascadeDraws;
+
+	uint32_t frameCount;
+
+	bool gpuCulling;
+
+	double modelsLoadingTime = 0;
+
+	// dequantization of each mesh of all models, vertex shaders of depth, geometry and final passes
+	// select it by mesh selection pushed for each draw
+	Buffer *dequantizationsBuffer = nullptr;
+
+	// planes of camera and cascade frustums used by culling compute shader
+	UniformRing *frustumsBuffer = nullptr;
+
+	VkDescriptorSetLayout cullingDsLayout = nullptr;
+
+	ComputePipeline *cullingPipeline = nullptr;
+
 	SkyboxModel *skybox;
 	TerrainModel *terrain;
 	std::unordered_map<std::string, AssimpModel*> models;
 
 	std::unordered_map<RenderPassType, DescriptorStruct> descriptors;
+	std::unordered_map<RenderPassType, std::vector<UniformRing*>> dynamicBuffers;
 	std::vector<GraphicsPipeline*> pipelines;
 
+	DrawList drawList;
+
+	// statistics of last recorded commands of each render pass
+	std::unordered_map<RenderPassType, DrawList::Statistics> drawStatistics;
+
+	void initDynamicBuffers();
+
+	// collects dequantizations of meshes of all models into storage buffer
+	void initDequantizations();
+
+	// returns models which are culled (all models except skybox)
+	std::vector<Model*> getCulledModels() const;
+
 	void initDescriptorSets(DescriptorPool *descriptorPool, RenderPassesMap renderPasses);
 
+	std::vector<uint32_t> getDynamicOffsets(RenderPassType type, uint32_t frameIndex) const;
+
 	void initPipelines(RenderPassesMap renderPasses);
 
 	void initStaticPipelines(const RenderPassesMap &renderPasses);
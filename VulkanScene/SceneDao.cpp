@@ -1,6 +1,11 @@
 #include <fstream>
 #include <glm/glm.hpp>
 #include "File.h"
+#include "CpuProfiler.h"
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <algorithm>
 
 #include "SceneDao.h"
 
@@ -75,9 +80,85 @@ ImageSetInfo SceneDao::getTerrainInfo() const
 	return getImageSetInfo(scene["terrain"]);
 }
 
-std::unordered_map<std::string, AssimpModel*> SceneDao::getModels(Device *device)
+std::unordered_map<std::string, AssimpModel*> SceneDao::getModels(Device *device, uint32_t threadCount)
 {
-	return parseModels(device, scene["models"]);
+	const CpuProfiler::Scope profilerScope("SceneDao::getModels");
+
+	std::vector<ModelInfo> modelInfos;
+	parseModels(scene["models"], modelInfos);
+
+	// indices of models which sources are loaded
+	std::mutex loadedMutex;
+	std::condition_variable loadedCondition;
+	std::queue<size_t> loadedIndices;
+
+	std::vector<AssimpModel::Source*> sources(modelInfos.size(), nullptr);
+
+	// textures cooked into block compressed formats are used if device supports them
+	const bool compressedTextures = device->isTextureCompressionBcSupported();
+
+	JobPool jobPool(threadCount);
+
+	for (size_t i = 0; i < modelInfos.size(); i++)
+	{
+		jobPool.submit([&, i]()
+		{
+			sources[i] = AssimpModel::loadSource(
+				modelInfos[i].path,
+				compressedTextures,
+				device->getTextureCache(),
+				&jobPool);
+
+			{
+				std::lock_guard<std::mutex> lock(loadedMutex);
+				loadedIndices.push(i);
+			}
+			loadedCondition.notify_one();
+		});
+	}
+
+	// models are created in order of loading while other sources are still loading
+	std::unordered_map<std::string, AssimpModel*> models;
+	for (size_t loadedCount = 0; loadedCount < modelInfos.size(); loadedCount++)
+	{
+		size_t index;
+		{
+			std::unique_lock<std::mutex> lock(loadedMutex);
+			loadedCondition.wait(lock, [&loadedIndices]() { return !loadedIndices.empty(); });
+
+			index = loadedIndices.front();
+			loadedIndices.pop();
+		}
+
+		const ModelInfo &modelInfo = modelInfos[index];
+		const auto count = uint32_t(modelInfo.transformations.size());
+
+		AssimpModel *model = new AssimpModel(device, sources[index], count);
+		delete sources[index];
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			model->setTransformation(getTransformation(modelInfo.transformations[i], model), i);
+		}
+
+		models.insert({ modelInfo.name, model });
+	}
+
+	return models;
+}
+
+std::vector<std::string> SceneDao::getModelPaths() const
+{
+	std::vector<ModelInfo> modelInfos;
+	parseModels(scene["models"], modelInfos);
+
+	std::vector<std::string> paths;
+	for (const auto &modelInfo : modelInfos)
+	{
+		paths.push_back(modelInfo.path);
+	}
+
+	return paths;
 }
 
 void SceneDao::saveScene(const std::string &path)
@@ -225,10 +306,8 @@ glm::vec3 SceneDao::getVec3(nlohmann::json json)
 	return vector;
 }
 
-std::unordered_map<std::string, AssimpModel*> SceneDao::parseModels(Device *device, nlohmann::json modelsJson)
+void SceneDao::parseModels(nlohmann::json modelsJson, std::vector<ModelInfo> &modelInfos)
 {
-	std::unordered_map<std::string, AssimpModel*> models;
-
 	for (const auto&[modelName, modelJson] : modelsJson.items())
 	{
 		if (modelJson.find("external") != modelJson.end())
@@ -237,25 +316,19 @@ std::unordered_map<std::string, AssimpModel*> SceneDao::parseModels(Device *devi
 			nlohmann::json externalModelsJson;
 			stream >> externalModelsJson;
 
-			std::unordered_map<std::string, AssimpModel*> externalModels = parseModels(device, externalModelsJson);
-			models.merge(externalModels);
+			parseModels(externalModelsJson, modelInfos);
 		}
 		else
 		{
-			nlohmann::json transformationsJson = modelJson["transformations"];
-			AssimpModel *model = new AssimpModel(device, modelJson["path"], uint32_t(transformationsJson.size()));
-
-			for (uint32_t i = 0; i < transformationsJson.size(); i++)
+			// first model with such name is used
+			const auto sameName = [&modelName](const ModelInfo &modelInfo) { return modelInfo.name == modelName; };
+			if (std::find_if(modelInfos.begin(), modelInfos.end(), sameName) == modelInfos.end())
 			{
-				model->setTransformation(getTransformation(transformationsJson[i], model), i);
+				modelInfos.push_back({ modelName, modelJson["path"], modelJson["transformations"] });
 			}
-
-			models.insert({ modelName, model });
 		}
 
 	}
-
-	return models;
 }
 
 Transformation SceneDao::getTransformation(nlohmann::json json, AssimpModel *model)
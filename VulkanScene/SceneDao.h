@@ -25,18 +25,31 @@ public:
 
 	ImageSetInfo getTerrainInfo() const;
 
-	std::unordered_map<std::string, AssimpModel*> getModels(Device *device);
+	// sources of models are loaded by jobs of pool with such thread count (0 - hardware concurrency),
+	// calling thread creates models from loaded sources, so all uploads are done by it
+	std::unordered_map<std::string, AssimpModel*> getModels(Device *device, uint32_t threadCount);
+
+	// paths of all models including models of external files
+	std::vector<std::string> getModelPaths() const;
 
 	static void saveScene(const std::string &path);
 
 private:
+	struct ModelInfo
+	{
+		std::string name;
+		std::string path;
+		nlohmann::json transformations;
+	};
+
 	nlohmann::json scene;
 
 	static ImageSetInfo getImageSetInfo(nlohmann::json json);
 
 	static glm::vec3 getVec3(nlohmann::json json);
 
-	static std::unordered_map<std::string, AssimpModel*> parseModels(Device *device, nlohmann::json modelsJson);
+	// collects models of json and its external files
+	static void parseModels(nlohmann::json modelsJson, std::vector<ModelInfo> &modelInfos);
 
 	static Transformation getTransformation(nlohmann::json json, AssimpModel *model);
 };
@@ -8,5 +8,18 @@ struct Settings
 
     uint32_t shadowsDim;
 
+    // count of frames in flight (from 1 to 3)
+    uint32_t frameCount;
+
+    // select visible instances with compute shader and draw them indirectly
+    bool gpuCulling;
+
     std::string scenePath;
+
+    // count of threads which load scene models (0 - hardware concurrency)
+    uint32_t loadingThreadCount;
+
+    // device memory of streamed texture levels above their tails (0 - textures aren't streamed),
+    // only cooked textures are streamed
+    VkDeviceSize textureStreamingBudget;
 };
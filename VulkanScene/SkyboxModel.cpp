@@ -1,5 +1,6 @@
 #include "Position.h"
 #include "File.h"
+#include "TextureCache.h"
 
 #include "SkyboxModel.h"
 
@@ -21,7 +22,12 @@ SkyboxModel::SkyboxModel(Device *device, ImageSetInfo imageSetInfo) : Model(devi
 	{
 		paths.push_back(File::getPath(imageSetInfo.directory, filename + imageSetInfo.extension));
 	}
-	texture = new TextureImage(device, paths, CUBE_SIDE_COUNT, true, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+	texture = device->getTextureCache()->acquire(
+		TextureCache::getKey(paths, true, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT),
+		[device, &paths]()
+		{
+			return new TextureImage(device, paths, CUBE_SIDE_COUNT, true, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT);
+		});
 
 	const std::vector<Position> cubeVertices{
 		glm::vec3(-1.0f, -1.0f, -1.0f),
@@ -52,26 +58,27 @@ SkyboxModel::SkyboxModel(Device *device, ImageSetInfo imageSetInfo) : Model(devi
 	materials.insert({ 0, material });
 	material->addTexture(aiTextureType_DIFFUSE, texture);
 
-	transparentMeshes.push_back(new Mesh<Position>(device, cubeVertices, cubeIndices, material));
+	const auto vertexCount = uint32_t(cubeVertices.size());
+	geometryArena = new GeometryArena(device, { sizeof(Position) }, vertexCount, uint32_t(cubeIndices.size()), vertexCount);
+
+	transparentMeshes.push_back(new Mesh<Position>(geometryArena, cubeVertices, cubeIndices, material));
 }
 
 SkyboxModel::~SkyboxModel()
 {
-	delete texture;
+	device->getTextureCache()->release(texture);
 }
 
 // protected:
 
-VkVertexInputBindingDescription SkyboxModel::getVertexBindingDescription(uint32_t binding)
+std::vector<VkVertexInputBindingDescription> SkyboxModel::getVertexBindingDescriptions(uint32_t attributeCount)
 {
-	return Position::getBindingDescription(binding);
+	return { Position::getBindingDescription(0) };
 }
 
-std::vector<VkVertexInputAttributeDescription> SkyboxModel::getVertexAttributeDescriptions(
-    uint32_t binding,
-    uint32_t locationOffset)
+std::vector<VkVertexInputAttributeDescription> SkyboxModel::getVertexAttributeDescriptions(uint32_t attributeCount)
 {
-	return Position::getAttributeDescriptions(binding, locationOffset);
+	return Position::getAttributeDescriptions(0, 0);
 }
 
 // private:
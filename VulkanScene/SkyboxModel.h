@@ -16,11 +16,9 @@ public:
 	~SkyboxModel();
 
 protected:
-	VkVertexInputBindingDescription getVertexBindingDescription(uint32_t binding) override;
+	std::vector<VkVertexInputBindingDescription> getVertexBindingDescriptions(uint32_t attributeCount) override;
 
-	std::vector<VkVertexInputAttributeDescription> getVertexAttributeDescriptions(
-        uint32_t binding,
-        uint32_t locationOffset) override;
+	std::vector<VkVertexInputAttributeDescription> getVertexAttributeDescriptions(uint32_t attributeCount) override;
 
 private:
 	TextureImage *texture;
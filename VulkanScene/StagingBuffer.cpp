@@ -5,33 +5,21 @@
 // public:
 
 StagingBuffer::StagingBuffer(Device *device, VkDeviceSize size)
+	: StagingBuffer(device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryAllocator::LINEAR)
 {
-	this->device = device;
-	this->size = size;
-
-	createBuffer(
-		device,
-		size,
-		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		&stagingBuffer,
-		&stagingMemory);
 }
 
 StagingBuffer::~StagingBuffer()
 {
-	vkFreeMemory(device->get(), stagingMemory, nullptr);
 	vkDestroyBuffer(device->get(), stagingBuffer, nullptr);
+	device->getMemoryAllocator()->free(stagingMemory);
 }
 
 void StagingBuffer::updateData(const void *data, VkDeviceSize dataSize, VkDeviceSize offset)
 {
 	assert(offset + dataSize <= size);
 
-	void *bufferData;
-	vkMapMemory(device->get(), stagingMemory, offset, dataSize, 0, &bufferData);
-	memcpy(bufferData, data, dataSize);
-	vkUnmapMemory(device->get(), stagingMemory);
+	memcpy(reinterpret_cast<uint8_t*>(stagingMemory.mappedData) + offset, data, dataSize);
 }
 
 void StagingBuffer::copyToImage(VkImage image, std::vector<VkBufferImageCopy> regions) const
@@ -59,15 +47,14 @@ VkDeviceSize StagingBuffer::getSize() const
 	return size;
 }
 
-// protected:
-
 void StagingBuffer::createBuffer(
     Device *device,
     VkDeviceSize size,
     VkBufferUsageFlags usage,
     VkMemoryPropertyFlags properties,
+	MemoryAllocator::Strategy strategy,
     VkBuffer *buffer,
-    VkDeviceMemory *memory)
+    MemoryAllocation *memory)
 {
 	VkBufferCreateInfo createInfo{
 		VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
@@ -80,34 +67,44 @@ void StagingBuffer::createBuffer(
 		nullptr,							
 	};
 
+	// buffers are filled by transfer queue and used by graphics queue,
+	// concurrent sharing avoids ownership transfer between queue families
+	std::vector<uint32_t> familyIndices;
+	if (usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+	{
+		const QueueFamilyIndices queueFamilyIndices = device->getQueueFamilyIndices();
+		if (queueFamilyIndices.hasDedicatedTransfer())
+		{
+			familyIndices = { queueFamilyIndices.getGraphics(), queueFamilyIndices.getTransfer() };
+			createInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+			createInfo.queueFamilyIndexCount = uint32_t(familyIndices.size());
+			createInfo.pQueueFamilyIndices = familyIndices.data();
+		}
+	}
+
     const VkResult result = vkCreateBuffer(device->get(), &createInfo, nullptr, buffer);
 	assert(result == VK_SUCCESS);
 
-	allocateMemory(device, *buffer, memory, properties);
-
-	vkBindBufferMemory(device->get(), *buffer, *memory, 0);
+	*memory = device->getMemoryAllocator()->allocate(*buffer, properties, strategy);
 }
 
-void StagingBuffer::allocateMemory(
-    Device *device,
-    VkBuffer buffer,
-    VkDeviceMemory *memory,
-    VkMemoryPropertyFlags properties)
+// protected:
+
+StagingBuffer::StagingBuffer(
+	Device *device,
+	VkDeviceSize size,
+	VkBufferUsageFlags usage,
+	MemoryAllocator::Strategy strategy)
 {
-	VkMemoryRequirements memRequirements;
-	vkGetBufferMemoryRequirements(device->get(), buffer, &memRequirements);
-
-    const uint32_t memoryTypeIndex = device->findMemoryTypeIndex(
-		memRequirements.memoryTypeBits,
-		properties);
-
-	VkMemoryAllocateInfo allocInfo{
-		VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-		nullptr,				
-		memRequirements.size,	
-		memoryTypeIndex,		
-	};
+	this->device = device;
+	this->size = size;
 
-    const VkResult result = vkAllocateMemory(device->get(), &allocInfo, nullptr, memory);
-	assert(result == VK_SUCCESS);
+	createBuffer(
+		device,
+		size,
+		usage,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		strategy,
+		&stagingBuffer,
+		&stagingMemory);
 }
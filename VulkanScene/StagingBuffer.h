@@ -3,7 +3,9 @@
 #include <vulkan/vulkan.h>
 #include "Device.h"
 
-// buffer that memory can be mapped into host memory
+// buffer that memory can be mapped into host memory,
+// memory of staging buffer is taken from transient upload arena,
+// so staging buffers should be destroyed right after transfer
 class StagingBuffer
 {
 public:
@@ -18,27 +20,26 @@ public:
 
 	VkDeviceSize getSize() const;
 
-protected:
-	Device *device;
-
-	VkBuffer stagingBuffer;
-
-	VkDeviceSize size;
-
-	VkDeviceMemory stagingMemory;
-
+	// creates buffer and binds memory allocated with such strategy
 	static void createBuffer(
 		Device *device,
 		VkDeviceSize size,
 		VkBufferUsageFlags usage,
 		VkMemoryPropertyFlags properties,
+		MemoryAllocator::Strategy strategy,
 		VkBuffer *buffer,
-		VkDeviceMemory *memory);
+		MemoryAllocation *memory);
+
+protected:
+	// creates host visible buffer with such usage
+	StagingBuffer(Device *device, VkDeviceSize size, VkBufferUsageFlags usage, MemoryAllocator::Strategy strategy);
+
+	Device *device;
+
+	VkBuffer stagingBuffer;
+
+	VkDeviceSize size;
 
-	static void allocateMemory(
-        Device *device,
-        VkBuffer buffer,
-        VkDeviceMemory *memory,
-        VkMemoryPropertyFlags properties);
+	MemoryAllocation stagingMemory;
 };
 
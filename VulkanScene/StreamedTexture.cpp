@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <cassert>
+#include "CpuProfiler.h"
+#include "TextureStreamer.h"
+
+#include "StreamedTexture.h"
+
+// public:
+
+StreamedTexture::StreamedTexture(
+	Device *device,
+	const std::string &path,
+	VkFilter filter,
+	VkSamplerAddressMode samplerAddressMode)
+	: file(new KtxFile(path)), filter(filter), samplerAddressMode(samplerAddressMode)
+{
+	const CpuProfiler::Scope profilerScope("StreamedTexture::StreamedTexture");
+
+	assert(file->isValid());
+	assert(device->getTextureStreamer());
+
+	tailLevel = 0;
+	while (tailLevel + 1 < file->getLevelCount())
+	{
+		const VkExtent2D levelExtent = file->getLevel(tailLevel).extent;
+		if (std::max(levelExtent.width, levelExtent.height) <= TAIL_EXTENT)
+		{
+			break;
+		}
+		tailLevel++;
+	}
+	residentLevel = tailLevel;
+
+	const VkExtent2D tailExtent = file->getLevel(tailLevel).extent;
+
+	createThisImage(
+		device,
+		{ tailExtent.width, tailExtent.height, 1 },
+		0,
+		VK_SAMPLE_COUNT_1_BIT,
+		file->getLevelCount() - tailLevel,
+		file->getFormat(),
+		VK_IMAGE_TILING_OPTIMAL,
+		VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+		1,
+		false,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		VK_IMAGE_ASPECT_COLOR_BIT);
+	addMemorySize();
+
+	StagingBuffer *stagingBuffer = new StagingBuffer(device, getLevelsSize(tailLevel));
+	writeLevels(tailLevel, stagingBuffer);
+
+	const VkImageSubresourceRange subresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, 1 };
+	transitLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresourceRange);
+	stagingBuffer->copyToImage(image, getCopyRegions(tailLevel));
+	transitLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresourceRange);
+
+	device->releaseStagingBuffer(stagingBuffer);
+
+	createSampler(filter, samplerAddressMode);
+
+	device->getTextureStreamer()->add(this);
+}
+
+StreamedTexture::~StreamedTexture()
+{
+	device->getTextureStreamer()->remove(this);
+
+	delete file;
+}
+
+VkExtent2D StreamedTexture::getFileExtent() const
+{
+	return file->getExtent();
+}
+
+uint32_t StreamedTexture::getResidentLevel() const
+{
+	return residentLevel;
+}
+
+uint32_t StreamedTexture::getTailLevel() const
+{
+	return tailLevel;
+}
+
+VkDeviceSize StreamedTexture::getLevelsSize(uint32_t firstLevel) const
+{
+	const VkDeviceSize blockSize = KtxFile::getBlockSize(file->getFormat());
+
+	VkDeviceSize size = 0;
+	for (uint32_t i = firstLevel; i < file->getLevelCount(); i++)
+	{
+		size = (size + blockSize - 1) / blockSize * blockSize;
+		size += file->getLevel(i).size;
+	}
+
+	return size;
+}
+
+void StreamedTexture::writeLevels(uint32_t firstLevel, StagingBuffer *stagingBuffer) const
+{
+	const CpuProfiler::Scope profilerScope("StreamedTexture::writeLevels");
+
+	const std::vector<VkBufferImageCopy> regions = getCopyRegions(firstLevel);
+	for (uint32_t i = 0; i < regions.size(); i++)
+	{
+		const KtxFile::Level level = file->getLevel(firstLevel + i);
+		stagingBuffer->updateData(level.data, level.size, regions[i].bufferOffset);
+	}
+}
+
+TextureImage* StreamedTexture::replaceImage(
+	uint32_t firstLevel,
+	const StagingBuffer *stagingBuffer,
+	VkCommandBuffer commandBuffer)
+{
+	assert(firstLevel <= tailLevel);
+
+	const VkExtent2D levelExtent = file->getLevel(firstLevel).extent;
+
+	auto texture = new TextureImage(
+		device,
+		{ levelExtent.width, levelExtent.height, 1 },
+		0,
+		VK_SAMPLE_COUNT_1_BIT,
+		file->getLevelCount() - firstLevel,
+		format,
+		VK_IMAGE_TILING_OPTIMAL,
+		VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+		1,
+		false,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		VK_IMAGE_ASPECT_COLOR_BIT,
+		filter,
+		samplerAddressMode);
+
+	const std::vector<VkBufferImageCopy> regions = getCopyRegions(firstLevel);
+	const VkImageSubresourceRange subresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, texture->getMipLevelCount(), 0, 1 };
+
+	texture->recordLayoutTransition(
+		commandBuffer,
+		VK_IMAGE_LAYOUT_UNDEFINED,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		subresourceRange);
+	vkCmdCopyBufferToImage(
+		commandBuffer,
+		stagingBuffer->get(),
+		texture->get(),
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		uint32_t(regions.size()),
+		regions.data());
+	texture->recordLayoutTransition(
+		commandBuffer,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		subresourceRange);
+
+	// this texture takes new image and returned texture takes current one
+	swapTexture(*texture);
+	residentLevel = firstLevel;
+
+	return texture;
+}
+
+// private:
+
+std::vector<VkBufferImageCopy> StreamedTexture::getCopyRegions(uint32_t firstLevel) const
+{
+	const VkDeviceSize blockSize = KtxFile::getBlockSize(file->getFormat());
+
+	std::vector<VkBufferImageCopy> regions;
+	VkDeviceSize offset = 0;
+	for (uint32_t i = firstLevel; i < file->getLevelCount(); i++)
+	{
+		const KtxFile::Level level = file->getLevel(i);
+
+		offset = (offset + blockSize - 1) / blockSize * blockSize;
+		regions.push_back({
+			offset,
+			0,
+			0,
+			{ VK_IMAGE_ASPECT_COLOR_BIT, i - firstLevel, 0, 1 },
+			{ 0, 0, 0 },
+			{ level.extent.width, level.extent.height, 1 }
+		});
+		offset += level.size;
+	}
+
+	return regions;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "TextureImage.h"
+#include "KtxFile.h"
+#include "StagingBuffer.h"
+
+// texture of KTX2 file which keeps only part of its mip chain in device memory,
+// file stays mapped, so resident levels can be changed by texture streamer at any time,
+// streamed texture is added to texture streamer of device while it exists
+class StreamedTexture : public TextureImage
+{
+public:
+	// levels which aren't larger than this extent are always resident
+	static const uint32_t TAIL_EXTENT = 64;
+
+	// only tail levels are uploaded, so texture is created quickly whatever its extent is
+	StreamedTexture(Device *device, const std::string &path, VkFilter filter, VkSamplerAddressMode samplerAddressMode);
+
+	~StreamedTexture();
+
+	// extent of the largest level of file
+	VkExtent2D getFileExtent() const;
+
+	// index of file level which is first level of image
+	uint32_t getResidentLevel() const;
+
+	// index of the largest tail level
+	uint32_t getTailLevel() const;
+
+	// size of levels from first level to the end of mip chain (aligned like in staging buffer)
+	VkDeviceSize getLevelsSize(uint32_t firstLevel) const;
+
+	// copies levels from first level into staging buffer of getLevelsSize size,
+	// it only reads mapped file, so it can be called by any thread
+	void writeLevels(uint32_t firstLevel, StagingBuffer *stagingBuffer) const;
+
+	// creates image of levels from first level, records their copying from staging buffer into command buffer
+	// and replaces current image with it, returns texture with replaced image
+	// which must be destroyed when commands that use it are executed
+	TextureImage* replaceImage(uint32_t firstLevel, const StagingBuffer *stagingBuffer, VkCommandBuffer commandBuffer);
+
+private:
+	KtxFile *file;
+
+	uint32_t residentLevel;
+
+	uint32_t tailLevel;
+
+	VkFilter filter;
+
+	VkSamplerAddressMode samplerAddressMode;
+
+	// copy regions of levels from first level, offsets are aligned by block size
+	std::vector<VkBufferImageCopy> getCopyRegions(uint32_t firstLevel) const;
+};
+
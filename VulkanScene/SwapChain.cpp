@@ -47,6 +47,11 @@ VkFormat SwapChain::getImageFormat() const
     return imageFormat;
 }
 
+VkImageLayout SwapChain::getFinalLayout() const
+{
+	return VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+}
+
 void SwapChain::recreate(VkExtent2D newExtent)
 {
 	cleanup();
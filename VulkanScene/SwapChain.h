@@ -2,8 +2,9 @@
 
 #include <vulkan/vulkan.h>
 #include <vector>
+#include "RenderTarget.h"
 
-class SwapChain
+class SwapChain : public RenderTarget
 {
 public:
 	SwapChain(Device *device, VkSurfaceKHR surface, VkExtent2D surfaceExtent);
@@ -12,15 +13,17 @@ public:
 
 	VkSwapchainKHR get() const;
 
-	std::vector<VkImageView> getImageViews() const;
+	std::vector<VkImageView> getImageViews() const override;
 
-	VkExtent2D getExtent() const;
+	VkExtent2D getExtent() const override;
 
-	uint32_t getImageCount() const;
+	uint32_t getImageCount() const override;
 
-	VkFormat getImageFormat() const;
+	VkFormat getImageFormat() const override;
 
-	void recreate(VkExtent2D newExtent);
+	VkImageLayout getFinalLayout() const override;
+
+	void recreate(VkExtent2D newExtent) override;
 
 private:
 	const VkSurfaceFormatKHR PREFERRED_PRESENT_FORMAT = { VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
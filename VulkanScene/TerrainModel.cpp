@@ -1,6 +1,7 @@
-#include "Vertex.h"
-#include "Mesh.h"
+#include "VertexQuantizer.h"
+#include "PackedMesh.h"
 #include "File.h"
+#include "TextureCache.h"
 
 #include "TerrainModel.h"
 
@@ -21,22 +22,20 @@ TerrainModel::~TerrainModel()
 {
 	for (auto texture : textures)
 	{
-		delete texture;
+		device->getTextureCache()->release(texture);
 	}
 }
 
 // protected:
 
-VkVertexInputBindingDescription TerrainModel::getVertexBindingDescription(uint32_t binding)
+std::vector<VkVertexInputBindingDescription> TerrainModel::getVertexBindingDescriptions(uint32_t attributeCount)
 {
-	return Vertex::getBindingDescription(binding);
+	return PackedVertex::getBindingDescriptions(attributeCount);
 }
 
-std::vector<VkVertexInputAttributeDescription> TerrainModel::getVertexAttributeDescriptions(
-    uint32_t binding,
-    uint32_t locationOffset)
+std::vector<VkVertexInputAttributeDescription> TerrainModel::getVertexAttributeDescriptions(uint32_t attributeCount)
 {
-	return Vertex::getAttributeDescriptions(binding, locationOffset);
+	return PackedVertex::getAttributeDescriptions(attributeCount);
 }
 
 // private:
@@ -61,13 +60,19 @@ void TerrainModel::initMaterial(const std::string &texturesDirectory, const std:
 	{
 		if (File::exists(paths[i]))
 		{
-			auto texture = new TextureImage(
-                device,
-                { paths[i] },
-                1,
-                false,
-                VK_FILTER_LINEAR,
-                VK_SAMPLER_ADDRESS_MODE_REPEAT);
+			const std::string &path = paths[i];
+			auto texture = device->getTextureCache()->acquire(
+				TextureCache::getKey({ path }, false, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT),
+				[this, &path]()
+				{
+					return new TextureImage(
+						device,
+						{ path },
+						1,
+						false,
+						VK_FILTER_LINEAR,
+						VK_SAMPLER_ADDRESS_MODE_REPEAT);
+				});
 
 			material->addTexture(types[i], texture);
 			textures.push_back(texture);
@@ -82,6 +87,7 @@ void TerrainModel::initMesh()
 	const float posX = cellSize.x * cellCount.width / 2.0f;
 	const float posZ = cellSize.y * cellCount.height / 2.0f;
 
+	// zero tangents can't be packed, so each vertex has tangent along u
 	std::vector<Vertex> vertices;
 
 	// -x, -z
@@ -89,7 +95,7 @@ void TerrainModel::initMesh()
 		glm::vec3(-posX, 0.0f, -posZ),
 		glm::vec2(0.0f, 0.0f),
 		glm::vec3(0.0f, -1.0f, 0.0f),
-		glm::vec3()
+		glm::vec3(1.0f, 0.0f, 0.0f)
 	};
 	vertices.push_back(vertex);
 
@@ -98,7 +104,7 @@ void TerrainModel::initMesh()
 		glm::vec3(posX, 0.0f, -posZ),
 		glm::vec2(cellCount.width, 0.0f),
 		glm::vec3(0.0f, -1.0f, 0.0f),
-		glm::vec3()
+		glm::vec3(1.0f, 0.0f, 0.0f)
 	};
 	vertices.push_back(vertex);
 
@@ -107,7 +113,7 @@ void TerrainModel::initMesh()
 		glm::vec3(posX, 0.0f, posZ),
 		glm::vec2(cellCount.width, cellCount.height),
 		glm::vec3(0.0f, -1.0f, 0.0f),
-		glm::vec3()
+		glm::vec3(1.0f, 0.0f, 0.0f)
 	};
 	vertices.push_back(vertex);
 
@@ -125,5 +131,24 @@ void TerrainModel::initMesh()
 		1, 2, 3
 	};
 
-	solidMeshes.push_back(new Mesh<Vertex>(device, vertices, indices, materials.at(0)));
+	const BoundingVolume bounds(glm::vec3(-posX, 0.0f, -posZ), glm::vec3(posX, 0.0f, posZ));
+	const PackedVertex::Streams streams = PackedVertex::split(VertexQuantizer::quantize(vertices, bounds));
+
+	const auto vertexCount = uint32_t(vertices.size());
+	geometryArena = new GeometryArena(
+		device,
+		PackedVertex::getStreamStrides(),
+		vertexCount,
+		uint32_t(indices.size()),
+		vertexCount);
+
+	solidMeshes.push_back(new PackedMesh(
+		geometryArena,
+		streams.positions.data(),
+		streams.attributes.data(),
+		uint32_t(streams.positions.size()),
+		indices.data(),
+		uint32_t(indices.size()),
+		materials.at(0),
+		bounds));
 }
\ No newline at end of file
@@ -15,11 +15,9 @@ public:
 	~TerrainModel();
 
 protected:
-	VkVertexInputBindingDescription getVertexBindingDescription(uint32_t binding) override;
+	std::vector<VkVertexInputBindingDescription> getVertexBindingDescriptions(uint32_t attributeCount) override;
 
-	std::vector<VkVertexInputAttributeDescription> getVertexAttributeDescriptions(
-        uint32_t binding,
-        uint32_t locationOffset) override;
+	std::vector<VkVertexInputAttributeDescription> getVertexAttributeDescriptions(uint32_t attributeCount) override;
 
 private:
 	glm::vec2 cellSize;
@@ -0,0 +1,109 @@
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+#include <cassert>
+#include <tuple>
+#include "File.h"
+#include "TextureImage.h"
+
+#include "TextureCache.h"
+
+// public:
+
+bool TextureCache::Key::operator<(const Key &other) const
+{
+	return std::tie(paths, cubeMap, filter, addressMode)
+		< std::tie(other.paths, other.cubeMap, other.filter, other.addressMode);
+}
+
+TextureCache::~TextureCache()
+{
+	for (const auto &[key, entry] : entries)
+	{
+		delete entry.texture;
+	}
+}
+
+TextureCache::Key TextureCache::getKey(
+	const std::vector<std::string> &paths,
+	bool cubeMap,
+	VkFilter filter,
+	VkSamplerAddressMode addressMode)
+{
+	Key key{ {}, cubeMap, filter, addressMode };
+
+	for (const auto &path : paths)
+	{
+		std::string canonicalPath = std::filesystem::weakly_canonical(File::getAbsolute(path)).string();
+
+		// file system is case insensitive
+		std::transform(canonicalPath.begin(), canonicalPath.end(), canonicalPath.begin(), [](char c)
+		{
+			return char(std::tolower(static_cast<unsigned char>(c)));
+		});
+
+		key.paths.push_back(canonicalPath);
+	}
+
+	return key;
+}
+
+bool TextureCache::contains(const Key &key) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return entries.find(key) != entries.end();
+}
+
+TextureImage* TextureCache::acquire(const Key &key, const std::function<TextureImage*()> &create)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	const auto it = entries.find(key);
+	if (it != entries.end())
+	{
+		it->second.referenceCount++;
+
+		statistics.hits++;
+		statistics.savedBytes += it->second.texture->getMemorySize();
+
+		return it->second.texture;
+	}
+
+	TextureImage *texture = create();
+	const VkDeviceSize memorySize = texture->getMemorySize();
+	entries.insert({ key, { texture, 1, memorySize } });
+
+	statistics.misses++;
+	statistics.textureCount++;
+	statistics.cachedBytes += memorySize;
+
+	return texture;
+}
+
+void TextureCache::release(TextureImage *texture)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	const auto it = std::find_if(entries.begin(), entries.end(), [texture](const auto &entry)
+	{
+		return entry.second.texture == texture;
+	});
+	assert(it != entries.end());
+
+	if (--it->second.referenceCount == 0)
+	{
+		statistics.textureCount--;
+		statistics.cachedBytes -= it->second.memorySize;
+
+		delete texture;
+		entries.erase(it);
+	}
+}
+
+TextureCache::Statistics TextureCache::getStatistics() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return statistics;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <functional>
+
+class TextureImage;
+
+// device-wide cache of textures loaded from files,
+// textures are shared by key (canonical paths and sampler parameters) and counted by references
+class TextureCache
+{
+public:
+	struct Key
+	{
+		// canonical absolute paths of array layers
+		std::vector<std::string> paths;
+
+		bool cubeMap;
+
+		VkFilter filter;
+
+		VkSamplerAddressMode addressMode;
+
+		bool operator<(const Key &other) const;
+	};
+
+	struct Statistics
+	{
+		uint64_t hits;
+
+		uint64_t misses;
+
+		uint32_t textureCount;
+
+		// device memory of cached textures
+		VkDeviceSize cachedBytes;
+
+		// device memory which would be allocated for duplicates without cache
+		VkDeviceSize savedBytes;
+	};
+
+	TextureCache() = default;
+
+	// destroys textures which weren't released
+	~TextureCache();
+
+	// paths are relative to base directory
+	static Key getKey(
+		const std::vector<std::string> &paths,
+		bool cubeMap,
+		VkFilter filter,
+		VkSamplerAddressMode addressMode);
+
+	// doesn't change statistics and references
+	bool contains(const Key &key) const;
+
+	// returns texture with such key and adds reference to it,
+	// texture is created by function if it isn't cached (lock is held while it's created)
+	TextureImage* acquire(const Key &key, const std::function<TextureImage*()> &create);
+
+	// texture is destroyed when its last reference is released
+	void release(TextureImage *texture);
+
+	Statistics getStatistics() const;
+
+private:
+	struct Entry
+	{
+		TextureImage *texture;
+
+		uint32_t referenceCount;
+
+		// memory size at insertion (streamed texture grows after it), it's subtracted on release
+		VkDeviceSize memorySize;
+	};
+
+	mutable std::mutex mutex;
+
+	std::map<Key, Entry> entries;
+
+	Statistics statistics{};
+};
+
@@ -0,0 +1,172 @@
+#include <filesystem>
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include "File.h"
+#include "BlockCompressor.h"
+#include "KtxFile.h"
+#include "SceneDao.h"
+#include "CpuProfiler.h"
+
+#include "TextureCooker.h"
+
+// public:
+
+std::string TextureCooker::getCookedPath(const std::string &path)
+{
+	return path + ".ktx2";
+}
+
+bool TextureCooker::isCooked(const std::string &path)
+{
+	std::error_code errorCode;
+	const auto imageTime = std::filesystem::last_write_time(File::getAbsolute(path), errorCode);
+	const auto cookedTime = std::filesystem::last_write_time(File::getAbsolute(getCookedPath(path)), errorCode);
+
+	return !errorCode && cookedTime >= imageTime;
+}
+
+VkFormat TextureCooker::getFormat(aiTextureType type)
+{
+	switch (type)
+	{
+	case aiTextureType_NORMALS:
+	case aiTextureType_HEIGHT:
+		return VK_FORMAT_BC5_UNORM_BLOCK;
+	case aiTextureType_SPECULAR:
+	case aiTextureType_OPACITY:
+		return VK_FORMAT_BC4_UNORM_BLOCK;
+	default:
+		return VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+	}
+}
+
+bool TextureCooker::cook(const std::string &path, const TextureImage::Pixels &pixels, aiTextureType type)
+{
+	const CpuProfiler::Scope profilerScope("TextureCooker::cook");
+
+	const VkFormat format = getFormat(type);
+
+	std::vector<std::vector<uint8_t>> levels;
+
+	VkExtent2D extent = pixels.extent;
+	std::vector<uint8_t> levelPixels(pixels.data, pixels.data + extent.width * extent.height * 4);
+	while (true)
+	{
+		levels.push_back(BlockCompressor::encode(format, levelPixels.data(), extent));
+
+		if (extent.width == 1 && extent.height == 1)
+		{
+			break;
+		}
+
+		levelPixels = getNextLevel(levelPixels, extent);
+		extent = { std::max(extent.width / 2, 1u), std::max(extent.height / 2, 1u) };
+	}
+
+	return KtxFile::save(getCookedPath(path), format, pixels.extent, levels);
+}
+
+void TextureCooker::cookScene(const std::string &scenePath, JobPool *jobPool)
+{
+	// texture is cooked by type of its first usage
+	std::map<std::string, aiTextureType> textureTypes;
+
+	std::vector<AssimpModel::Source*> sources;
+	for (const auto &modelPath : SceneDao(scenePath).getModelPaths())
+	{
+		AssimpModel::Source *source = AssimpModel::loadSource(modelPath, false, nullptr, jobPool);
+		for (const auto &materialData : source->materials)
+		{
+			for (const auto &[type, path] : materialData.textures)
+			{
+				textureTypes.insert({ File::getPath(source->directory, path), type });
+			}
+		}
+		sources.push_back(source);
+	}
+
+	// pixels of each texture are taken from source which loaded it
+	std::vector<std::pair<std::string, TextureImage::Pixels>> textures;
+	for (const auto source : sources)
+	{
+		for (const auto &[path, pixels] : source->textures)
+		{
+			const std::string fullPath = File::getPath(source->directory, path);
+			const auto sameTexture = [&fullPath](const auto &texture) { return texture.first == fullPath; };
+
+			if (std::find_if(textures.begin(), textures.end(), sameTexture) == textures.end())
+			{
+				textures.emplace_back(fullPath, pixels);
+			}
+		}
+	}
+
+	std::vector<VkDeviceSize> uncompressedSizes(textures.size(), 0);
+	std::vector<VkDeviceSize> cookedSizes(textures.size(), 0);
+
+	jobPool->parallelFor(uint32_t(textures.size()), [&](uint32_t index)
+	{
+		const auto &[path, pixels] = textures[index];
+
+		if (cook(path, pixels, textureTypes.at(path)))
+		{
+			// RGBA8 mip chain takes 4/3 of base level
+			uncompressedSizes[index] = VkDeviceSize(pixels.extent.width) * pixels.extent.height * 4 * 4 / 3;
+			cookedSizes[index] = std::filesystem::file_size(File::getAbsolute(getCookedPath(path)));
+		}
+		else
+		{
+			std::cout << "Texture isn't cooked: " << path << std::endl;
+		}
+	});
+
+	for (auto source : sources)
+	{
+		delete source;
+	}
+
+	VkDeviceSize uncompressedSize = 0;
+	VkDeviceSize cookedSize = 0;
+	for (size_t i = 0; i < textures.size(); i++)
+	{
+		uncompressedSize += uncompressedSizes[i];
+		cookedSize += cookedSizes[i];
+	}
+
+	std::cout << "Cooked textures: " << textures.size() << ", "
+		<< "RGBA8 mip chains: " << uncompressedSize / (1024 * 1024) << " MB, "
+		<< "KTX2 files: " << cookedSize / (1024 * 1024) << " MB" << std::endl;
+}
+
+// private:
+
+std::vector<uint8_t> TextureCooker::getNextLevel(const std::vector<uint8_t> &pixels, VkExtent2D extent)
+{
+	const VkExtent2D nextExtent{ std::max(extent.width / 2, 1u), std::max(extent.height / 2, 1u) };
+
+	std::vector<uint8_t> nextPixels(nextExtent.width * nextExtent.height * 4);
+	for (uint32_t y = 0; y < nextExtent.height; y++)
+	{
+		for (uint32_t x = 0; x < nextExtent.width; x++)
+		{
+			// odd edge pixels are repeated
+			const uint32_t x0 = std::min(x * 2, extent.width - 1);
+			const uint32_t x1 = std::min(x * 2 + 1, extent.width - 1);
+			const uint32_t y0 = std::min(y * 2, extent.height - 1);
+			const uint32_t y1 = std::min(y * 2 + 1, extent.height - 1);
+
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				const uint32_t sum = pixels[(y0 * extent.width + x0) * 4 + c]
+					+ pixels[(y0 * extent.width + x1) * 4 + c]
+					+ pixels[(y1 * extent.width + x0) * 4 + c]
+					+ pixels[(y1 * extent.width + x1) * 4 + c];
+
+				nextPixels[(y * nextExtent.width + x) * 4 + c] = uint8_t((sum + 2) / 4);
+			}
+		}
+	}
+
+	return nextPixels;
+}
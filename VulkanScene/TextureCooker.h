@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include <assimp/scene.h>
+#include "TextureImage.h"
+#include "JobPool.h"
+
+// converts images into KTX2 files (next to image with suffix ".ktx2") with precomputed mip chain,
+// block compressed format depends on texture type:
+// BC5 for normal maps, BC4 for single channel maps (specular, opacity), BC1 for colors
+class TextureCooker
+{
+public:
+	static std::string getCookedPath(const std::string &path);
+
+	// cooked file exists and it isn't older than image
+	static bool isCooked(const std::string &path);
+
+	static VkFormat getFormat(aiTextureType type);
+
+	// writes cooked file of image with such pixels, returns false if file can't be written
+	static bool cook(const std::string &path, const TextureImage::Pixels &pixels, aiTextureType type);
+
+	// cooks textures of all models of scene and prints sizes of uncompressed and cooked mip chains
+	static void cookScene(const std::string &scenePath, JobPool *jobPool);
+
+private:
+	// level with half extent filtered by 2x2 box
+	static std::vector<uint8_t> getNextLevel(const std::vector<uint8_t> &pixels, VkExtent2D extent);
+};
+
@@ -4,6 +4,7 @@
 
 #include "TextureImage.h"
 #include "File.h"
+#include "CpuProfiler.h"
 #include <cmath>
 
 // public:
@@ -16,22 +17,48 @@ TextureImage::TextureImage(
 	VkFilter filter,
 	VkSamplerAddressMode samplerAddressMode)
 {
+	const CpuProfiler::Scope profilerScope("TextureImage::TextureImage");
+
 	assert(arrayLayers == paths.size());
 
 	// loads image bytes for each array layer
-	std::vector<const void*> pixels(arrayLayers);
+	std::vector<Pixels> layers(arrayLayers);
 	for (uint32_t i = 0; i < arrayLayers; i++)
 	{
-		pixels[i] = loadPixels(paths[i]);
+		layers[i] = loadPixels(paths[i]);
 	}
 
+	createFromPixels(device, layers, cubeMap, filter, samplerAddressMode);
+
+    for (auto layer : layers)
+    {
+		freePixels(layer);
+    }
+}
+
+TextureImage::TextureImage(
+	Device *device,
+	const std::vector<Pixels> &layers,
+	bool cubeMap,
+	VkFilter filter,
+	VkSamplerAddressMode samplerAddressMode)
+{
+	const CpuProfiler::Scope profilerScope("TextureImage::TextureImage");
+
+	createFromPixels(device, layers, cubeMap, filter, samplerAddressMode);
+}
+
+TextureImage::TextureImage(Device *device, const KtxFile &file, VkFilter filter, VkSamplerAddressMode samplerAddressMode)
+{
+	const CpuProfiler::Scope profilerScope("TextureImage::TextureImage");
+
+	assert(file.isValid());
+
 	this->device = device;
 
-	format = VK_FORMAT_R8G8B8A8_UNORM;
-	extent.depth = 1;
-	mipLevels = static_cast<uint32_t>(std::ceil(
-		std::log2(std::max(extent.width, extent.height))));
-	mipLevels = mipLevels > 0 ? mipLevels : 1;
+	format = file.getFormat();
+	extent = { file.getExtent().width, file.getExtent().height, 1 };
+	mipLevels = file.getLevelCount();
 
 	createThisImage(
 		device,
@@ -41,22 +68,46 @@ TextureImage::TextureImage(
 		mipLevels,
 		format,
 		VK_IMAGE_TILING_OPTIMAL,
-		VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-		arrayLayers,
-		cubeMap,
+		VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+		1,
+		false,
 		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
 		VK_IMAGE_ASPECT_COLOR_BIT);
+	addMemorySize();
 
+	// all levels are copied by one staging buffer, offsets of levels are aligned by block size
+	const VkDeviceSize blockSize = KtxFile::getBlockSize(format);
+	std::vector<VkBufferImageCopy> regions(mipLevels);
+	VkDeviceSize stagingSize = 0;
+	for (uint32_t i = 0; i < mipLevels; i++)
+	{
+		const KtxFile::Level level = file.getLevel(i);
 
-	updateData(pixels, 0, STBI_rgb_alpha);
+		stagingSize = (stagingSize + blockSize - 1) / blockSize * blockSize;
+		regions[i] = VkBufferImageCopy{
+			stagingSize,
+			0,
+			0,
+			{ VK_IMAGE_ASPECT_COLOR_BIT, i, 0, 1 },
+			{ 0, 0, 0 },
+			{ level.extent.width, level.extent.height, 1 }
+		};
+		stagingSize += level.size;
+	}
 
-    for (auto arrayLayerPixels : pixels)
-    {
-		stbi_image_free(const_cast<void*>(arrayLayerPixels));
-    }
+	StagingBuffer *stagingBuffer = new StagingBuffer(device, stagingSize);
+	for (uint32_t i = 0; i < mipLevels; i++)
+	{
+		const KtxFile::Level level = file.getLevel(i);
+		stagingBuffer->updateData(level.data, level.size, regions[i].bufferOffset);
+	}
 
-	// create other image objects
-	generateMipmaps(device, VK_IMAGE_ASPECT_COLOR_BIT, filter);
+	const VkImageSubresourceRange subresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, 1 };
+	transitLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresourceRange);
+	stagingBuffer->copyToImage(image, regions);
+	transitLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresourceRange);
+
+	device->releaseStagingBuffer(stagingBuffer);
 
 	createSampler(filter, samplerAddressMode);
 }
@@ -90,11 +141,15 @@ TextureImage::TextureImage(
 		properties,
 		aspectFlags)
 {
+	addMemorySize();
+
 	createSampler(filter, samplerAddressMode);
 }
 
 TextureImage::~TextureImage()
 {
+	totalMemorySize -= memorySize;
+
 	vkDestroySampler(device->get(), sampler, nullptr);
 }
 
@@ -103,22 +158,103 @@ VkSampler TextureImage::getSampler() const
 	return sampler;
 }
 
-// protected:
-
-stbi_uc* TextureImage::loadPixels(const std::string &path)
+TextureImage::Pixels TextureImage::loadPixels(const std::string &path)
 {
-	stbi_uc *pixels = stbi_load(
+	const CpuProfiler::Scope profilerScope("TextureImage::loadPixels");
+
+	Pixels pixels{};
+	pixels.data = stbi_load(
 		File::getAbsolute(path).c_str(),
-		reinterpret_cast<int*>(&extent.width),
-		reinterpret_cast<int*>(&extent.height),
+		reinterpret_cast<int*>(&pixels.extent.width),
+		reinterpret_cast<int*>(&pixels.extent.height),
 		nullptr,
 		STBI_rgb_alpha);
 
-	assert(pixels);
+	assert(pixels.data);
 
 	return pixels;
 }
 
+void TextureImage::freePixels(Pixels pixels)
+{
+	stbi_image_free(pixels.data);
+}
+
+VkDeviceSize TextureImage::getMemorySize() const
+{
+	return memorySize;
+}
+
+VkDeviceSize TextureImage::getTotalMemorySize()
+{
+	return totalMemorySize;
+}
+
+// protected:
+
+VkDeviceSize TextureImage::totalMemorySize = 0;
+
+void TextureImage::addMemorySize()
+{
+	VkMemoryRequirements memoryRequirements;
+	vkGetImageMemoryRequirements(device->get(), image, &memoryRequirements);
+
+	memorySize = memoryRequirements.size;
+	totalMemorySize += memorySize;
+}
+
+void TextureImage::swapTexture(TextureImage &other)
+{
+	swapImage(other);
+
+	std::swap(sampler, other.sampler);
+	std::swap(memorySize, other.memorySize);
+}
+
+void TextureImage::createFromPixels(
+	Device *device,
+	const std::vector<Pixels> &layers,
+	bool cubeMap,
+	VkFilter filter,
+	VkSamplerAddressMode samplerAddressMode)
+{
+	this->device = device;
+
+	format = VK_FORMAT_R8G8B8A8_UNORM;
+	extent = { layers[0].extent.width, layers[0].extent.height, 1 };
+	mipLevels = static_cast<uint32_t>(std::ceil(
+		std::log2(std::max(extent.width, extent.height))));
+	mipLevels = mipLevels > 0 ? mipLevels : 1;
+
+	createThisImage(
+		device,
+		extent,
+		0,
+		VK_SAMPLE_COUNT_1_BIT,
+		mipLevels,
+		format,
+		VK_IMAGE_TILING_OPTIMAL,
+		VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+		uint32_t(layers.size()),
+		cubeMap,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		VK_IMAGE_ASPECT_COLOR_BIT);
+	addMemorySize();
+
+	std::vector<const void*> pixels;
+	for (const auto &layer : layers)
+	{
+		assert(layer.extent.width == extent.width && layer.extent.height == extent.height);
+		pixels.push_back(layer.data);
+	}
+	updateData(pixels, 0, STBI_rgb_alpha);
+
+	// create other image objects
+	generateMipmaps(device, VK_IMAGE_ASPECT_COLOR_BIT, filter);
+
+	createSampler(filter, samplerAddressMode);
+}
+
 void TextureImage::generateMipmaps(
     Device *device,
     VkImageAspectFlags aspectFlags,
@@ -1,5 +1,6 @@
 #pragma once
 #include "Image.h"
+#include "KtxFile.h"
 
 #include <stb_image.h>
 #include <string>
@@ -8,6 +9,13 @@
 class TextureImage : public Image
 {
 public:
+	// RGBA pixels of image file, loading doesn't use device, so it can be done in any thread
+	struct Pixels
+	{
+		VkExtent2D extent;
+		stbi_uc *data;
+	};
+
 	TextureImage() = default;
 
 	TextureImage(
@@ -18,6 +26,17 @@ public:
 		VkFilter filter,
 		VkSamplerAddressMode samplerAddressMode);
 
+	// creates texture from pixels of each array layer which are already loaded (they aren't freed)
+	TextureImage(
+		Device *device,
+		const std::vector<Pixels> &layers,
+		bool cubeMap,
+		VkFilter filter,
+		VkSamplerAddressMode samplerAddressMode);
+
+	// creates texture from mip chain of KTX2 file which is uploaded directly from file mapping
+	TextureImage(Device *device, const KtxFile &file, VkFilter filter, VkSamplerAddressMode samplerAddressMode);
+
 	TextureImage(
 		Device *device,
 		VkExtent3D extent,
@@ -34,14 +53,38 @@ public:
 		VkFilter filter,
 		VkSamplerAddressMode samplerAddressMode);
 
-	~TextureImage();
+	// streamed textures are destroyed by cache through this type
+	virtual ~TextureImage();
 
 	VkSampler getSampler() const;
 
+	static Pixels loadPixels(const std::string &path);
+
+	static void freePixels(Pixels pixels);
+
+	VkDeviceSize getMemorySize() const;
+
+	// device memory of all existing textures
+	static VkDeviceSize getTotalMemorySize();
+
 protected:
 	VkSampler sampler;
 
-	stbi_uc* loadPixels(const std::string &path);
+	VkDeviceSize memorySize = 0;
+
+	static VkDeviceSize totalMemorySize;
+
+	void addMemorySize();
+
+	// exchanges images and samplers of both textures
+	void swapTexture(TextureImage &other);
+
+	void createFromPixels(
+		Device *device,
+		const std::vector<Pixels> &layers,
+		bool cubeMap,
+		VkFilter filter,
+		VkSamplerAddressMode samplerAddressMode);
 
 	// generate mipmap levels and transit image layout to SHADER_READ_ONLY
 	void generateMipmaps(Device *device, VkImageAspectFlags aspectFlags, VkFilter filter) const;
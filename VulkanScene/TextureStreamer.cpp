@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "StreamedTexture.h"
+#include "CpuProfiler.h"
+
+#include "TextureStreamer.h"
+
+// public:
+
+TextureStreamer::TextureStreamer(Device *device, VkDeviceSize budget, uint32_t frameCount)
+	: device(device), budget(budget), frameCount(frameCount)
+{
+	jobPool = new JobPool(1);
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	// streamed textures are destroyed before streamer
+	assert(entries.empty());
+
+	delete jobPool;
+
+	for (const auto &retiredImage : retired)
+	{
+		delete retiredImage.texture;
+		delete retiredImage.stagingBuffer;
+	}
+}
+
+void TextureStreamer::add(StreamedTexture *texture)
+{
+	entries.insert({ texture, { texture, 0.0f, texture->getResidentLevel(), nullptr } });
+}
+
+void TextureStreamer::remove(StreamedTexture *texture)
+{
+	const auto it = entries.find(texture);
+	assert(it != entries.end());
+
+	Load *load = it->second.load;
+	if (load)
+	{
+		// job can still write levels into staging buffer
+		jobPool->wait();
+
+		loadingBytes -= getBytes(texture, load->firstLevel);
+		delete load->stagingBuffer;
+		delete load;
+	}
+
+	residentBytes -= getBytes(texture, texture->getResidentLevel());
+
+	entries.erase(it);
+}
+
+void TextureStreamer::request(const TextureImage *texture, float screenSize)
+{
+	const auto it = entries.find(texture);
+	if (it != entries.end())
+	{
+		it->second.screenSize = std::max(it->second.screenSize, screenSize);
+	}
+}
+
+bool TextureStreamer::update(VkCommandBuffer commandBuffer)
+{
+	const CpuProfiler::Scope profilerScope("TextureStreamer::update");
+
+	frameNumber++;
+
+	destroyRetired();
+
+	const std::vector<Entry*> order = chooseLevels();
+	const bool recorded = replaceImages(commandBuffer);
+	startLoads(order);
+
+	for (auto &[key, entry] : entries)
+	{
+		entry.screenSize = 0.0f;
+	}
+
+	return recorded;
+}
+
+uint64_t TextureStreamer::getReplacementCount() const
+{
+	return replacementCount;
+}
+
+TextureStreamer::Statistics TextureStreamer::getStatistics() const
+{
+	Statistics statistics{
+		uint32_t(entries.size()),
+		0,
+		replacementCount,
+		residentBytes,
+		requestedBytes
+	};
+
+	for (const auto &[key, entry] : entries)
+	{
+		if (entry.load)
+		{
+			statistics.loadingCount++;
+		}
+	}
+
+	return statistics;
+}
+
+// private:
+
+VkDeviceSize TextureStreamer::getBytes(const StreamedTexture *texture, uint32_t firstLevel)
+{
+	return texture->getLevelsSize(firstLevel) - texture->getLevelsSize(texture->getTailLevel());
+}
+
+uint32_t TextureStreamer::getRequestedLevel(const StreamedTexture *texture, float screenSize)
+{
+	if (screenSize <= 0.0f)
+	{
+		return texture->getTailLevel();
+	}
+
+	const VkExtent2D extent = texture->getFileExtent();
+	const float level = std::floor(std::log2(float(std::max(extent.width, extent.height)) / screenSize));
+
+	return uint32_t(std::clamp(level, 0.0f, float(texture->getTailLevel())));
+}
+
+float TextureStreamer::getPriority(const Entry &entry)
+{
+	const VkExtent2D extent = entry.texture->getFileExtent();
+
+	return entry.screenSize / float(std::max(extent.width, extent.height));
+}
+
+void TextureStreamer::destroyRetired()
+{
+	// each frame in flight has waited for its fence since image was replaced,
+	// so commands which could use replaced image are executed
+	const auto finished = [this](const Retired &retiredImage)
+	{
+		return retiredImage.frameNumber + frameCount <= frameNumber;
+	};
+
+	for (const auto &retiredImage : retired)
+	{
+		if (finished(retiredImage))
+		{
+			retiredBytes -= retiredImage.bytes;
+			delete retiredImage.texture;
+			delete retiredImage.stagingBuffer;
+		}
+	}
+
+	retired.erase(std::remove_if(retired.begin(), retired.end(), finished), retired.end());
+}
+
+std::vector<TextureStreamer::Entry*> TextureStreamer::chooseLevels()
+{
+	std::vector<Entry*> order;
+	order.reserve(entries.size());
+	for (auto &[key, entry] : entries)
+	{
+		order.push_back(&entry);
+	}
+
+	std::sort(order.begin(), order.end(), [](const Entry *a, const Entry *b)
+	{
+		return getPriority(*a) > getPriority(*b);
+	});
+
+	VkDeviceSize remainingBytes = budget;
+	requestedBytes = 0;
+
+	for (auto entry : order)
+	{
+		const StreamedTexture *texture = entry->texture;
+
+		uint32_t level = getRequestedLevel(texture, entry->screenSize);
+		requestedBytes += getBytes(texture, level);
+
+		// texture isn't reduced by one level,
+		// so it isn't reloaded again and again when its size is near border of levels
+		if (level == texture->getResidentLevel() + 1)
+		{
+			level = texture->getResidentLevel();
+		}
+
+		// tail levels don't take budget
+		while (level < texture->getTailLevel() && getBytes(texture, level) > remainingBytes)
+		{
+			level++;
+		}
+
+		entry->targetLevel = level;
+		remainingBytes -= getBytes(texture, level);
+	}
+
+	return order;
+}
+
+bool TextureStreamer::replaceImages(VkCommandBuffer commandBuffer)
+{
+	VkDeviceSize uploadSize = 0;
+
+	for (auto &[key, entry] : entries)
+	{
+		Load *load = entry.load;
+		if (!load || !load->ready)
+		{
+			continue;
+		}
+
+		if (uploadSize >= MAX_FRAME_UPLOAD_SIZE)
+		{
+			break;
+		}
+
+		StreamedTexture *texture = entry.texture;
+		const VkDeviceSize replacedBytes = getBytes(texture, texture->getResidentLevel());
+		const VkDeviceSize bytes = getBytes(texture, load->firstLevel);
+
+		TextureImage *replacedTexture = texture->replaceImage(load->firstLevel, load->stagingBuffer, commandBuffer);
+		retired.push_back({ replacedTexture, load->stagingBuffer, replacedBytes, frameNumber });
+
+		residentBytes = residentBytes + bytes - replacedBytes;
+		loadingBytes -= bytes;
+		retiredBytes += replacedBytes;
+
+		uploadSize += load->stagingBuffer->getSize();
+		replacementCount++;
+
+		delete load;
+		entry.load = nullptr;
+	}
+
+	return uploadSize > 0;
+}
+
+void TextureStreamer::startLoads(const std::vector<Entry*> &order)
+{
+	uint32_t loadingCount = getStatistics().loadingCount;
+
+	// reduced textures free memory for enlarged ones, so they are loaded first
+	for (const bool reducing : { true, false })
+	{
+		for (auto entry : order)
+		{
+			if (loadingCount >= MAX_LOADING_COUNT)
+			{
+				return;
+			}
+
+			StreamedTexture *texture = entry->texture;
+			const uint32_t residentLevel = texture->getResidentLevel();
+			if (entry->load || entry->targetLevel == residentLevel || (entry->targetLevel > residentLevel) != reducing)
+			{
+				continue;
+			}
+
+			// new image is allocated before replaced one is destroyed,
+			// so texture isn't enlarged until both of them fit into budget
+			const VkDeviceSize bytes = getBytes(texture, entry->targetLevel);
+			if (!reducing && residentBytes + loadingBytes + retiredBytes + bytes > budget)
+			{
+				continue;
+			}
+
+			auto load = new Load{
+				entry->targetLevel,
+				new StagingBuffer(device, texture->getLevelsSize(entry->targetLevel))
+			};
+
+			jobPool->submit([texture, load]()
+			{
+				texture->writeLevels(load->firstLevel, load->stagingBuffer);
+				load->ready = true;
+			});
+
+			entry->load = load;
+			loadingBytes += bytes;
+			loadingCount++;
+		}
+	}
+}
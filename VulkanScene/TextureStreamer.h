@@ -0,0 +1,149 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include "JobPool.h"
+#include "StagingBuffer.h"
+
+class TextureImage;
+class StreamedTexture;
+
+// chooses resident levels of streamed textures by their size on screen,
+// levels are read from mapped files by background thread and uploaded by commands of frames,
+// levels above tails of all streamed textures are limited by memory budget
+// (textures with the largest screen size relative to their extent get budget first),
+// streamer is used only by main thread
+class TextureStreamer
+{
+public:
+	struct Statistics
+	{
+		uint32_t textureCount;
+
+		// textures which levels are being read from files
+		uint32_t loadingCount;
+
+		// count of replaced images
+		uint64_t replacementCount;
+
+		// device memory of resident levels above tails
+		VkDeviceSize residentBytes;
+
+		// device memory that requested levels above tails would take without budget
+		VkDeviceSize requestedBytes;
+	};
+
+	// images replaced in one frame are destroyed when frames in flight can't use them
+	TextureStreamer(Device *device, VkDeviceSize budget, uint32_t frameCount);
+
+	// device must be idle
+	~TextureStreamer();
+
+	// streamed textures add and remove themselves
+	void add(StreamedTexture *texture);
+
+	void remove(StreamedTexture *texture);
+
+	// texture is rendered with such size in pixels, the largest size of frame is used,
+	// textures which aren't streamed are ignored
+	void request(const TextureImage *texture, float screenSize);
+
+	// chooses resident levels by requests of this frame and starts reading levels from files,
+	// images of textures which levels are read are replaced and uploads are recorded into command buffer
+	// which must be executed before render passes of this frame, returns false if nothing is recorded
+	bool update(VkCommandBuffer commandBuffer);
+
+	// descriptor sets which contain streamed textures must be updated when this count is changed
+	uint64_t getReplacementCount() const;
+
+	Statistics getStatistics() const;
+
+private:
+	// textures which levels can be read at the same time
+	const uint32_t MAX_LOADING_COUNT = 8;
+
+	// next textures are replaced by next frames when upload of frame exceeds this size
+	const VkDeviceSize MAX_FRAME_UPLOAD_SIZE = 32 * 1024 * 1024;
+
+	struct Load
+	{
+		uint32_t firstLevel;
+
+		StagingBuffer *stagingBuffer;
+
+		// levels are written into staging buffer
+		std::atomic<bool> ready{ false };
+	};
+
+	struct Entry
+	{
+		StreamedTexture *texture;
+
+		// the largest requested size of current frame
+		float screenSize;
+
+		uint32_t targetLevel;
+
+		// null if levels aren't being read
+		Load *load;
+	};
+
+	// replaced image and staging buffer of its replacement
+	struct Retired
+	{
+		TextureImage *texture;
+
+		StagingBuffer *stagingBuffer;
+
+		VkDeviceSize bytes;
+
+		uint64_t frameNumber;
+	};
+
+	Device *device;
+
+	VkDeviceSize budget;
+
+	uint32_t frameCount;
+
+	uint64_t frameNumber = 0;
+
+	uint64_t replacementCount = 0;
+
+	std::unordered_map<const TextureImage*, Entry> entries;
+
+	std::vector<Retired> retired;
+
+	// one thread reads files, so reading doesn't compete with rendering
+	JobPool *jobPool;
+
+	// memory above tails is counted for resident images, images of loads and retired images
+	VkDeviceSize residentBytes = 0;
+
+	VkDeviceSize loadingBytes = 0;
+
+	VkDeviceSize retiredBytes = 0;
+
+	VkDeviceSize requestedBytes = 0;
+
+	// device memory of levels from first level excluding tail levels
+	static VkDeviceSize getBytes(const StreamedTexture *texture, uint32_t firstLevel);
+
+	// level which extent matches screen size
+	static uint32_t getRequestedLevel(const StreamedTexture *texture, float screenSize);
+
+	// textures with larger screen size relative to their extent are more important
+	static float getPriority(const Entry &entry);
+
+	void destroyRetired();
+
+	// returns entries in order of priority
+	std::vector<Entry*> chooseLevels();
+
+	bool replaceImages(VkCommandBuffer commandBuffer);
+
+	void startLoads(const std::vector<Entry*> &order);
+};
+
@@ -0,0 +1,58 @@
+#include <cassert>
+
+#include "UniformRing.h"
+
+// public:
+
+UniformRing::UniformRing(Device *device, VkDeviceSize frameSize, uint32_t frameCount)
+	: StagingBuffer(
+		device,
+		getAlignedFrameSize(device, frameSize) * frameCount,
+		VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+		MemoryAllocator::FREE_LIST)
+{
+	this->frameSize = frameSize;
+	this->frameCount = frameCount;
+	alignedFrameSize = getAlignedFrameSize(device, frameSize);
+}
+
+void UniformRing::updateFrameData(const void *data, VkDeviceSize dataSize, VkDeviceSize offset, uint32_t frameIndex)
+{
+	assert(offset + dataSize <= frameSize);
+	assert(frameIndex < frameCount);
+
+	uint8_t *frameData = reinterpret_cast<uint8_t*>(stagingMemory.mappedData) + getDynamicOffset(frameIndex);
+	memcpy(frameData + offset, data, dataSize);
+}
+
+void UniformRing::updateData(const void *data, VkDeviceSize dataSize, VkDeviceSize offset)
+{
+	for (uint32_t i = 0; i < frameCount; i++)
+	{
+		updateFrameData(data, dataSize, offset, i);
+	}
+}
+
+VkDeviceSize UniformRing::getFrameSize() const
+{
+	return frameSize;
+}
+
+uint32_t UniformRing::getFrameCount() const
+{
+	return frameCount;
+}
+
+uint32_t UniformRing::getDynamicOffset(uint32_t frameIndex) const
+{
+	return uint32_t(alignedFrameSize * frameIndex);
+}
+
+// private:
+
+VkDeviceSize UniformRing::getAlignedFrameSize(Device *device, VkDeviceSize frameSize)
+{
+	const VkDeviceSize alignment = device->getLimits().minUniformBufferOffsetAlignment;
+
+	return (frameSize + alignment - 1) / alignment * alignment;
+}
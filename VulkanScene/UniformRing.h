@@ -0,0 +1,35 @@
+#pragma once
+
+#include "StagingBuffer.h"
+
+// host visible uniform buffer divided into slices (one slice for each frame in flight),
+// memory is persistently mapped, slice is selected with dynamic offset when binding descriptor set
+class UniformRing : public StagingBuffer
+{
+public:
+	UniformRing(Device *device, VkDeviceSize frameSize, uint32_t frameCount);
+
+	// writes data into slice of this frame only
+	void updateFrameData(const void *data, VkDeviceSize dataSize, VkDeviceSize offset, uint32_t frameIndex);
+
+	// writes data into slices of all frames
+	void updateData(const void *data, VkDeviceSize dataSize, VkDeviceSize offset) override;
+
+	// returns size of data in one slice (descriptor range)
+	VkDeviceSize getFrameSize() const;
+
+	uint32_t getFrameCount() const;
+
+	// returns offset of frame slice for vkCmdBindDescriptorSets
+	uint32_t getDynamicOffset(uint32_t frameIndex) const;
+
+private:
+	VkDeviceSize frameSize;
+
+	VkDeviceSize alignedFrameSize;
+
+	uint32_t frameCount;
+
+	static VkDeviceSize getAlignedFrameSize(Device *device, VkDeviceSize frameSize);
+};
+
@@ -3,9 +3,9 @@
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
-#include <vulkan/vulkan.h>
-#include <vector>
 
+// full precision vertex of imported and generated meshes,
+// it's packed into PackedVertex before upload
 struct Vertex
 {
 	glm::vec3 pos = glm::vec3(0.0f);
@@ -13,8 +13,7 @@ struct Vertex
 	glm::vec3 normal = glm::vec3(0.0f, 0.0f, 1.0f);	
 	glm::vec3 tangent = glm::vec3(0.0f);
 
-	static VkVertexInputBindingDescription getBindingDescription(uint32_t binding);
-
-	static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions(uint32_t binding, uint32_t locationOffset);
+	// -1 if bitangent is opposite to cross(tangent, normal) (mirrored texture coordinates)
+	float bitangentSign = 1.0f;
 };
 
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cmath>
+#include "CpuProfiler.h"
+
+#include "VertexQuantizer.h"
+
+// public:
+
+uint64_t VertexQuantizer::Statistics::getUnpackedSize() const
+{
+	return vertexCount * sizeof(Vertex);
+}
+
+uint64_t VertexQuantizer::Statistics::getPackedSize() const
+{
+	return vertexCount * sizeof(PackedVertex);
+}
+
+bool VertexQuantizer::Statistics::isAccurate() const
+{
+	return positionError <= POSITION_TOLERANCE
+		&& uvError <= UV_TOLERANCE
+		&& normalError <= DIRECTION_TOLERANCE
+		&& tangentError <= DIRECTION_TOLERANCE
+		&& !bitangentSignError;
+}
+
+VertexQuantizer::Statistics& VertexQuantizer::Statistics::operator+=(const Statistics &other)
+{
+	vertexCount += other.vertexCount;
+	positionError = std::max(positionError, other.positionError);
+	uvError = std::max(uvError, other.uvError);
+	normalError = std::max(normalError, other.normalError);
+	tangentError = std::max(tangentError, other.tangentError);
+	bitangentSignError = bitangentSignError || other.bitangentSignError;
+
+	return *this;
+}
+
+std::vector<PackedVertex> VertexQuantizer::quantize(const std::vector<Vertex> &vertices, const BoundingVolume &bounds)
+{
+	const CpuProfiler::Scope profilerScope("VertexQuantizer::quantize");
+
+	std::vector<PackedVertex> packedVertices;
+	packedVertices.reserve(vertices.size());
+
+	Statistics meshStatistics{ vertices.size(), 0.0f, 0.0f, 0.0f, 0.0f, false };
+	const glm::vec3 extent = bounds.getMax() - bounds.getMin();
+
+	for (const auto &vertex : vertices)
+	{
+		const PackedVertex packedVertex = PackedVertex::pack(vertex, bounds);
+		const Vertex unpackedVertex = packedVertex.unpack(bounds);
+
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			if (extent[i] > 0.0f)
+			{
+				const float error = std::abs(unpackedVertex.pos[i] - vertex.pos[i]) / extent[i];
+				meshStatistics.positionError = std::max(meshStatistics.positionError, error);
+			}
+		}
+
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			const float error = std::abs(unpackedVertex.uv[i] - vertex.uv[i]) / std::max(std::abs(vertex.uv[i]), 1.0f);
+			meshStatistics.uvError = std::max(meshStatistics.uvError, error);
+		}
+
+		meshStatistics.normalError = std::max(meshStatistics.normalError, getAngle(unpackedVertex.normal, vertex.normal));
+		meshStatistics.tangentError = std::max(meshStatistics.tangentError, getAngle(unpackedVertex.tangent, vertex.tangent));
+
+		if ((unpackedVertex.bitangentSign < 0.0f) != (vertex.bitangentSign < 0.0f))
+		{
+			meshStatistics.bitangentSignError = true;
+		}
+
+		packedVertices.push_back(packedVertex);
+	}
+
+	std::lock_guard<std::mutex> lock(statisticsMutex);
+	statistics += meshStatistics;
+
+	return packedVertices;
+}
+
+VertexQuantizer::Statistics VertexQuantizer::getStatistics()
+{
+	std::lock_guard<std::mutex> lock(statisticsMutex);
+	return statistics;
+}
+
+void VertexQuantizer::resetStatistics()
+{
+	std::lock_guard<std::mutex> lock(statisticsMutex);
+	statistics = {};
+}
+
+// private:
+
+std::mutex VertexQuantizer::statisticsMutex;
+
+VertexQuantizer::Statistics VertexQuantizer::statistics{};
+
+float VertexQuantizer::getAngle(glm::vec3 a, glm::vec3 b)
+{
+	const float lengths = glm::length(a) * glm::length(b);
+	if (!(lengths > 0.0f))
+	{
+		return 0.0f;
+	}
+
+	// acos isn't precise for small angles
+	return glm::degrees(std::atan2(glm::length(glm::cross(a, b)), glm::dot(a, b)));
+}
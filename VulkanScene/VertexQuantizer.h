@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include "PackedVertex.h"
+
+// packs vertices of meshes and measures quantization error by unpacking them again,
+// error totals of all packed meshes are kept (meshes can be packed by several threads)
+class VertexQuantizer
+{
+public:
+	// the largest errors of packed vertices
+	struct Statistics
+	{
+		uint64_t vertexCount;
+
+		// relative to mesh extent along axis
+		float positionError;
+
+		// relative to uv if its absolute value is larger than 1
+		float uvError;
+
+		// angle in degrees
+		float normalError;
+
+		float tangentError;
+
+		bool bitangentSignError;
+
+		// vertex buffer sizes in bytes
+		uint64_t getUnpackedSize() const;
+
+		uint64_t getPackedSize() const;
+
+		// errors don't exceed precision of packed formats
+		bool isAccurate() const;
+
+		Statistics& operator+=(const Statistics &other);
+	};
+
+	// errors of vertex which are allowed by precision of its packed format
+	static constexpr float POSITION_TOLERANCE = 1.0f / 65535.0f;
+
+	static constexpr float UV_TOLERANCE = 1.0f / 2048.0f;
+
+	static constexpr float DIRECTION_TOLERANCE = 0.01f;
+
+	// bounds must contain all vertices
+	static std::vector<PackedVertex> quantize(const std::vector<Vertex> &vertices, const BoundingVolume &bounds);
+
+	static Statistics getStatistics();
+
+	static void resetStatistics();
+
+private:
+	static std::mutex statisticsMutex;
+
+	static Statistics statistics;
+
+	// zero directions (degenerate tangents) aren't measured
+	static float getAngle(glm::vec3 a, glm::vec3 b);
+};
+
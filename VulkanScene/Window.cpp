@@ -60,16 +60,24 @@ VkExtent2D Window::getClientExtent() const
 	return extent;
 }
 
-void Window::mainLoop() const
+void Window::mainLoop(CameraPath *recordedPath) const
 {
 	auto engine = getEngine(window);
 
+	const auto startTime = std::chrono::steady_clock::now();
+
 	while (!glfwWindowShouldClose(window))
 	{
 		glfwPollEvents();
 
 		controlCamera(engine->getCamera());
 		engine->drawFrame();
+
+		if (recordedPath)
+		{
+			const std::chrono::duration<float> time = std::chrono::steady_clock::now() - startTime;
+			recordedPath->addKey(time.count(), engine->getCamera());
+		}
 	}
 }
 
@@ -5,6 +5,7 @@
 #include "GLFW/glfw3native.h"
 #include <vulkan/vulkan.h>
 #include "Engine.h"
+#include "CameraPath.h"
 
 class Window
 {
@@ -26,7 +27,8 @@ public:
 
 	VkExtent2D getClientExtent() const;
 
-	void mainLoop() const;
+	// camera position of each frame is added to recorded path (if it isn't null)
+	void mainLoop(CameraPath *recordedPath = nullptr) const;
 
 private:
 	enum Key
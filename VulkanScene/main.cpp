@@ -1,13 +1,112 @@
+#include <string>
+#include <iostream>
+#ifdef _WIN32
 #include "Window.h"
+#endif
+#include "Benchmark.h"
+#include "LoadBenchmark.h"
+#include "MeshBenchmark.h"
+#include "TextureCooker.h"
+#include "CpuProfiler.h"
 
+// usage:
+// VulkanScene
+// VulkanScene --record <camera path>
+// VulkanScene --benchmark <camera path> <report .csv/.json> [--resize-storm]
+// VulkanScene --load-benchmark <model path> <model count> <report .json>
+// VulkanScene --mesh-benchmark <camera path> <report .json>
+// VulkanScene --cook-textures
+// any mode can be followed by --trace <chrome trace .json>
 int main(int argc, char *argv[])
 {
+	std::string tracePath;
+	if (argc > 2 && std::string(argv[argc - 2]) == "--trace")
+	{
+		tracePath = argv[argc - 1];
+		argc -= 2;
+
+		CpuProfiler::setEnabled(true);
+	}
+
 	const Settings settings{
 		VK_SAMPLE_COUNT_4_BIT,
 		4096,
+		2,
+		false,
 		"Assets/FullScene.json",
+		0,
+		512 * 1024 * 1024,
 	};
 
+	const std::string mode = argc > 1 ? argv[1] : "";
+
+	if (mode == "--benchmark")
+	{
+		if (argc < 4)
+		{
+			std::cout << "Usage: VulkanScene --benchmark <camera path> <report> [--resize-storm]" << std::endl;
+			return 1;
+		}
+
+		Benchmark benchmark(settings, { 1920, 1080 }, argv[2]);
+		benchmark.setResizeStorm(argc > 4 && std::string(argv[4]) == "--resize-storm");
+		benchmark.run(argv[3]);
+
+		if (!tracePath.empty())
+		{
+			CpuProfiler::saveTrace(tracePath);
+		}
+
+		return 0;
+	}
+
+	if (mode == "--cook-textures")
+	{
+		JobPool jobPool(settings.loadingThreadCount);
+		TextureCooker::cookScene(settings.scenePath, &jobPool);
+
+		return 0;
+	}
+
+	if (mode == "--load-benchmark")
+	{
+		if (argc < 5)
+		{
+			std::cout << "Usage: VulkanScene --load-benchmark <model path> <model count> <report>" << std::endl;
+			return 1;
+		}
+
+		LoadBenchmark loadBenchmark(settings, argv[2], uint32_t(std::stoul(argv[3])));
+		loadBenchmark.run(argv[4]);
+
+		if (!tracePath.empty())
+		{
+			CpuProfiler::saveTrace(tracePath);
+		}
+
+		return 0;
+	}
+
+	if (mode == "--mesh-benchmark")
+	{
+		if (argc < 4)
+		{
+			std::cout << "Usage: VulkanScene --mesh-benchmark <camera path> <report>" << std::endl;
+			return 1;
+		}
+
+		MeshBenchmark meshBenchmark(settings, { 1920, 1080 }, argv[2]);
+		meshBenchmark.run(argv[3]);
+
+		if (!tracePath.empty())
+		{
+			CpuProfiler::saveTrace(tracePath);
+		}
+
+		return 0;
+	}
+
+#ifdef _WIN32
 	auto window = Window(1920, 1080, Window::BORDERLESS);
 	auto engine = Engine(
 		window.getHWnd(),
@@ -15,7 +114,27 @@ int main(int argc, char *argv[])
         settings);
 
 	window.setUserPointer(&engine);
-    window.mainLoop();
+
+	if (mode == "--record" && argc > 2)
+	{
+		CameraPath cameraPath;
+		window.mainLoop(&cameraPath);
+		cameraPath.save(argv[2]);
+	}
+	else
+	{
+		window.mainLoop();
+	}
+
+	if (!tracePath.empty())
+	{
+		CpuProfiler::saveTrace(tracePath);
+	}
 
 	return 0;
-}
\ No newline at end of file
+#else
+	// window surface is created only on Windows, other platforms render offscreen
+	std::cout << "Interactive mode isn't supported on this platform, use one of benchmark modes" << std::endl;
+	return 1;
+#endif
+}
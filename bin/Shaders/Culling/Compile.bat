@@ -0,0 +1,2 @@
+glslangValidator -V Culling.comp
+pause
\ No newline at end of file
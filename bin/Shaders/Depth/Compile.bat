@@ -1,3 +1,2 @@
-glslangValidator -V Depth.frag
 glslangValidator -V Depth.vert
 pause
\ No newline at end of file
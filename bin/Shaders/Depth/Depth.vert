@@ -7,18 +7,29 @@ layout(binding = 0) uniform LightSpace{
     mat4 viewProj[CASCADE_COUNT];
 };
 
+struct Dequantization
+{
+    vec4 offset;
+    vec4 scale;
+};
+
+layout(binding = 1) readonly buffer Dequantizations{
+    Dequantization dequantizations[];
+};
+
 layout(push_constant) uniform PushConsts {
 	uint cascadeIndex;
+    // visible instances of each frame, view and mesh take range of instance stride
+    layout(offset = 16) uint firstMesh;
+    uint meshCount;
+    uint instanceStride;
 };
 
-layout(location = 0) in vec3 inPos;
-layout(location = 1) in vec2 inUV;
-layout(location = 2) in vec3 inNormal;
-layout(location = 3) in vec3 inTangent;
-
-layout(location = 4) in mat4 transformation;
+// only position stream is fetched (meshes with alpha test are rendered by DepthAlphaTest),
+// position is normalized in mesh bounds
+layout(location = 0) in vec4 inPos;
 
-layout(location = 0) out vec2 outUV;
+layout(location = 1) in mat4 transformation;
 
 out gl_PerVertex{
     vec4 gl_Position;
@@ -26,7 +37,8 @@ out gl_PerVertex{
 
 void main() 
 {	
-	outUV = inUV;
+    Dequantization dequantization = dequantizations[firstMesh + (gl_InstanceIndex / instanceStride) % meshCount];
+    vec3 pos = dequantization.offset.xyz + inPos.xyz * dequantization.scale.xyz;
 	
-    gl_Position = viewProj[cascadeIndex] * transformation * vec4(inPos, 1.0f);
+    gl_Position = viewProj[cascadeIndex] * transformation * vec4(pos, 1.0f);
 }
\ No newline at end of file
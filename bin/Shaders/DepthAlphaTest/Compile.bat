@@ -0,0 +1,3 @@
+glslangValidator -V DepthAlphaTest.frag
+glslangValidator -V DepthAlphaTest.vert
+pause
\ No newline at end of file
@@ -0,0 +1,48 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (constant_id = 0) const int CASCADE_COUNT = 4;
+
+layout(binding = 0) uniform LightSpace{
+    mat4 viewProj[CASCADE_COUNT];
+};
+
+struct Dequantization
+{
+    vec4 offset;
+    vec4 scale;
+};
+
+layout(binding = 1) readonly buffer Dequantizations{
+    Dequantization dequantizations[];
+};
+
+layout(push_constant) uniform PushConsts {
+	uint cascadeIndex;
+    // visible instances of each frame, view and mesh take range of instance stride
+    layout(offset = 16) uint firstMesh;
+    uint meshCount;
+    uint instanceStride;
+};
+
+// position is normalized in mesh bounds, uv is the only fetched attribute of attribute stream
+layout(location = 0) in vec4 inPos;
+layout(location = 1) in vec2 inUV;
+
+layout(location = 2) in mat4 transformation;
+
+layout(location = 0) out vec2 outUV;
+
+out gl_PerVertex{
+    vec4 gl_Position;
+};
+
+void main() 
+{	
+	outUV = inUV;
+
+    Dequantization dequantization = dequantizations[firstMesh + (gl_InstanceIndex / instanceStride) % meshCount];
+    vec3 pos = dequantization.offset.xyz + inPos.xyz * dequantization.scale.xyz;
+	
+    gl_Position = viewProj[cascadeIndex] * transformation * vec4(pos, 1.0f);
+}
\ No newline at end of file
@@ -6,30 +6,60 @@ layout(binding = 0) uniform Space{
     mat4 proj;
 };
 
-layout(location = 0) in vec3 inPos;
+struct Dequantization
+{
+    vec4 offset;
+    vec4 scale;
+};
+
+layout(binding = 5) readonly buffer Dequantizations{
+    Dequantization dequantizations[];
+};
+
+layout(push_constant) uniform MeshSelection{
+    // visible instances of each frame, view and mesh take range of instance stride
+    layout(offset = 16) uint firstMesh;
+    uint meshCount;
+    uint instanceStride;
+};
+
+// position is normalized in mesh bounds, w is bitangent sign (0 is negative)
+layout(location = 0) in vec4 inPos;
 layout(location = 1) in vec2 inUV;
-layout(location = 2) in vec3 inNormal;
-layout(location = 3) in vec3 inTangent;
+layout(location = 2) in vec2 inNormal;
+layout(location = 3) in vec2 inTangent;
 
 layout(location = 4) in mat4 transformation;
 
 layout(location = 0) out vec3 outPos;
 layout(location = 1) out vec2 outUV;
 layout(location = 2) out vec3 outNormal;
-layout(location = 3) out vec3 outTangent;
+layout(location = 3) out vec4 outTangent;
 layout(location = 4) out vec3 outViewPos;
 
 out gl_PerVertex {
     vec4 gl_Position;
 };
 
+// normal and tangent are octahedral encoded
+vec3 decodeOctahedron(vec2 encoded)
+{
+    vec3 vector = vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-vector.z, 0.0f);
+    vector.xy += mix(vec2(fold), vec2(-fold), greaterThanEqual(vector.xy, vec2(0.0f)));
+    return normalize(vector);
+}
+
 void main() 
 {	
-    outPos = vec3(transformation * vec4(inPos, 1.0f));
+    Dequantization dequantization = dequantizations[firstMesh + (gl_InstanceIndex / instanceStride) % meshCount];
+    vec3 pos = dequantization.offset.xyz + inPos.xyz * dequantization.scale.xyz;
+
+    outPos = vec3(transformation * vec4(pos, 1.0f));
     outUV = inUV;
-    outNormal = vec3(transformation * vec4(inNormal, 0.0f));
-    outTangent = vec3(transformation * vec4(inTangent, 0.0f));
-    outViewPos = vec3(view * transformation * vec4(inPos, 1.0f));
+    outNormal = vec3(transformation * vec4(decodeOctahedron(inNormal), 0.0f));
+    outTangent = vec4(vec3(transformation * vec4(decodeOctahedron(inTangent), 0.0f)), inPos.w * 2.0f - 1.0f);
+    outViewPos = vec3(view * transformation * vec4(pos, 1.0f));
     
-    gl_Position = proj * view * transformation * vec4(inPos, 1.0f);
+    gl_Position = proj * view * transformation * vec4(pos, 1.0f);
 }
\ No newline at end of file
@@ -24,26 +24,27 @@ layout(set = 1, binding = 4) uniform sampler2D normalMap;
 layout(location = 0) in vec3 inPos;
 layout(location = 1) in vec2 inUV;
 layout(location = 2) in vec3 inNormal;
-layout(location = 3) in vec3 inTangent;
+// w is bitangent sign
+layout(location = 3) in vec4 inTangent;
 
 layout (location = 0) out vec4 outPos;
 layout (location = 1) out vec4 outNormal;
 layout (location = 2) out vec4 outAlbedo;
 
-vec3 getBumpedNormal(vec3 normal, vec3 tangent, vec2 uv, sampler2D normalMap)
+vec3 getBumpedNormal(vec3 normal, vec4 signedTangent, vec2 uv, sampler2D normalMap)
 {
 	normal = normalize(normal);
 
 	// texture u vector in world space
-	tangent = normalize(tangent);
+	vec3 tangent = normalize(signedTangent.xyz);
 	tangent = normalize(tangent - dot(tangent, normal) * normal);
 
-	// texture v vector in world space
-	vec3 bitangent = cross(tangent, normal);
+	// texture v vector in world space (mirrored texture coordinates have negative sign)
+	vec3 bitangent = cross(tangent, normal) * (signedTangent.w < 0.0f ? -1.0f : 1.0f);
 
-	// normal from map
-	vec3 bumMapNormal = texture(normalMap, uv).xyz;
-	bumMapNormal = 2.0f * bumMapNormal - vec3(1.0f);
+	// normal from map, z is restored because compressed maps (BC5) contain only x and y
+	vec2 bumMapXy = 2.0f * texture(normalMap, uv).xy - vec2(1.0f);
+	vec3 bumMapNormal = vec3(bumMapXy, sqrt(max(1.0f - dot(bumMapXy, bumMapXy), 0.0f)));
 
 	// normal from map in world space
 	vec3 resultNormal;
@@ -21,6 +21,7 @@ void main()
     outUV = inPos;
     outUV.y = -outUV.y;
 
-	vec4 mvpPos = proj * view * transformation * vec4(inPos, 1.0);
+	// translation of view matrix is dropped so skybox always surrounds camera
+	vec4 mvpPos = proj * mat4(mat3(view)) * transformation * vec4(inPos, 1.0);
     gl_Position = mvpPos.xyww;
 }
\ No newline at end of file